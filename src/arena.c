@@ -0,0 +1,108 @@
+/**
+ * @note Project: Implementace překladače imperativního jazyka IFJ23
+ * @file arena.c
+ * @author agent, agent, VUT FIT
+ * @date 16/10/2026
+ * @brief Implementation for the arena.h
+ */
+
+#include "arena.h"
+#include <stdalign.h>
+#include <stdlib.h>
+#include <string.h>
+#include "error.h"
+
+/// Default size of a single block, bigger allocations get a block of their own
+const size_t c_arena_block = 1 << 16;
+
+struct ArenaBlock {
+    ArenaBlock* prev;
+    size_t used;
+    size_t size;
+    alignas(max_align_t) char data[];
+};
+
+void arena_init(Arena* arena) {
+    arena->block = NULL;
+}
+
+/// Allocate `size` bytes aligned to `align`, which has to be a power of 2
+static void* arena_alloc_aligned(Arena* arena, size_t size, size_t align) {
+    ArenaBlock* block = arena->block;
+    size_t start = block ? (block->used + align - 1) & ~(align - 1) : 0;
+
+    if (!block || start > block->size || block->size - start < size) {
+        size_t block_size = size > c_arena_block ? size : c_arena_block;
+        ArenaBlock* new_block = malloc(sizeof(ArenaBlock) + block_size);
+
+        if (!new_block) {
+            set_error(Error_Internal);
+            eprint("arena: Out Of Memory\n");
+            return NULL;
+        }
+
+        new_block->size = block_size;
+        new_block->used = 0;
+
+        /// Keep filling the current block if the new one is used up by this allocation only
+        if (block && size >= c_arena_block) {
+            new_block->prev = block->prev;
+            block->prev = new_block;
+        } else {
+            new_block->prev = block;
+            arena->block = new_block;
+        }
+
+        block = new_block;
+        start = 0;
+    }
+
+    block->used = start + size;
+    return block->data + start;
+}
+
+void* arena_alloc(Arena* arena, size_t size) {
+    return arena_alloc_aligned(arena, size, alignof(max_align_t));
+}
+
+char* arena_strndup(Arena* arena, const char* str, size_t length) {
+    char* copy = arena_alloc_aligned(arena, length + 1, 1);
+
+    if (!copy) {
+        return NULL;
+    }
+
+    memcpy(copy, str, length);
+    copy[length] = '\0';
+    return copy;
+}
+
+void arena_adopt(Arena* dst, Arena* src) {
+    if (!src->block) {
+        return;
+    }
+
+    /// The blocks of `src` go behind the current block of `dst`, which is still filled first
+    ArenaBlock* last = src->block;
+
+    while (last->prev) {
+        last = last->prev;
+    }
+
+    if (dst->block) {
+        last->prev = dst->block->prev;
+        dst->block->prev = src->block;
+    } else {
+        dst->block = src->block;
+    }
+
+    src->block = NULL;
+}
+
+void arena_free(Arena* arena) {
+    while (arena->block) {
+        ArenaBlock* prev = arena->block->prev;
+        free(arena->block);
+        arena->block = prev;
+    }
+}
@@ -0,0 +1,68 @@
+/**
+ * @note Project: Implementace překladače imperativního jazyka IFJ23
+ * @file arena.h
+ * @author agent, agent, VUT FIT
+ * @date 16/10/2026
+ * @brief Block arena allocator.
+ *
+ * Memory is handed out from big blocks that are never moved, so the returned pointers stay valid
+ * until the whole arena is released at once by `arena_free`.
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+typedef struct ArenaBlock ArenaBlock;
+
+/**
+ * @struct Arena
+ * @brief Linked list of memory blocks, the newest block first.
+ */
+typedef struct {
+    ArenaBlock* block;
+} Arena;
+
+/**
+ * @brief Initialize an empty arena, no memory is allocated yet.
+ * @param[out] arena Arena to initialize.
+ */
+void arena_init(Arena* arena);
+
+/**
+ * @brief Allocate memory from the arena.
+ *
+ * The memory is aligned for any type and is not initialized.
+ * Sets `Error_Internal` if out of memory.
+ *
+ * @param[in,out] arena Arena to allocate from.
+ * @param[in] size Number of bytes to allocate.
+ * @return Pointer to the memory or `NULL` if out of memory.
+ */
+void* arena_alloc(Arena* arena, size_t size);
+
+/**
+ * @brief Copy `length` bytes of `str` into the arena and null terminate them.
+ *
+ * @param[in,out] arena Arena to allocate from.
+ * @param[in] str Bytes to copy, does not have to be null terminated.
+ * @param[in] length Number of bytes to copy.
+ * @return Null terminated copy or `NULL` if out of memory.
+ */
+char* arena_strndup(Arena* arena, const char* str, size_t length);
+
+/**
+ * @brief Move all memory of `src` into `dst`, the pointers returned by `src` stay valid until `dst` is released.
+ * @param[in,out] dst Arena that takes over the memory.
+ * @param[in,out] src Arena to take the memory from, it is empty afterwards.
+ */
+void arena_adopt(Arena* dst, Arena* src);
+
+/**
+ * @brief Release all memory of the arena. All pointers returned by the arena are invalidated.
+ * @param[in,out] arena Arena to release, it is empty afterwards.
+ */
+void arena_free(Arena* arena);
+
+#endif
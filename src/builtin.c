@@ -25,13 +25,14 @@ void builtin_add_function(DataType return_data_type,
     function_symbol_init(&func);
     func.return_value_type = return_data_type;
     for (size_t i = 0; i < params_size; i++) {
-        function_symbol_emplace_param(&func, params[i].dt, params[i].oname, params[i].iname);
+        function_symbol_emplace_param(&func, params[i].dt, strview_from_c_str(params[i].oname),
+                                      strview_from_c_str(params[i].iname));
     }
     parser_function_code_info(&func, function_name);
     code_buf_set(&func.code);
 
     Operand op;
-    op.label = func.code_name.data;
+    op.label = string_view(&func.code_name);
     code_generation(Instruction_Label, &op, NULL, NULL);
     code_generation(Instruction_PushFrame, NULL, NULL, NULL);
     code_generation_raw("DEFVAR LF@ret");
@@ -7,60 +7,184 @@
  */
 
 #include "codegen.h"
+#include <inttypes.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <string.h>
+#include <unistd.h>
+#include "arena.h"
 
 CodeBuf* g_code_buf = NULL;
 
-const int c_buf_chunk = 10;
+/// Capacity of the smallest storage of a CodeBuf, every bigger one has double the capacity of the previous one
+const size_t c_buf_min_capacity = 16;
+
+/// Number of storage capacities of the pool, the biggest one is `c_buf_min_capacity << (CODE_POOL_CLASSES - 1)`
+#define CODE_POOL_CLASSES 32
+
+/// Released storage in the free list of the pool
+typedef struct CodePoolBlock {
+    struct CodePoolBlock* next;
+} CodePoolBlock;
+
+/// Storage of all CodeBufs of the compilation, released storage is reused by the CodeBufs of the same capacity
+typedef struct {
+    Arena arena;
+    CodePoolBlock* free[CODE_POOL_CLASSES];  ///< Released storage by the index of its capacity
+} CodePool;
+
+static CodePool g_code_pool;
+
+/// Text of every instruction indexed by `Instruction`
+static const char* const c_instruction_names[] = {
+    [Instruction_Start] = ".IFJcode23",    [Instruction_Move] = "MOVE",
+    [Instruction_CreateFrame] = "CREATEFRAME", [Instruction_PushFrame] = "PUSHFRAME",
+    [Instruction_PopFrame] = "POPFRAME",   [Instruction_DefVar] = "DEFVAR",
+    [Instruction_Call] = "CALL",           [Instruction_Return] = "RETURN",
+    [Instruction_Pushs] = "PUSHS",         [Instruction_Pops] = "POPS",
+    [Instruction_Clears] = "CLEARS",       [Instruction_Add] = "ADD",
+    [Instruction_Sub] = "SUB",             [Instruction_Mul] = "MUL",
+    [Instruction_Div] = "DIV",             [Instruction_Idiv] = "IDIV",
+    [Instruction_Adds] = "ADDS",           [Instruction_Subs] = "SUBS",
+    [Instruction_Muls] = "MULS",           [Instruction_Divs] = "DIVS",
+    [Instruction_Idivs] = "IDIVS",         [Instruction_Lt] = "LT",
+    [Instruction_Gt] = "GT",               [Instruction_Eq] = "EQ",
+    [Instruction_Lts] = "LTS",             [Instruction_Gts] = "GTS",
+    [Instruction_Eqs] = "EQS",             [Instruction_And] = "AND",
+    [Instruction_Or] = "OR",               [Instruction_Not] = "NOT",
+    [Instruction_Ands] = "ANDS",           [Instruction_Ors] = "ORS",
+    [Instruction_Nots] = "NOTS",           [Instruction_Int2Float] = "INT2FLOAT",
+    [Instruction_Float2Int] = "FLOAT2INT", [Instruction_Int2Char] = "INT2CHAR",
+    [Instruction_Stri2Int] = "STRI2INT",   [Instruction_Int2Floats] = "INT2FLOATS",
+    [Instruction_Float2Ints] = "FLOAT2INTS", [Instruction_Int2Chars] = "INT2CHARS",
+    [Instruction_Stri2Ints] = "STRI2INTS", [Instruction_Read] = "READ",
+    [Instruction_Write] = "WRITE",         [Instruction_Concat] = "CONCAT",
+    [Instruction_Strlen] = "STRLEN",       [Instruction_GetChar] = "GETCHAR",
+    [Instruction_SetChar] = "SETCHAR",     [Instruction_Type] = "TYPE",
+    [Instruction_Label] = "LABEL",         [Instruction_Jump] = "JUMP",
+    [Instruction_JumpIfEq] = "JUMPIFEQ",   [Instruction_JumpIfNeq] = "JUMPIFNEQ",
+    [Instruction_JumpIfEqs] = "JUMPIFEQS", [Instruction_JumpIfNeqs] = "JUMPIFNEQS",
+    [Instruction_Exit] = "EXIT",           [Instruction_Break] = "BREAK",
+    [Instruction_DebugPrint] = "DPRINT",
+};
+
+/// Number of instructions in `c_instruction_names`
+#define INSTRUCTION_COUNT (sizeof(c_instruction_names) / sizeof(*c_instruction_names))
+
+/// Text of every frame indexed by `Frame`
+static const char* const c_frame_prefixes[] = {"GF@", "LF@", "TF@"};
+
+/// Text of the instruction being parsed by `code_generation_raw`, the memory is reused by every call
+static String g_raw_text;
+
+/// Index of the free list of the capacity, the capacity is `c_buf_min_capacity` times a power of 2
+static size_t code_pool_class(size_t capacity) {
+    size_t index = 0;
+
+    while ((c_buf_min_capacity << index) < capacity) {
+        index++;
+    }
 
-void code_buf_init(CodeBuf* buf) {
-    if (!buf)
-        return;
+    return index;
+}
 
-    buf->size = 0;
-    buf->capacity = c_buf_chunk;
-    buf->buf = malloc(sizeof(GeneratedInstruction) * c_buf_chunk);
+static GeneratedInstruction* code_pool_alloc(size_t capacity) {
+    size_t index = code_pool_class(capacity);
 
-    if (!buf->buf) {
+    if (index >= CODE_POOL_CLASSES) {
         set_error(Error_Internal);
         eprint("Out Of Memory");
-        return;
+        return NULL;
     }
+
+    CodePoolBlock* block = g_code_pool.free[index];
+
+    if (block) {
+        g_code_pool.free[index] = block->next;
+        return (GeneratedInstruction*)block;
+    }
+
+    return arena_alloc(&g_code_pool.arena, sizeof(GeneratedInstruction) * capacity);
+}
+
+static void code_pool_release(GeneratedInstruction* data, size_t capacity) {
+    if (!data)
+        return;
+
+    size_t index = code_pool_class(capacity);
+    CodePoolBlock* block = (CodePoolBlock*)data;
+    block->next = g_code_pool.free[index];
+    g_code_pool.free[index] = block;
+}
+
+void code_buf_init(CodeBuf* buf) {
+    if (!buf)
+        return;
+
+    // The storage is taken from the pool by the first instruction
+    buf->size = 0;
+    buf->capacity = 0;
+    buf->buf = NULL;
 }
 
 void code_buf_set(CodeBuf* buf) {
     g_code_buf = buf;
 }
 
-void code_buf_print(CodeBuf* buf) {
-    for (size_t i = 0; i < buf->size; i++) {
-        printf("%s\n", buf->buf[i].code.data);
+void code_instruction_render(String* str, const GeneratedInstruction* inst) {
+    string_concat_c_str(str, c_instruction_names[inst->inst]);
+
+    for (int i = 0; i < inst->operand_count && !got_error(); i++) {
+        const CodeOperand* op = inst->operands + i;
+        String text = intern_view(op->text);
+
+        string_push(str, ' ');
+        if (op->kind == CodeOperand_Variable) {
+            string_append_n(str, c_frame_prefixes[op->frame], 3);
+        }
+        string_append_n(str, string_data(&text), text.length);
     }
 }
 
-String code_buf_print_to_string(CodeBuf* buf) {
-    String res;
-    string_init(&res);
+void code_buf_write(Writer* writer, CodeBuf* buf) {
+    for (size_t i = 0; i < buf->size && !got_error(); i++) {
+        const GeneratedInstruction* inst = buf->buf + i;
+        const char* name = c_instruction_names[inst->inst];
+        writer_write(writer, name, strlen(name));
 
-    if (!buf->size) {
-        return res;
-    }
+        for (int j = 0; j < inst->operand_count; j++) {
+            const CodeOperand* op = inst->operands + j;
+            String text = intern_view(op->text);
 
-    // 6 is the average length of an instruction
-    string_reserve(&res, buf->size * 6);
+            writer_putc(writer, ' ');
+            if (op->kind == CodeOperand_Variable) {
+                writer_write(writer, c_frame_prefixes[op->frame], 3);
+            }
+            writer_write(writer, string_data(&text), text.length);
+        }
 
-    if (got_error()) {
-        return res;
+        writer_putc(writer, '\n');
     }
+}
+
+void code_buf_print(CodeBuf* buf) {
+    Writer writer;
+    writer_init(&writer, STDOUT_FILENO);
+
+    fflush(stdout);
+    code_buf_write(&writer, buf);
+    writer_flush(&writer);
+    writer_free(&writer);
+}
 
-    size_t i = 0;
+String code_buf_print_to_string(CodeBuf* buf) {
+    String res;
+    string_init(&res);
 
-    do {
-        string_concat_c_str(&res, buf->buf[i].code.data);
+    for (size_t i = 0; i < buf->size && !got_error(); i++) {
+        code_instruction_render(&res, buf->buf + i);
         string_push(&res, '\n');
-    } while (++i < buf->size || got_error());
+    }
 
     return res;
 }
@@ -69,58 +193,159 @@ void code_buf_free(CodeBuf* buf) {
     if (!buf)
         return;
 
-    for (size_t i = 0; i < buf->size; i++) {
-        string_free(&buf->buf[i].code);
-    }
-
-    free(buf->buf);
+    // The operand texts are owned by the interner
+    code_pool_release(buf->buf, buf->capacity);
 
     buf->buf = NULL;
     buf->capacity = 0;
     buf->size = 0;
 }
 
-void code_buf_push(CodeBuf* buf, String instruction_str) {
+static void code_buf_push(CodeBuf* buf, GeneratedInstruction inst) {
     if (buf->size >= buf->capacity) {
-        size_t new_capacity = buf->capacity + c_buf_chunk;
-        GeneratedInstruction* tmp = realloc(buf->buf, sizeof(GeneratedInstruction) * new_capacity);
+        size_t new_capacity = buf->capacity ? buf->capacity * 2 : c_buf_min_capacity;
+        GeneratedInstruction* tmp = code_pool_alloc(new_capacity);
 
         if (!tmp) {
-            set_error(Error_Internal);
-            eprint("Out Of Memory");
             return;
         }
 
+        if (buf->size) {
+            memcpy(tmp, buf->buf, sizeof(GeneratedInstruction) * buf->size);
+        }
+
+        code_pool_release(buf->buf, buf->capacity);
         buf->buf = tmp;
         buf->capacity = new_capacity;
     }
 
-    GeneratedInstruction generated_inst;
-    generated_inst.code = instruction_str;
-    g_code_buf->buf[g_code_buf->size++] = generated_inst;
+    buf->buf[buf->size++] = inst;
+}
+
+static CodeOperand code_operand(CodeOperandKind kind, Frame frame, const char* text, size_t length) {
+    return (CodeOperand){.kind = kind, .frame = frame, .text = intern_add(text, length)};
+}
+
+/// Instructions with a label as the first operand
+static bool instruction_has_label(Instruction inst) {
+    switch (inst) {
+        case Instruction_Call:
+        case Instruction_Label:
+        case Instruction_Jump:
+        case Instruction_JumpIfEq:
+        case Instruction_JumpIfNeq:
+        case Instruction_JumpIfEqs:
+        case Instruction_JumpIfNeqs:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/// Parse one operand of the instruction text, the kind is given by the position or by the prefix of the text
+static CodeOperand code_operand_parse(Instruction inst, int index, const char* text, size_t length) {
+    if (index == 0 && instruction_has_label(inst)) {
+        return code_operand(CodeOperand_Label, Frame_Global, text, length);
+    }
+
+    if (index == 1 && inst == Instruction_Read) {
+        return code_operand(CodeOperand_Type, Frame_Global, text, length);
+    }
+
+    if (length > 3 && text[1] == 'F' && text[2] == '@') {
+        for (Frame frame = Frame_Global; frame <= Frame_Temporary; frame++) {
+            if (text[0] == c_frame_prefixes[frame][0]) {
+                return code_operand(CodeOperand_Variable, frame, text + 3, length - 3);
+            }
+        }
+    }
+
+    return code_operand(CodeOperand_Constant, Frame_Global, text, length);
+}
+
+/// Parse the instruction text of `code_generation_raw`, the operands are separated by single spaces
+static bool code_instruction_parse(const char* text, size_t length, GeneratedInstruction* out) {
+    const char* end = text + length;
+    const char* word_end = memchr(text, ' ', length);
+    word_end = word_end ? word_end : end;
+    size_t word_length = word_end - text;
+
+    size_t inst = 0;
+    while (inst < INSTRUCTION_COUNT &&
+           (strlen(c_instruction_names[inst]) != word_length || memcmp(c_instruction_names[inst], text, word_length))) {
+        inst++;
+    }
+
+    if (inst == INSTRUCTION_COUNT) {
+        return false;
+    }
+
+    out->inst = inst;
+    out->operand_count = 0;
+
+    while (word_end < end) {
+        text = word_end + 1;
+        word_end = memchr(text, ' ', end - text);
+        word_end = word_end ? word_end : end;
+
+        if (out->operand_count == 3 || word_end == text) {
+            return false;
+        }
+
+        out->operands[out->operand_count] = code_operand_parse(inst, out->operand_count, text, word_end - text);
+        out->operand_count++;
+    }
+
+    return true;
 }
 
 void code_generation_raw(const char* fmt, ...) {
     if (!fmt)
         return;
 
+    if (!g_code_buf) {
+        set_error(Error_Internal);
+        eprint("code_generation_raw: CodeBuf is not initialized");
+        return;
+    }
+
+    string_clear(&g_raw_text);
+
     va_list args;
     va_start(args, fmt);
-    size_t buf_size = vsnprintf(NULL, 0, fmt, args);
-    char* buf = calloc(buf_size + 1, sizeof(char));
-    va_end(args);
-    va_start(args, fmt);
-    vsprintf(buf, fmt, args);
-    String str = string_from_c_str(buf);
-    free(buf);
+    string_append_vfmt(&g_raw_text, fmt, args);
     va_end(args);
 
-    code_buf_push(g_code_buf, str);
+    if (got_error()) {
+        return;
+    }
+
+    GeneratedInstruction inst;
+    if (!code_instruction_parse(string_data(&g_raw_text), g_raw_text.length, &inst)) {
+        set_error(Error_Internal);
+        eprint("code_generation_raw: Invalid instruction\n");
+        return;
+    }
+
+    if (got_error()) {
+        return;
+    }
+
+    code_buf_push(g_code_buf, inst);
+}
+
+void code_generation_free() {
+    string_free(&g_raw_text);
+    arena_free(&g_code_pool.arena);
+    memset(g_code_pool.free, 0, sizeof(g_code_pool.free));
 }
 
-void string_push_encoded(String* str, const char* s) {
-    for (int i = 0; s[i]; i++) {
-        char ch = s[i];
+/// Encode `length` bytes of `s`, the bytes do not have to be null terminated (e.g. a string literal borrowed
+/// from the source)
+void string_push_encoded(String* str, const char* s, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        /// Bytes outside of ASCII are parts of UTF-8 sequences and are written as they are
+        unsigned char ch = s[i];
         if (ch == 35 || ch == 92 || ch <= 32) {
             char conv[6] = "\\";
             snprintf(conv + 1, 5, "%03d", ch);
@@ -143,30 +368,13 @@ void string_push_literal(String* str, Data data) {
     }
 
     switch (data.type) {
-        case DataType_Int: {
-            // int@ is 4 char, maximum value of an interger is 19 + 1 for the sign,
-            // also 1 for the \0
-            char ch[25] = "int@";
-            snprintf(ch + 4, 21, "%d", data.value.number);
-            string_concat_c_str(str, ch);
+        case DataType_Int:
+            string_append_fmt(str, "int@%" PRId64, data.value.number);
             break;
-        }
-
-        case DataType_Double: {
-            int len = snprintf(NULL, 0, "%a", data.value.number_double);
-
-            string_reserve(str, str->length + strlen("float@") + len + 1);
-
-            if (got_error()) {
-                return;
-            }
-
-            string_concat_c_str(str, "float@");
-            snprintf(str->data + str->length, len + 1, "%a", data.value.number_double);
-            str->length += len;
 
+        case DataType_Double:
+            string_append_fmt(str, "float@%a", data.value.number_double);
             break;
-        }
 
         case DataType_String: {
             string_reserve(str, str->length + data.value.string.length + strlen("string@") + 1);
@@ -176,7 +384,7 @@ void string_push_literal(String* str, Data data) {
             }
 
             string_concat_c_str(str, "string@");
-            string_push_encoded(str, data.value.string.data);
+            string_push_encoded(str, string_data(&data.value.string), data.value.string.length);
 
             break;
         }
@@ -193,305 +401,300 @@ void string_push_literal(String* str, Data data) {
     }
 }
 
-void code_generation(Instruction inst, Operand* op1, Operand* op2, Operand* op3) {
+/// Intern the text of the constant operand, the rendered literal is the text
+static CodeOperand code_operand_constant(Data constant) {
+    String text;
+    string_init(&text);
+    string_push_literal(&text, constant);
+
+    CodeOperand op = code_operand(CodeOperand_Constant, Frame_Global, string_data(&text), text.length);
+    string_free(&text);
+    return op;
+}
+
+/// Intern the encoded text of the label operand
+static CodeOperand code_operand_label(StrView label) {
+    String text;
+    string_init(&text);
+    string_push_encoded(&text, label.data, label.length);
+
+    CodeOperand op = code_operand(CodeOperand_Label, Frame_Global, string_data(&text), text.length);
+    string_free(&text);
+    return op;
+}
+
+void code_generation(Instruction inst, const Operand* op1, const Operand* op2, const Operand* op3) {
     if (!g_code_buf) {
         set_error(Error_Internal);
         eprint("code_generation: CodeBuf is not initialized");
         return;
     }
 
-    String instruction_str;
-    string_init(&instruction_str);
-
     if (got_error()) {
         return;
     }
 
-#define push_str(s)                           \
-    string_concat_c_str(&instruction_str, s); \
-    if (got_error()) {                        \
-        string_free(&instruction_str);        \
-        return;                               \
-    }
+    GeneratedInstruction generated = {.inst = inst, .operand_count = 0};
+
+#define push_operand(op)                                \
+    generated.operands[generated.operand_count++] = op; \
+    if (got_error())                                    \
+    return
 
-#define push_var(var)         \
-    switch (var.frame) {      \
-        case Frame_Global:    \
-            push_str(" GF@"); \
-            break;            \
-        case Frame_Local:     \
-            push_str(" LF@"); \
-            break;            \
-        case Frame_Temporary: \
-            push_str(" TF@"); \
-            break;            \
-    }                         \
-    push_str(var.name)
-
-#define push_symb(symb)                                           \
-    switch (symb.type) {                                          \
-        case SymbolType_Variable:                                 \
-            push_var(symb.variable);                              \
-            break;                                                \
-        case SymbolType_Constant:                                 \
-            push_str(" ");                                        \
-            string_push_literal(&instruction_str, symb.constant); \
-            break;                                                \
+#define push_var(var) push_operand(code_operand(CodeOperand_Variable, var.frame, var.name.data, var.name.length))
+
+#define push_symb(symb)                                         \
+    switch (symb.type) {                                        \
+        case SymbolType_Variable:                               \
+            push_var(symb.variable);                            \
+            break;                                              \
+        case SymbolType_Constant:                               \
+            push_operand(code_operand_constant(symb.constant)); \
+            break;                                              \
     }
 
 #define push_label(label)                                   \
-    if (!strlen(label)) {                                   \
+    if (!label.length) {                                    \
         set_error(Error_Internal);                          \
         eprint("code_generation: label cannot be empty\n"); \
-        string_free(&instruction_str);                      \
         return;                                             \
     }                                                       \
-    push_str(" ");                                          \
-    string_push_encoded(&instruction_str, label);           \
-    if (got_error())                                        \
-    return
+    push_operand(code_operand_label(label))
 
-#define push_to_buf()                           \
-    code_buf_push(g_code_buf, instruction_str); \
-    if (got_error())                            \
+#define push_type(type) push_operand(code_operand(CodeOperand_Type, Frame_Global, type, strlen(type)))
+
+#define push_to_buf()                     \
+    code_buf_push(g_code_buf, generated); \
+    if (got_error())                      \
     return
 
-#define push_instruction(inst) \
-    push_str(inst);            \
-    push_to_buf()
+#define push_instruction() push_to_buf()
 
-#define push_instruction_var(inst) \
-    push_str(inst);                \
-    push_var(op1->variable);       \
+#define push_instruction_var() \
+    push_var(op1->variable);   \
     push_to_buf()
 
-#define push_instruction_var_symb(inst) \
-    push_str(inst);                     \
-    push_var(op1->variable);            \
-    push_symb(op2->symbol);             \
+#define push_instruction_var_symb() \
+    push_var(op1->variable);        \
+    push_symb(op2->symbol);         \
     push_to_buf()
 
-#define push_instruction_label(inst) \
-    push_str(inst);                  \
-    push_label(op1->label);          \
+#define push_instruction_label() \
+    push_label(op1->label);      \
     push_to_buf()
 
-#define push_instruction_symb(inst) \
-    push_str(inst);                 \
-    push_symb(op1->symbol);         \
+#define push_instruction_symb() \
+    push_symb(op1->symbol);     \
     push_to_buf()
 
-#define push_instruction_var_symb_symb(inst) \
-    push_str(inst);                          \
-    push_var(op1->variable);                 \
-    push_symb(op2->symbol);                  \
-    push_symb(op3->symbol);                  \
+#define push_instruction_var_symb_symb() \
+    push_var(op1->variable);             \
+    push_symb(op2->symbol);              \
+    push_symb(op3->symbol);              \
     push_to_buf()
 
-#define push_instruction_var_type(inst) \
-    push_str(inst);                     \
-    push_var(op1->variable);            \
-    switch (op2->data_type) {           \
-        case DataType_MaybeInt:         \
-        case DataType_Int:              \
-            push_str(" int");           \
-            break;                      \
-        case DataType_MaybeDouble:      \
-        case DataType_Double:           \
-            push_str(" float");         \
-            break;                      \
-        case DataType_MaybeString:      \
-        case DataType_String:           \
-            push_str(" string");        \
-            break;                      \
-        case DataType_MaybeBool:        \
-        case DataType_Bool:             \
-            push_str(" bool");          \
-            break;                      \
-        case DataType_Undefined:        \
-            push_str(" nil");           \
-            break;                      \
-    }                                   \
+#define push_instruction_var_type() \
+    push_var(op1->variable);        \
+    switch (op2->data_type) {       \
+        case DataType_MaybeInt:     \
+        case DataType_Int:          \
+            push_type("int");       \
+            break;                  \
+        case DataType_MaybeDouble:  \
+        case DataType_Double:       \
+            push_type("float");     \
+            break;                  \
+        case DataType_MaybeString:  \
+        case DataType_String:       \
+            push_type("string");    \
+            break;                  \
+        case DataType_MaybeBool:    \
+        case DataType_Bool:         \
+            push_type("bool");      \
+            break;                  \
+        case DataType_Undefined:    \
+            push_type("nil");       \
+            break;                  \
+    }                               \
     push_to_buf()
 
-#define push_instruction_label_symb_symb(inst) \
-    push_str(inst);                            \
-    push_label(op1->label);                    \
-    push_symb(op2->symbol);                    \
-    push_symb(op3->symbol);                    \
+#define push_instruction_label_symb_symb() \
+    push_label(op1->label);                \
+    push_symb(op2->symbol);                \
+    push_symb(op3->symbol);                \
     push_to_buf()
 
     switch (inst) {
         case Instruction_Start:
-            push_instruction(".IFJcode23");
+            push_instruction();
             break;
         case Instruction_Move:
-            push_instruction_var_symb("MOVE");
+            push_instruction_var_symb();
             break;
         case Instruction_CreateFrame:
-            push_instruction("CREATEFRAME");
+            push_instruction();
             break;
         case Instruction_PushFrame:
-            push_instruction("PUSHFRAME");
+            push_instruction();
             break;
         case Instruction_PopFrame:
-            push_instruction("POPFRAME");
+            push_instruction();
             break;
         case Instruction_DefVar:
-            push_instruction_var("DEFVAR");
+            push_instruction_var();
             break;
         case Instruction_Call:
-            push_instruction_label("CALL");
+            push_instruction_label();
             break;
         case Instruction_Return:
-            push_instruction("RETURN");
+            push_instruction();
             break;
         case Instruction_Pushs:
-            push_instruction_symb("PUSHS");
+            push_instruction_symb();
             break;
         case Instruction_Pops:
-            push_instruction_var("POPS");
+            push_instruction_var();
             break;
         case Instruction_Clears:
-            push_instruction("CLEARS");
+            push_instruction();
             break;
         case Instruction_Add:
-            push_instruction_var_symb_symb("ADD");
+            push_instruction_var_symb_symb();
             break;
         case Instruction_Sub:
-            push_instruction_var_symb_symb("SUB");
+            push_instruction_var_symb_symb();
             break;
         case Instruction_Mul:
-            push_instruction_var_symb_symb("MUL");
+            push_instruction_var_symb_symb();
             break;
         case Instruction_Div:
-            push_instruction_var_symb_symb("DIV");
+            push_instruction_var_symb_symb();
             break;
         case Instruction_Idiv:
-            push_instruction_var_symb_symb("IDIV");
+            push_instruction_var_symb_symb();
             break;
         case Instruction_Adds:
-            push_instruction("ADDS");
+            push_instruction();
             break;
         case Instruction_Subs:
-            push_instruction("SUBS");
+            push_instruction();
             break;
         case Instruction_Muls:
-            push_instruction("MULS");
+            push_instruction();
             break;
         case Instruction_Divs:
-            push_instruction("DIVS");
+            push_instruction();
             break;
         case Instruction_Idivs:
-            push_instruction("IDIVS");
+            push_instruction();
             break;
         case Instruction_Lt:
-            push_instruction_var_symb_symb("LT");
+            push_instruction_var_symb_symb();
             break;
         case Instruction_Gt:
-            push_instruction_var_symb_symb("GT");
+            push_instruction_var_symb_symb();
             break;
         case Instruction_Eq:
-            push_instruction_var_symb_symb("EQ");
+            push_instruction_var_symb_symb();
             break;
         case Instruction_Lts:
-            push_instruction("LTS");
+            push_instruction();
             break;
         case Instruction_Gts:
-            push_instruction("GTS");
+            push_instruction();
             break;
         case Instruction_Eqs:
-            push_instruction("EQS");
+            push_instruction();
             break;
         case Instruction_And:
-            push_instruction_var_symb_symb("AND");
+            push_instruction_var_symb_symb();
             break;
         case Instruction_Or:
-            push_instruction_var_symb_symb("OR");
+            push_instruction_var_symb_symb();
             break;
         case Instruction_Not:
-            push_instruction_var_symb_symb("NOT");
+            push_instruction_var_symb();
             break;
         case Instruction_Ands:
-            push_instruction("ANDS");
+            push_instruction();
             break;
         case Instruction_Ors:
-            push_instruction("ORS");
+            push_instruction();
             break;
         case Instruction_Nots:
-            push_instruction("NOTS");
+            push_instruction();
             break;
         case Instruction_Int2Float:
-            push_instruction_var_symb("INT2FLOAT");
+            push_instruction_var_symb();
             break;
         case Instruction_Float2Int:
-            push_instruction_var_symb("FLOAT2INT");
+            push_instruction_var_symb();
             break;
         case Instruction_Int2Char:
-            push_instruction_var_symb("INT2CHAR");
+            push_instruction_var_symb();
             break;
         case Instruction_Stri2Int:
-            push_instruction_var_symb("STRI2INT");
+            push_instruction_var_symb();
             break;
         case Instruction_Int2Floats:
-            push_instruction("INT2FLOATS");
+            push_instruction();
             break;
         case Instruction_Float2Ints:
-            push_instruction("FLOAT2INTS");
+            push_instruction();
             break;
         case Instruction_Int2Chars:
-            push_instruction("INT2CHARS");
+            push_instruction();
             break;
         case Instruction_Stri2Ints:
-            push_instruction("STRI2INTS");
+            push_instruction();
             break;
         case Instruction_Read:
-            push_instruction_var_type("READ");
+            push_instruction_var_type();
             break;
         case Instruction_Write:
-            push_instruction_symb("WRITE");
+            push_instruction_symb();
             break;
         case Instruction_Concat:
-            push_instruction_var_symb_symb("CONCAT");
+            push_instruction_var_symb_symb();
             break;
         case Instruction_Strlen:
-            push_instruction_var_symb("STRLEN");
+            push_instruction_var_symb();
             break;
         case Instruction_GetChar:
-            push_instruction_var_symb_symb("GETCHAR");
+            push_instruction_var_symb_symb();
             break;
         case Instruction_SetChar:
-            push_instruction_var_symb_symb("SETCHAR");
+            push_instruction_var_symb_symb();
             break;
         case Instruction_Type:
-            push_instruction_var_symb("TYPE");
+            push_instruction_var_symb();
             break;
         case Instruction_Label:
-            push_instruction_label("LABEL");
+            push_instruction_label();
             break;
         case Instruction_Jump:
-            push_instruction_label("JUMP");
+            push_instruction_label();
             break;
         case Instruction_JumpIfEq:
-            push_instruction_label_symb_symb("JUMPIFEQ");
+            push_instruction_label_symb_symb();
             break;
         case Instruction_JumpIfNeq:
-            push_instruction_label_symb_symb("JUMPIFNEQ");
+            push_instruction_label_symb_symb();
             break;
         case Instruction_JumpIfEqs:
-            push_instruction_label("JUMPIFEQS");
+            push_instruction_label();
             break;
         case Instruction_JumpIfNeqs:
-            push_instruction_label("JUMPIFNEQS");
+            push_instruction_label();
             break;
         case Instruction_Exit:
-            push_instruction_symb("EXIT");
+            push_instruction_symb();
             break;
         case Instruction_Break:
-            push_instruction("BREAK");
+            push_instruction();
             break;
         case Instruction_DebugPrint:
-            push_instruction_symb("DPRINT");
+            push_instruction_symb();
             break;
     }
 }
@@ -9,7 +9,9 @@
 #ifndef H_CODEGEN
 #define H_CODEGEN
 
+#include "intern.h"
 #include "scanner.h"
+#include "writer.h"
 
 typedef enum {
     /// The first and must-have instruction
@@ -99,6 +101,7 @@ typedef enum {
     /// Params: var, symb1, symb2
     Instruction_And,
     Instruction_Or,
+    /// Params: var, symb
     Instruction_Not,
 
     /// Stack versions
@@ -194,8 +197,8 @@ typedef enum {
  * @brief Structure representing a variable with its frame and name.
  */
 typedef struct {
-    Frame frame;  ///< Frame of the variable
-    char* name;   ///< Name of the variable
+    Frame frame;   ///< Frame of the variable
+    StrView name;  ///< Name of the variable, borrowed from its owner
 } Variable;
 
 /**
@@ -225,13 +228,74 @@ typedef union {
     Variable variable;   ///< Represents a variable
     Symbol symbol;       ///< Represents a symbol
     DataType data_type;  ///< Represents a data type
-    char* label;         ///< Represents a label
+    StrView label;       ///< Represents a label
 } Operand;
+
+/**
+ * @brief Create a variable operand, ⟨var⟩ of an instruction.
+ * @param frame Frame of the variable.
+ * @param name Name of the variable, borrowed until the instruction is generated.
+ * @return The operand.
+ */
+inline static Operand operand_var(Frame frame, StrView name) {
+    return (Operand){.variable = {.frame = frame, .name = name}};
+}
+
+/**
+ * @brief Create a symbol operand of a variable, ⟨symb⟩ of an instruction.
+ * @param frame Frame of the variable.
+ * @param name Name of the variable, borrowed until the instruction is generated.
+ * @return The operand.
+ */
+inline static Operand operand_symb_var(Frame frame, StrView name) {
+    return (Operand){.symbol = {.type = SymbolType_Variable, .variable = {.frame = frame, .name = name}}};
+}
+
+/**
+ * @brief Create a symbol operand of a constant, ⟨symb⟩ of an instruction.
+ * @param constant Value of the constant, a string is borrowed until the instruction is generated.
+ * @return The operand.
+ */
+inline static Operand operand_symb_const(Data constant) {
+    return (Operand){.symbol = {.type = SymbolType_Constant, .constant = constant}};
+}
+
+/**
+ * @brief Create a label operand, ⟨label⟩ of an instruction.
+ * @param label Name of the label, borrowed until the instruction is generated.
+ * @return The operand.
+ */
+inline static Operand operand_label(StrView label) {
+    return (Operand){.label = label};
+}
+/**
+ * @brief Enumeration representing the kind of an operand of a generated instruction.
+ */
+typedef enum {
+    CodeOperand_Variable,  ///< Variable on a frame, the text is the name of the variable
+    CodeOperand_Constant,  ///< Constant, the text is the whole literal (e.g. `int@42`)
+    CodeOperand_Label,     ///< Label, the text is the encoded label
+    CodeOperand_Type,      ///< Type name of `READ` (e.g. `int`)
+} CodeOperandKind;
+
+/**
+ * @brief Structure representing an operand of a generated instruction.
+ *
+ * The text of the operand is interned, so two operands are the same exactly when their kind, frame and text are.
+ */
+typedef struct {
+    uint8_t kind;   ///< CodeOperandKind of the operand
+    uint8_t frame;  ///< Frame of a variable operand
+    SymbolId text;  ///< Interned text of the operand
+} CodeOperand;
+
 /**
- * @brief Structure representing a generated instruction.
+ * @brief Structure representing a generated instruction, its text is rendered only when printed.
  */
 typedef struct {
-    String code;  ///< The generated code for the instruction
+    uint8_t inst;             ///< The Instruction
+    uint8_t operand_count;    ///< Number of used operands
+    CodeOperand operands[3];  ///< Operands in the order of the instruction
 } GeneratedInstruction;
 
 /**
@@ -244,13 +308,15 @@ typedef struct {
 } CodeBuf;
 
 /**
- * @brief Initialize a CodeBuf instance.
+ * @brief Initialize a CodeBuf instance, no memory is taken until the first instruction is generated into it.
+ *
+ * The storage of all CodeBufs is taken from one pool, which is released by `code_generation_free`.
  * @param buf The CodeBuf instance to initialize.
  */
 void code_buf_init(CodeBuf* buf);
 
 /**
- * @brief Free the resources associated with a CodeBuf instance.
+ * @brief Return the storage of a CodeBuf instance to the pool.
  * @param buf The CodeBuf instance to free.
  */
 void code_buf_free(CodeBuf* buf);
@@ -267,6 +333,13 @@ void code_buf_set(CodeBuf* buf);
  */
 void code_buf_print(CodeBuf* buf);
 
+/**
+ * @brief Append all instructions of the `CodeBuf` to the writer, one instruction per line.
+ * @param writer The writer of the output.
+ * @param buf The `CodeBuf` to be written.
+ */
+void code_buf_write(Writer* writer, CodeBuf* buf);
+
 /**
  * @brief Print all instructions in the active `CodeBuf` to a `String` and return it.
  * @param buf The `CodeBuf` to be printed.
@@ -274,6 +347,13 @@ void code_buf_print(CodeBuf* buf);
  */
 String code_buf_print_to_string(CodeBuf* buf);
 
+/**
+ * @brief Append the text of a generated instruction to the string, without a new line.
+ * @param[in,out] str The String to append to.
+ * @param[in] inst The instruction to render.
+ */
+void code_instruction_render(String* str, const GeneratedInstruction* inst);
+
 /**
  * @brief Generate code for an instruction with specified operands and insert it into the active `CodeBuf`.
  * @param instruction The instruction to generate code for.
@@ -281,11 +361,20 @@ String code_buf_print_to_string(CodeBuf* buf);
  * @param operand2 The second operand.
  * @param operand3 The third operand.
  */
-void code_generation(Instruction, Operand*, Operand*, Operand*);
+void code_generation(Instruction, const Operand*, const Operand*, const Operand*);
 
 /**
- * @brief Generate raw code right into the code buffer without any checks.
- * @param code Code to output.
+ * @brief Generate an instruction from its text into the active `CodeBuf`.
+ *
+ * The text is parsed into a `GeneratedInstruction`, an unknown instruction is an internal error. It is meant for the
+ * fixed code of the builtin functions, the compiler generates the rest of the code by `code_generation`.
+ * @param fmt Printf-like format of the instruction text.
  */
 void code_generation_raw(const char* fmt, ...);
+
+/**
+ * @brief Free the memory shared by the code generation of all `CodeBuf`s, including the storage of the CodeBufs.
+ * @note Every CodeBuf not freed by `code_buf_free` yet is invalidated.
+ */
+void code_generation_free();
 #endif
@@ -21,9 +21,9 @@ const char* MSG[] = {
     "ostatní sémantické chyby.",
     [99] = "interní chyba překladače tj. neovlivněná vstupním programem (např. chyba alokace paměti atd.)."};
 
-Error ERROR = Error_None;
+_Thread_local Error ERROR = Error_None;
 
-bool g_print_errors = true;
+_Thread_local bool g_print_errors = true;
 
 void set_error(Error err) {
     ERROR = err;
@@ -45,9 +45,15 @@ void set_print_errors(bool b) {
     g_print_errors = b;
 }
 
+bool get_print_errors() {
+    return g_print_errors;
+}
+
 void print_error(const struct Token* tok, Error err_type, const char* err_string, const char* fmt, ...) {
     if (g_print_errors) {
-        fprintf(stderr, BOLD("line:%lu:%lu ") COL_R("%s error") ": ", tok->line, tok->position_in_line, err_string);
+        size_t line, column;
+        scanner_position(tok->offset, &line, &column);
+        fprintf(stderr, BOLD("line:%lu:%lu ") COL_R("%s error") ": ", line, column, err_string);
         va_list args;
         va_start(args, fmt);
         vfprintf(stderr, fmt, args);
@@ -64,7 +70,7 @@ const char* INT_ERR_MSG[] = {[0] = "None",
                              "Out-of-range error",
                              "Runtime error"};
 
-IntError g_int_error = {.type = IntError_None};
+_Thread_local IntError g_int_error = {.type = IntError_None};
 
 void set_int_error(IntErrorType type, const char* msg, const char* file, unsigned int line) {
     g_int_error.type = type;
@@ -33,11 +33,11 @@
 
 #endif
 
-/// Print the error string into `stderr`
-#define eprint(s) fprintf(stderr, s)
+/// Print the error string into `stderr`, unless disabled by `set_print_errors`
+#define eprint(s) (get_print_errors() ? fprintf(stderr, s) : 0)
 
-/// Print the error string with format like printf
-#define eprintf(s, ...) fprintf(stderr, s, __VA_ARGS__)
+/// Print the error string with format like printf, unless disabled by `set_print_errors`
+#define eprintf(s, ...) (get_print_errors() ? fprintf(stderr, s, __VA_ARGS__) : 0)
 
 /// Color used when printing error keyword.
 #define ERR_COL COL_R
@@ -80,6 +80,9 @@ typedef enum {
 
 /**
  * @brief Set global error state.
+ *
+ * @note The error state, the internal error state and the printing of errors are kept separately
+ *       for every thread.
  */
 void set_error(Error);
 
@@ -97,6 +100,9 @@ void print_error_msg();
 /// Enable or disable error printing.
 void set_print_errors(bool b);
 
+/// Check whether errors are printed.
+bool get_print_errors();
+
 // Forward declaration.
 struct Token;
 
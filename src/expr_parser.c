@@ -7,6 +7,7 @@
  * @date 27/11/2023
  */
 #include "expr_parser.h"
+#include <math.h>
 #include <string.h>
 #include "codegen.h"
 #include "function_stack.h"
@@ -37,7 +38,7 @@
 
 #define CHECK_IF_PARAM(expr, ...)                                       \
     do {                                                                \
-        if (expr->param_name != NULL) {                                 \
+        if (expr->param_name.data != NULL) {                            \
             syntax_err("Cannot apply any oparation on named argument"); \
             FREE_ALL(__VA_ARGS__);                                      \
             return NULL;                                                \
@@ -72,6 +73,34 @@ const ComprarisonResult PRECEDENCE_TABLE[12][12] = {
 Stack g_stack;
 Pushdown g_pushdown;
 
+static Operand nterm_constant(NTerm* nterm);
+static String* known_string_new();
+static void known_strings_free();
+
+/// Known strings of the parsed expression, they are freed by `known_strings_free` when the expression is parsed
+static String** g_known_strings = NULL;
+static size_t g_known_strings_count = 0;
+static size_t g_known_strings_capacity = 0;
+
+/// `TF@res`, the result of the expression
+static const Operand c_res_var = {.variable = {.frame = Frame_Temporary, .name = {"res", 3}}};
+/// `nil@nil`
+static const Operand c_nil = {
+    .symbol = {.type = SymbolType_Constant, .constant = {.is_nil = true, .type = DataType_Undefined}}};
+/// `TF@ret`, the return value of the called function
+static const Operand c_ret = {
+    .symbol = {.type = SymbolType_Variable, .variable = {.frame = Frame_Temporary, .name = {"ret", 3}}}};
+
+/// ⟨var⟩ operand of the variable of the non-terminal
+static Operand nterm_var(const NTerm* nterm) {
+    return operand_var(nterm->frame, strview_from_c_str(nterm->code_name));
+}
+
+/// ⟨symb⟩ operand of the variable of the non-terminal
+static Operand nterm_symb(const NTerm* nterm) {
+    return operand_symb_var(nterm->frame, strview_from_c_str(nterm->code_name));
+}
+
 bool expr_parser_begin(Data* data) {
     stack_init(&g_stack);
     pushdown_init(&g_pushdown);
@@ -87,17 +116,20 @@ bool expr_parser_begin(Data* data) {
         nterm = item->nterm;
 
     // check if pushdown is reduced to one nonterminal else error occurred during parsing
-    if (g_pushdown.first == g_pushdown.last && nterm != NULL && nterm->name == 'E' && nterm->param_name == NULL) {
+    if (g_pushdown.first == g_pushdown.last && nterm != NULL && nterm->name == 'E' &&
+        nterm->param_name.data == NULL) {
         data->type = nterm->type;
         data->is_nil = nterm->is_nil;
 
-        if (nterm->code_name != NULL) {
-            code_generation_raw("DEFVAR TF@res");
-            code_generation_raw("MOVE TF@res %s@%s", frame_to_string(nterm->frame), nterm->code_name);
+        if (nterm->is_known || nterm->code_name != NULL) {
+            Operand symb = nterm->code_name ? nterm_symb(nterm) : nterm_constant(nterm);
+            code_generation(Instruction_DefVar, &c_res_var, NULL, NULL);
+            code_generation(Instruction_Move, &c_res_var, &symb, NULL);
         }
 
         stack_free(&g_stack);
         pushdown_free(&g_pushdown);
+        known_strings_free();
         return true;
     }
 
@@ -108,6 +140,7 @@ bool expr_parser_begin(Data* data) {
 
     stack_free(&g_stack);
     pushdown_free(&g_pushdown);
+    known_strings_free();
     return false;
 }
 
@@ -123,40 +156,50 @@ PrecedenceCat char_to_precedence(char ch) {
     return 0;
 }
 
-char* operator_to_instruction(Operator op) {
+Instruction operator_to_instruction(Operator op) {
     switch (op) {
         case Operator_And:
-            return "AND";
+            return Instruction_And;
         case Operator_Or:
-            return "OR";
+            return Instruction_Or;
         case Operator_DoubleEqual:
         case Operator_NotEqual:
-            return "EQ";
+            return Instruction_Eq;
         case Operator_LessThan:
         case Operator_LessOrEqual:
-            return "LT";
+            return Instruction_Lt;
         case Operator_MoreThan:
         case Operator_MoreOrEqual:
-            return "GT";
+            return Instruction_Gt;
         case Operator_Plus:
-            return "ADD";
+            return Instruction_Add;
         case Operator_Minus:
-            return "SUB";
+            return Instruction_Sub;
         case Operator_Multiply:
-            return "MUL";
+            return Instruction_Mul;
         case Operator_Divide:
-            return "DIV";
+            return Instruction_Div;
         default:
+            // no instruction is generated after the error
             SET_INT_ERROR(IntError_InvalidArgument, "Invalid operator");
-            return NULL;
+            return Instruction_Start;
     }
 }
 
 char* get_unique_id() {
     static int cnt = 0;
     cnt++;
-    String tmp = string_from_format("tmp%d", cnt);
-    return tmp.data;
+    /// The name outlives any String it could be formatted into, short strings are stored inside of them
+    size_t length = snprintf(NULL, 0, "tmp%d", cnt);
+    char* id = malloc(length + 1);
+
+    if (!id) {
+        SET_INT_ERROR(IntError_Memory, "get_unique_id: Malloc failed!");
+        return NULL;
+    }
+
+    sprintf(id, "tmp%d", cnt);
+    return id;
 }
 
 void parse(Token token, Token* prev_token) {
@@ -361,7 +404,9 @@ NTerm* init_nterm() {
     nterm->name = 'E';
     nterm->is_const = false;
     nterm->is_nil = false;
-    nterm->param_name = NULL;
+    nterm->is_known = false;
+    nterm->string = NULL;
+    nterm->param_name = strview_from_c_str(NULL);
     nterm->frame = Frame_Temporary;
     nterm->code_name = NULL;
     return nterm;
@@ -370,12 +415,11 @@ NTerm* init_nterm() {
 NTerm* reduce_identifier(Token* id, NTerm* nterm) {
     // handle identifier
     if (id->type == Token_Identifier) {
-        char* id_name = id->attribute.data.value.string.data;
-        Symtable* st = symstack_search(id_name);
+        Symtable* st = symstack_search_by_id(id->symbol);
         VariableSymbol* vs;
 
         // identifier is not defined
-        if (st == NULL || (vs = symtable_get_variable(st, id_name)) == NULL || !vs->is_initialized) {
+        if (st == NULL || (vs = symtable_get_variable_by_id(st, id->symbol)) == NULL || !vs->is_initialized) {
             undef_var_err("Indentifier '%s' is undefined", token_to_string(id));
             FREE_ALL(nterm);
             return NULL;
@@ -386,60 +430,321 @@ NTerm* reduce_identifier(Token* id, NTerm* nterm) {
         CHECK_ALLOCATION(nterm->code_name, nterm);
 
         // move variable to temporary frame
-        code_generation_raw("DEFVAR TF@%s", nterm->code_name);
-        code_generation_raw("MOVE TF@%s %s@%s", nterm->code_name, frame_to_string(vs->code_frame), vs->code_name.data);
+        Operand var = nterm_var(nterm);
+        Operand symb = operand_symb_var(vs->code_frame, string_view(&vs->code_name));
+        code_generation(Instruction_DefVar, &var, NULL, NULL);
+        code_generation(Instruction_Move, &var, &symb, NULL);
 
     }
-    // handle constant
+    // handle constant, its code is generated by `nterm_materialize` when it is needed
     else {
-        Operand symb;
-        Operand var;
+        nterm->is_const = true;
+        nterm->is_known = true;
+        nterm->value = id->attribute.data;
 
         if (id->attribute.data.is_nil) {
             nterm->type = DataType_Undefined;
             nterm->is_nil = true;
-            symb.symbol.constant.is_nil = true;
         } else
             nterm->type = id->attribute.data.type;
 
-        symb.symbol.type = SymbolType_Constant;
-        symb.symbol.constant.type = nterm->type;
-        nterm->is_const = true;
+        // the token is gone before the value is used
+        if (nterm->type == DataType_String) {
+            nterm->string = known_string_new();
+            if (nterm->string == NULL) {
+                FREE_ALL(nterm);
+                return NULL;  // allocation error
+            }
+            string_append_view(nterm->string, string_view(&id->attribute.data.value.string));
+        }
+    }
+    return nterm;
+}
+
+/// New empty string owned by the parsed expression, `NULL` on allocation error
+static String* known_string_new() {
+    if (g_known_strings_count == g_known_strings_capacity) {
+        size_t capacity = g_known_strings_capacity ? 2 * g_known_strings_capacity : 16;
+        String** strings = realloc(g_known_strings, capacity * sizeof(String*));
+        if (strings == NULL) {
+            SET_INT_ERROR(IntError_Memory, "Allocation failed");
+            return NULL;
+        }
+        g_known_strings = strings;
+        g_known_strings_capacity = capacity;
+    }
+
+    String* str = malloc(sizeof(String));
+    if (str == NULL) {
+        SET_INT_ERROR(IntError_Memory, "Allocation failed");
+        return NULL;
+    }
 
-        var.variable.frame = Frame_Temporary;
-        var.variable.name = get_unique_id();
-        nterm->code_name = var.variable.name;
+    string_init(str);
+    g_known_strings[g_known_strings_count++] = str;
+    return str;
+}
 
-        if (var.variable.name == NULL)
-            return NULL;  // allocation error
+/// Free the known strings of the parsed expression
+static void known_strings_free() {
+    for (size_t i = 0; i < g_known_strings_count; i++) {
+        string_free(g_known_strings[i]);
+        free(g_known_strings[i]);
+    }
 
-        switch (nterm->type) {
-            case DataType_Bool:
-                symb.symbol.constant.value.is_true = id->attribute.data.value.is_true;
-                break;
-            case DataType_Int:
-                symb.symbol.constant.value.number = id->attribute.data.value.number;
-                break;
-            case DataType_Double:
-                symb.symbol.constant.value.number_double = id->attribute.data.value.number_double;
-                break;
-            case DataType_String:
-                symb.symbol.constant.value.string = id->attribute.data.value.string;
-                if (id->attribute.data.value.string.data == NULL) {
-                    code_generation_raw("DEFVAR TF@%s", nterm->code_name);
-                    code_generation_raw("MOVE TF@%s string@", nterm->code_name);
-                    return nterm;
-                }
-                break;
-            default:
-                symb.symbol.constant.is_nil = true;
-                break;
+    free(g_known_strings);
+    g_known_strings = NULL;
+    g_known_strings_count = 0;
+    g_known_strings_capacity = 0;
+}
+
+/// Constant operand of the known value of the non-terminal
+static Operand nterm_constant(NTerm* nterm) {
+    Operand symb;
+    symb.symbol.type = SymbolType_Constant;
+    symb.symbol.constant = nterm->value;
+    symb.symbol.constant.is_nil = nterm->is_nil;
+    symb.symbol.constant.type = nterm->is_nil ? DataType_Undefined : nterm->type;
+    if (nterm->string != NULL && !nterm->is_nil)
+        symb.symbol.constant.value.string = string_borrow(string_data(nterm->string), nterm->string->length);
+    return symb;
+}
+
+/// Generate the code of the known value into a new variable unless it has one already, `false` on allocation error
+static bool nterm_materialize(NTerm* nterm) {
+    if (!nterm->is_known || nterm->code_name)
+        return true;
+
+    nterm->code_name = get_unique_id();
+    if (nterm->code_name == NULL)
+        return false;  // allocation error
+
+    Operand var = nterm_var(nterm);
+    Operand symb = nterm_constant(nterm);
+
+    code_generation(Instruction_DefVar, &var, NULL, NULL);
+    code_generation(Instruction_Move, &var, &symb, NULL);
+    return true;
+}
+
+/// Convert the constant between Int and Double, a known value is converted at compile time
+static void nterm_convert(NTerm* nterm, DataType type) {
+    if (nterm->is_known && !nterm->code_name) {
+        double number = nterm->value.value.number_double;
+
+        if (type == DataType_Double) {
+            nterm->value.value.number_double = (double)nterm->value.value.number;
+            nterm->type = type;
+            return;
         }
 
-        code_generation_raw("DEFVAR TF@%s", nterm->code_name);
-        code_generation(Instruction_Move, &var, &symb, NULL);
+        // FLOAT2INT of a value out of the range of Int is left to the interpreter
+        if (number >= -9223372036854775808.0 && number < 9223372036854775808.0) {
+            nterm->value.value.number = (int64_t)number;
+            nterm->type = type;
+            return;
+        }
+
+        if (!nterm_materialize(nterm))
+            return;
+        nterm->is_known = false;
+    }
+
+    Operand var = nterm_var(nterm);
+    Operand symb = nterm_symb(nterm);
+    code_generation(type == DataType_Double ? Instruction_Int2Float : Instruction_Float2Int, &var, &symb, NULL);
+    nterm->type = type;
+}
+
+/// Compute `-E` or `!E` of the known value in place, `false` if the operation is left to the interpreter
+static bool fold_prefix(Operator op, NTerm* expr) {
+    DataValue* value = &expr->value.value;
+
+    if (op == Operator_Negation) {
+        if (expr->type != DataType_Bool)
+            return false;
+        value->is_true = !value->is_true;
+        return true;
+    }
+
+    switch (expr->type) {
+        case DataType_Int:
+            // the same as `SUB int@0`, which overflows for the smallest Int
+            if (value->number == INT64_MIN)
+                return false;
+            value->number = -value->number;
+            return true;
+        case DataType_Double:
+            value->number_double = 0.0 - value->number_double;
+            return true;
+        default:
+            return false;
+    }
+}
+
+/// Compute the arithmetic operation of two known values of the same type, `false` if it is left to the interpreter
+static bool fold_arithmetic(NTerm* left, Operator op, NTerm* right, NTerm* nterm) {
+    const DataValue* a = &left->value.value;
+    const DataValue* b = &right->value.value;
+    DataValue* result = &nterm->value.value;
+
+    switch (left->type) {
+        case DataType_Int: {
+            bool overflow;
+
+            switch (op) {
+                case Operator_Plus:
+                    overflow = __builtin_add_overflow(a->number, b->number, &result->number);
+                    break;
+                case Operator_Minus:
+                    overflow = __builtin_sub_overflow(a->number, b->number, &result->number);
+                    break;
+                case Operator_Multiply:
+                    overflow = __builtin_mul_overflow(a->number, b->number, &result->number);
+                    break;
+                case Operator_Divide:
+                    // division by zero is a runtime error, the rounding of a negative quotient is up to the interpreter
+                    if (a->number < 0 || b->number <= 0)
+                        return false;
+                    result->number = a->number / b->number;
+                    overflow = false;
+                    break;
+                default:
+                    return false;
+            }
+
+            if (overflow)
+                return false;
+            break;
+        }
+        case DataType_Double:
+            switch (op) {
+                case Operator_Plus:
+                    result->number_double = a->number_double + b->number_double;
+                    break;
+                case Operator_Minus:
+                    result->number_double = a->number_double - b->number_double;
+                    break;
+                case Operator_Multiply:
+                    result->number_double = a->number_double * b->number_double;
+                    break;
+                case Operator_Divide:
+                    if (b->number_double == 0.0)
+                        return false;
+                    result->number_double = a->number_double / b->number_double;
+                    break;
+                default:
+                    return false;
+            }
+            break;
+        case DataType_String: {
+            if (op != Operator_Plus)
+                return false;
+
+            // the result takes over the string of the left operand, so a chain of literals is built in place, the
+            // caller stops on an allocation error
+            string_append_view(left->string, string_view(right->string));
+            if (got_error())
+                return false;
+
+            string_free(right->string);
+            nterm->string = left->string;
+            left->string = NULL;
+            break;
+        }
+        default:
+            return false;
+    }
+
+    nterm->value.type = left->type;
+    nterm->value.is_nil = false;
+    nterm->is_known = true;
+    return true;
+}
+
+/// Order of two known values of the same type as `strcmp` does, `false` if they cannot be ordered
+static bool compare_known(NTerm* left, NTerm* right, int* order) {
+    const DataValue* a = &left->value.value;
+    const DataValue* b = &right->value.value;
+
+    switch (left->type) {
+        case DataType_Int:
+            *order = (a->number > b->number) - (a->number < b->number);
+            return true;
+        case DataType_Double:
+            if (isnan(a->number_double) || isnan(b->number_double))
+                return false;
+            *order = (a->number_double > b->number_double) - (a->number_double < b->number_double);
+            return true;
+        case DataType_Bool:
+            *order = a->is_true - b->is_true;
+            return true;
+        case DataType_String: {
+            const String* x = left->string;
+            const String* y = right->string;
+            size_t length = x->length < y->length ? x->length : y->length;
+            *order = length ? memcmp(string_data(x), string_data(y), length) : 0;
+            if (!*order)
+                *order = (x->length > y->length) - (x->length < y->length);
+            return true;
+        }
+        default:
+            return false;
     }
-    return nterm;
+}
+
+/// Compute the logic operation of two known values of the same type, `false` if it is left to the interpreter
+static bool fold_logic(NTerm* left, Operator op, NTerm* right, NTerm* nterm) {
+    bool result;
+    int order = 0;
+
+    if (left->is_nil || right->is_nil) {
+        // only `nil == nil` and `nil != nil` pass the type checks
+        if (!left->is_nil || !right->is_nil || (op != Operator_DoubleEqual && op != Operator_NotEqual))
+            return false;
+    } else if (left->type == DataType_Bool && (op == Operator_And || op == Operator_Or)) {
+        result = op == Operator_And ? left->value.value.is_true && right->value.value.is_true
+                                    : left->value.value.is_true || right->value.value.is_true;
+        order = 0;
+    } else if (!compare_known(left, right, &order) ||
+               (left->type == DataType_Bool && op != Operator_DoubleEqual && op != Operator_NotEqual)) {
+        return false;
+    }
+
+    switch (op) {
+        case Operator_And:
+        case Operator_Or:
+            if (left->type != DataType_Bool)
+                return false;
+            break;
+        case Operator_DoubleEqual:
+            result = order == 0;
+            break;
+        case Operator_NotEqual:
+            result = order != 0;
+            break;
+        case Operator_LessThan:
+            result = order < 0;
+            break;
+        case Operator_LessOrEqual:
+            result = order <= 0;
+            break;
+        case Operator_MoreThan:
+            result = order > 0;
+            break;
+        case Operator_MoreOrEqual:
+            result = order >= 0;
+            break;
+        default:
+            return false;
+    }
+
+    nterm->value.type = DataType_Bool;
+    nterm->value.is_nil = false;
+    nterm->value.value.is_true = result;
+    nterm->is_const = true;
+    nterm->is_known = true;
+    return true;
 }
 
 NTerm* reduce_prefix(Operator op, NTerm* expr, NTerm* nterm) {
@@ -451,10 +756,22 @@ NTerm* reduce_prefix(Operator op, NTerm* expr, NTerm* nterm) {
         return NULL;
     }
 
+    if (expr->is_known && fold_prefix(op, expr)) {
+        FREE_ALL(nterm);
+        return expr;
+    }
+
+    if (!nterm_materialize(expr)) {
+        FREE_ALL(nterm);
+        return NULL;
+    }
+
     nterm->code_name = get_unique_id();
     CHECK_ALLOCATION(nterm->code_name, nterm);
 
-    code_generation_raw("DEFVAR TF@%s", nterm->code_name);
+    Operand var = nterm_var(nterm);
+    Operand symb = nterm_symb(expr);
+    code_generation(Instruction_DefVar, &var, NULL, NULL);
 
     // !E
     if (op == Operator_Negation) {
@@ -463,17 +780,21 @@ NTerm* reduce_prefix(Operator op, NTerm* expr, NTerm* nterm) {
             FREE_ALL(nterm->code_name, nterm);
             return NULL;
         }
-        code_generation_raw("NOT TF@%s %s@%s", nterm->code_name, frame_to_string(expr->frame), expr->code_name);
+        code_generation(Instruction_Not, &var, &symb, NULL);
     }
 
     // -E
     else {
-        if (expr->type == DataType_Int) {
-            code_generation_raw("SUB TF@%s int@0 %s@%s", nterm->code_name, frame_to_string(expr->frame),
-                                expr->code_name);
-        } else if (expr->type == DataType_Double) {
-            code_generation_raw("SUB TF@%s float@%a %s@%s", nterm->code_name, 0.0f, frame_to_string(expr->frame),
-                                expr->code_name);
+        if (expr->type == DataType_Int || expr->type == DataType_Double) {
+            // 0 - E
+            Data zero = {.is_nil = false, .type = expr->type};
+            if (expr->type == DataType_Int)
+                zero.value.number = 0;
+            else
+                zero.value.number_double = 0.0;
+
+            Operand zero_symb = operand_symb_const(zero);
+            code_generation(Instruction_Sub, &var, &zero_symb, &symb);
         } else {
             expr_type_err("Expected 'Int' or 'Double', found '%s'.", datatype_to_string(expr->type));
             FREE_ALL(nterm->code_name, nterm);
@@ -550,18 +871,38 @@ NTerm* reduce_arithmetic(NTerm* left, Operator op, NTerm* right, NTerm* nterm) {
     }
 
     nterm->type = left->type;
+
+    if (left->is_known && right->is_known && fold_arithmetic(left, op, right, nterm)) {
+        FREE_ALL(left->code_name, left, right->code_name, right);
+        return nterm;
+    }
+
+    // the operands may be left incomplete by a failed fold
+    if (got_error()) {
+        FREE_ALL(nterm);
+        return NULL;
+    }
+
+    if (!nterm_materialize(left) || !nterm_materialize(right)) {
+        FREE_ALL(nterm);
+        return NULL;
+    }
+
     nterm->code_name = get_unique_id();
     CHECK_ALLOCATION(nterm->code_name, nterm);
 
-    code_generation_raw("DEFVAR TF@%s", nterm->code_name);
+    Operand var = nterm_var(nterm);
+    Operand symb1 = nterm_symb(left);
+    Operand symb2 = nterm_symb(right);
+    code_generation(Instruction_DefVar, &var, NULL, NULL);
 
     if (op == Operator_Plus && nterm->type == DataType_String) {
-        code_generation_raw("CONCAT TF@%s %s@%s %s@%s", nterm->code_name, frame_to_string(left->frame), left->code_name,
-                            frame_to_string(right->frame), right->code_name);
+        code_generation(Instruction_Concat, &var, &symb1, &symb2);
     } else {
-        code_generation_raw("%s TF@%s %s@%s %s@%s", operator_to_instruction(op), nterm->code_name,
-                            frame_to_string(left->frame), left->code_name, frame_to_string(right->frame),
-                            right->code_name);
+        // `/` of two Ints is the integer division
+        Instruction inst =
+            op == Operator_Divide && nterm->type == DataType_Int ? Instruction_Idiv : operator_to_instruction(op);
+        code_generation(inst, &var, &symb1, &symb2);
     }
 
     FREE_ALL(left->code_name, left, right->code_name, right);
@@ -577,10 +918,25 @@ NTerm* reduce_logic(NTerm* left, Operator op, NTerm* right, NTerm* nterm) {
         return NULL;
     }
     nterm->type = DataType_Bool;
+
+    if (left->is_known && right->is_known && fold_logic(left, op, right, nterm)) {
+        FREE_ALL(left->code_name, left, right->code_name, right);
+        return nterm;
+    }
+
+    if (!nterm_materialize(left) || !nterm_materialize(right)) {
+        FREE_ALL(nterm);
+        return NULL;
+    }
+
     nterm->code_name = get_unique_id();
     CHECK_ALLOCATION(nterm->code_name, nterm);
 
-    code_generation_raw("DEFVAR TF@%s", nterm->code_name);
+    Operand var = nterm_var(nterm);
+    Operand result = nterm_symb(nterm);
+    Operand symb1 = nterm_symb(left);
+    Operand symb2 = nterm_symb(right);
+    code_generation(Instruction_DefVar, &var, NULL, NULL);
 
     switch (left->type) {
         case DataType_Bool:
@@ -590,33 +946,32 @@ NTerm* reduce_logic(NTerm* left, Operator op, NTerm* right, NTerm* nterm) {
                 FREE_ALL(nterm->code_name, nterm);
                 return NULL;
             }
-            code_generation_raw("%s TF@%s %s@%s %s@%s", operator_to_instruction(op), nterm->code_name,
-                                frame_to_string(left->frame), left->code_name, frame_to_string(right->frame),
-                                right->code_name);
+            code_generation(operator_to_instruction(op), &var, &symb1, &symb2);
 
             if (op == Operator_NotEqual)
-                code_generation_raw("NOT TF@%s TF@%s", nterm->code_name, nterm->code_name);
+                code_generation(Instruction_Not, &var, &result, NULL);
 
             break;
         case DataType_Int:
         case DataType_Double:
         case DataType_String:
-            code_generation_raw("%s TF@%s %s@%s %s@%s", operator_to_instruction(op), nterm->code_name,
-                                frame_to_string(left->frame), left->code_name, frame_to_string(right->frame),
-                                right->code_name);
+            code_generation(operator_to_instruction(op), &var, &symb1, &symb2);
             switch (op) {
                 case Operator_LessOrEqual:
                 case Operator_MoreOrEqual: {
                     char* tmp = get_unique_id();
-                    code_generation_raw("EQ TF@%s %s@%s %s@%s", tmp, frame_to_string(left->frame), left->code_name,
-                                        frame_to_string(right->frame), right->code_name);
+                    CHECK_ALLOCATION(tmp, nterm->code_name, nterm);
 
-                    code_generation_raw("OR TF@%s TF@%s TF@%s", nterm->code_name, nterm->code_name, tmp);
+                    Operand equal_var = operand_var(Frame_Temporary, strview_from_c_str(tmp));
+                    Operand equal = operand_symb_var(Frame_Temporary, strview_from_c_str(tmp));
+                    code_generation(Instruction_DefVar, &equal_var, NULL, NULL);
+                    code_generation(Instruction_Eq, &equal_var, &symb1, &symb2);
+                    code_generation(Instruction_Or, &var, &result, &equal);
                     FREE_ALL(tmp);
                     break;
                 } break;
                 case Operator_NotEqual:
-                    code_generation_raw("NOT TF@%s TF@%s", nterm->code_name, nterm->code_name);
+                    code_generation(Instruction_Not, &var, &result, NULL);
                     break;
                 default:
                     break;
@@ -640,10 +995,9 @@ NTerm* reduce_logic(NTerm* left, Operator op, NTerm* right, NTerm* nterm) {
                 return NULL;
             }
 
-            code_generation_raw("EQ TF@%s %s@%s %s@%s", nterm->code_name, frame_to_string(left->frame), left->code_name,
-                                frame_to_string(right->frame), right->code_name);
+            code_generation(Instruction_Eq, &var, &symb1, &symb2);
             if (op == Operator_NotEqual)
-                code_generation_raw("NOT TF@%s TF@%s", nterm->code_name, nterm->code_name);
+                code_generation(Instruction_Not, &var, &result, NULL);
             break;
 
         default:
@@ -704,10 +1058,25 @@ NTerm* reduce_nil_coalescing(NTerm* left, NTerm* right, NTerm* nterm) {
         return NULL;
     }
 
+    // a known left operand chooses the result, the code of the right one is still run as before
+    if (left->is_known) {
+        NTerm* result = left->is_nil ? right : left;
+        NTerm* other = left->is_nil ? left : right;
+        result->type = nterm->type;
+        FREE_ALL(other->code_name, other, nterm);
+        return result;
+    }
+
+    if (!nterm_materialize(right)) {
+        FREE_ALL(nterm);
+        return NULL;
+    }
+
     nterm->code_name = get_unique_id();
     CHECK_ALLOCATION(nterm->code_name, nterm);
 
-    code_generation_raw("DEFVAR TF@%s", nterm->code_name);
+    Operand var = nterm_var(nterm);
+    code_generation(Instruction_DefVar, &var, NULL, NULL);
 
     char* if_label = get_unique_id();
     char* else_label = get_unique_id();
@@ -715,12 +1084,17 @@ NTerm* reduce_nil_coalescing(NTerm* left, NTerm* right, NTerm* nterm) {
     CHECK_ALLOCATION(if_label, nterm);
     CHECK_ALLOCATION(else_label, nterm);
 
-    code_generation_raw("JUMPIFEQ %s %s@%s nil@nil", if_label, frame_to_string(left->frame), left->code_name);
-    code_generation_raw("MOVE TF@%s %s@%s", nterm->code_name, frame_to_string(left->frame), left->code_name);
-    code_generation_raw("JUMP %s", else_label);
-    code_generation_raw("LABEL %s", if_label);
-    code_generation_raw("MOVE TF@%s %s@%s", nterm->code_name, frame_to_string(right->frame), right->code_name);
-    code_generation_raw("LABEL %s", else_label);
+    Operand if_op = operand_label(strview_from_c_str(if_label));
+    Operand else_op = operand_label(strview_from_c_str(else_label));
+    Operand symb1 = nterm_symb(left);
+    Operand symb2 = nterm_symb(right);
+
+    code_generation(Instruction_JumpIfEq, &if_op, &symb1, &c_nil);
+    code_generation(Instruction_Move, &var, &symb1, NULL);
+    code_generation(Instruction_Jump, &else_op, NULL, NULL);
+    code_generation(Instruction_Label, &if_op, NULL, NULL);
+    code_generation(Instruction_Move, &var, &symb2, NULL);
+    code_generation(Instruction_Label, &else_op, NULL, NULL);
 
     FREE_ALL(left->code_name, left, right->code_name, right, if_label, else_label);
     return nterm;
@@ -754,7 +1128,7 @@ NTerm* reduce_named_arg(Token* id, NTerm* arg) {
         syntax_err("%s cannot be name of the argument", tokentype_to_string(id->type));
         return NULL;
     }
-    arg->param_name = id->attribute.data.value.string.data;
+    arg->param_name = string_view(&id->attribute.data.value.string);
     return arg;
 }
 
@@ -772,7 +1146,7 @@ NTerm* reduce_function(Token* id, NTerm* arg, NTerm* nterm) {
     else if (arg == NULL)
         stack_push(&g_stack);
 
-    String fn_name = id->attribute.data.value.string;
+    StrView fn_name = string_view(&id->attribute.data.value.string);
     StackNode* top_fn = stack_top(&g_stack);  // the topmost function to be called
 
     // handle function call on any data type e.g. 12() or true()
@@ -783,18 +1157,19 @@ NTerm* reduce_function(Token* id, NTerm* arg, NTerm* nterm) {
     }
 
     // handle `write` function call
-    if (strcmp(fn_name.data, "write") == 0) {
+    if (strview_equals_c_str(fn_name, "write")) {
         for (int i = 0; i < top_fn->param_count; i++) {
             NTerm* param = top_fn->param[i];
 
             // error if named argument provided
-            if (param->param_name != NULL) {
+            if (param->param_name.data != NULL) {
                 fun_type_err("Invalid argument for write function");
                 FREE_ALL(nterm);
                 return NULL;
             }
 
-            code_generation_raw("WRITE %s@%s", frame_to_string(param->frame), param->code_name);
+            Operand symb = param->is_known && !param->code_name ? nterm_constant(param) : nterm_symb(param);
+            code_generation(Instruction_Write, &symb, NULL, NULL);
         }
         stack_pop(&g_stack);
         nterm->type = DataType_Undefined;
@@ -814,43 +1189,50 @@ NTerm* reduce_function(Token* id, NTerm* arg, NTerm* nterm) {
 
     // check number of arguments
     if (top_fn != NULL && expected_function->param_count != top_fn->param_count) {
-        fun_type_err("Inavalid number of arguments in function '%s', expected %d, found %d.", fn_name.data,
-                     expected_function->param_count, top_fn->param_count);
+        fun_type_err("Inavalid number of arguments in function '" STRVIEW_FMT "', expected %d, found %d.",
+                     STRVIEW_ARG(fn_name), expected_function->param_count, top_fn->param_count);
         FREE_ALL(nterm);
         return NULL;
     }
 
-    code_generation_raw("PUSHFRAME");
-    code_generation_raw("CREATEFRAME");
+    code_generation(Instruction_PushFrame, NULL, NULL, NULL);
+    code_generation(Instruction_CreateFrame, NULL, NULL, NULL);
 
     // compare arguments names and types
     for (int i = 0; i < top_fn->param_count; i++) {
-        FunctionParameter expected_param = expected_function->params[i];
+        const FunctionParameter* expected_param = expected_function->params + i;
         NTerm* provided_arg = top_fn->param[i];
 
         // check if both parameters are named or unnamed
-        if (expected_param.is_named ^ (provided_arg->param_name != NULL)) {
-            fun_type_err("Unexpected name for %d. argument in function '%s'", i + 1, fn_name.data);
+        if (expected_param->is_named ^ (provided_arg->param_name.data != NULL)) {
+            fun_type_err("Unexpected name for %d. argument in function '" STRVIEW_FMT "'", i + 1, STRVIEW_ARG(fn_name));
             FREE_ALL(nterm);
             return NULL;
         }
         // check if both are named or unnamed
-        if (provided_arg->param_name && strcmp(expected_param.oname.data, provided_arg->param_name) != 0) {
-            fun_type_err("Unexpected name for %d. argument in function '%s'", i + 1, fn_name.data);
+        if (provided_arg->param_name.data &&
+            !strview_equals(string_view(&expected_param->oname), provided_arg->param_name)) {
+            fun_type_err("Unexpected name for %d. argument in function '" STRVIEW_FMT "'", i + 1, STRVIEW_ARG(fn_name));
             FREE_ALL(nterm);
             return NULL;
         }
 
         // check type and name of the arguments
-        if (!try_convert_to_datatype(expected_param.type, provided_arg, true)) {
-            fun_type_err("Unexpected type '%s' for %d. argument in function '%s'",
-                         datatype_to_string(provided_arg->type), i + 1, fn_name.data);
+        if (!try_convert_to_datatype(expected_param->type, provided_arg, true)) {
+            fun_type_err("Unexpected type '%s' for %d. argument in function '" STRVIEW_FMT "'",
+                         datatype_to_string(provided_arg->type), i + 1, STRVIEW_ARG(fn_name));
             FREE_ALL(nterm);
             return NULL;
         }
 
-        code_generation_raw("DEFVAR TF@%s", expected_param.code_name.data);
-        code_generation_raw("MOVE TF@%s LF@%s", expected_param.code_name.data, provided_arg->code_name);
+        Operand param = operand_var(Frame_Temporary, string_view(&expected_param->code_name));
+        code_generation(Instruction_DefVar, &param, NULL, NULL);
+
+        // a known argument is moved to the parameter right away, the frame of the expression is on the stack now
+        Operand symb = provided_arg->is_known && !provided_arg->code_name
+                           ? nterm_constant(provided_arg)
+                           : operand_symb_var(Frame_Local, strview_from_c_str(provided_arg->code_name));
+        code_generation(Instruction_Move, &param, &symb, NULL);
     }
 
     stack_pop(&g_stack);
@@ -859,10 +1241,13 @@ NTerm* reduce_function(Token* id, NTerm* arg, NTerm* nterm) {
     nterm->code_name = get_unique_id();
     CHECK_ALLOCATION(nterm->code_name, nterm);
 
-    code_generation_raw("CALL %s", expected_function->code_name.data);
-    code_generation_raw("DEFVAR LF@%s", nterm->code_name);
-    code_generation_raw("MOVE LF@%s TF@ret", nterm->code_name);
-    code_generation_raw("POPFRAME");
+    // the result is defined on the frame of the expression, which becomes the temporary one again
+    Operand label = operand_label(string_view(&expected_function->code_name));
+    Operand result = operand_var(Frame_Local, strview_from_c_str(nterm->code_name));
+    code_generation(Instruction_Call, &label, NULL, NULL);
+    code_generation(Instruction_DefVar, &result, NULL, NULL);
+    code_generation(Instruction_Move, &result, &c_ret, NULL);
+    code_generation(Instruction_PopFrame, NULL, NULL, NULL);
 
     FREE_ALL(arg);
     return nterm;
@@ -876,23 +1261,17 @@ bool try_convert_to_same_types(NTerm* op1, NTerm* op2) {
     // is of data type double
     if (op1->is_const && op2->is_const) {
         if (op1->type == DataType_Double && op2->type == DataType_Int) {
-            op2->type = DataType_Double;
-            code_generation_raw("INT2FLOAT %s@%s %s@%s", frame_to_string(op2->frame), op2->code_name,
-                                frame_to_string(op2->frame), op2->code_name);
+            nterm_convert(op2, DataType_Double);
             return true;
         }
     }
 
     if (op1->is_const) {
         if (op1->type == DataType_Int && op2->type == DataType_Double) {
-            op1->type = DataType_Double;
-            code_generation_raw("INT2FLOAT %s@%s %s@%s", frame_to_string(op1->frame), op1->code_name,
-                                frame_to_string(op1->frame), op1->code_name);
+            nterm_convert(op1, DataType_Double);
             return true;
         } else if (op1->type == DataType_Double && op2->type == DataType_Int) {
-            op1->type = DataType_Int;
-            code_generation_raw("FLOAT2INT %s@%s %s@%s", frame_to_string(op1->frame), op1->code_name,
-                                frame_to_string(op1->frame), op1->code_name);
+            nterm_convert(op1, DataType_Int);
             return true;
         } else if (op1->is_nil) {
             switch (op2->type) {
@@ -911,15 +1290,11 @@ bool try_convert_to_same_types(NTerm* op1, NTerm* op2) {
 
     if (op2->is_const) {
         if (op1->type == DataType_Int && op2->type == DataType_Double) {
-            op2->type = DataType_Int;
-            code_generation_raw("FLOAT2INT %s@%s %s@%s", frame_to_string(op2->frame), op2->code_name,
-                                frame_to_string(op2->frame), op2->code_name);
+            nterm_convert(op2, DataType_Int);
             return true;
 
         } else if (op1->type == DataType_Double && op2->type == DataType_Int) {
-            op2->type = DataType_Double;
-            code_generation_raw("INT2FLOAT %s@%s %s@%s", frame_to_string(op2->frame), op2->code_name,
-                                frame_to_string(op2->frame), op2->code_name);
+            nterm_convert(op2, DataType_Double);
 
             return true;
         } else if (op2->is_nil) {
@@ -949,12 +1324,10 @@ bool try_convert_to_datatype(DataType dt, NTerm* operand, bool allow_nil) {
 
     if (operand->is_const) {
         if (operand->type == DataType_Int && dt == DataType_Double) {
-            operand->type = DataType_Double;
-            code_generation_raw("INT2FLOAT TF@%s TF@%s", operand->code_name, operand->code_name);
+            nterm_convert(operand, DataType_Double);
             return true;
         } else if (operand->type == DataType_Double && dt == DataType_Int) {
-            operand->type = DataType_Int;
-            code_generation_raw("FLOAT2INT TF@%s TF@%s", operand->code_name, operand->code_name);
+            nterm_convert(operand, DataType_Int);
             return true;
         }
     }
@@ -975,17 +1348,18 @@ bool try_convert_to_datatype(DataType dt, NTerm* operand, bool allow_nil) {
     return false;
 }
 
-FunctionSymbol* get_fn_symbol(String fn_name) {
-    Symtable* sym = symstack_search(fn_name.data);
+FunctionSymbol* get_fn_symbol(StrView fn_name) {
+    SymbolId id = intern_find_view(fn_name);
+    Symtable* sym = symstack_search_by_id(id);
 
     if (sym == NULL) {
-        undef_fun_err("Undefined function '%s'.", fn_name.data);
+        undef_fun_err("Undefined function '" STRVIEW_FMT "'.", STRVIEW_ARG(fn_name));
         return NULL;
     }
 
-    FunctionSymbol* fs = symtable_get_function(sym, fn_name.data);
+    FunctionSymbol* fs = symtable_get_function_by_id(sym, id);
     if (fs == NULL) {
-        undef_fun_err("'%s' is not a function", fn_name.data);
+        undef_fun_err("'" STRVIEW_FMT "' is not a function", STRVIEW_ARG(fn_name));
         return NULL;
     }
     return fs;
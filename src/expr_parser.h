@@ -79,10 +79,13 @@ typedef struct NTerm {
     DataType type;    /**< resulted type after applying a reduction rule */
     Frame frame;      /** Frame where the value is stored */
     char* code_name;  /** Name of the variable on the frame */
-    char* param_name; /** Name of the function parameter */
+    StrView param_name; /** Name of the function parameter, borrowed from the token */
     bool is_nil;      /** Tells whether constant is nil */
     char name;        /**< E or L */
     bool is_const;    /**< `true` only if const reduced to nonterminal, otherwise `false`*/
+    bool is_known;    /**< `true` if the value is known at compile time, no code is generated until it is needed */
+    Data value;       /**< Value of the nonterminal if `is_known`, except a string that is kept in `NTerm::string` */
+    String* string;   /**< Known String value, owned by the expression and freed when it is parsed */
 } NTerm;
 
 // Forward declaration
@@ -142,7 +145,7 @@ Rule get_rule(char* rule);
  * @param[in] fn_name Name of function.
  * @return `FunctionSymbol` of function with a `fn_name` if found in symtable, otherwise returns `NULL`.
  */
-FunctionSymbol* get_fn_symbol(String fn_name);
+FunctionSymbol* get_fn_symbol(StrView fn_name);
 
 /**
  * @brief Remove all terminals and nonterminals from `pushdown` and replace them with nonterminal created by applying a
@@ -168,7 +171,8 @@ NTerm* init_nterm();
 /**
  * @brief Checks exitence of identifier in symtable. If identifier was not found prints corresponding error message and
  * return `NULL`. If identifier found return `NTerm` that holds information about identifier or immediate value. When
- * immediate value is reduced `NTerm::is_const` is set to `true`.
+ * immediate value is reduced `NTerm::is_const` and `NTerm::is_known` are set to `true` and its code is generated only
+ * when the value is used by an operation which is not folded.
  * @param[in] id Token representing variable of constant.
  * @param[in,out] nterm Non-terminal with default attributes set.
  * @return Non terminal that holds data about variable/constant.
@@ -196,7 +200,8 @@ NTerm* reduce_postfix(NTerm* expr, NTerm* nterm);
 
 /**
  * @brief Apply rule for arithmetic operations (+-*\/). Checks type of the operands and if possible converts operand to
- * have the same data type (prints error message if there is a operand mismatch).
+ * have the same data type (prints error message if there is a operand mismatch). The operation on two known values is
+ * computed at compile time.
  * @param[in] left The left operand in binary expression.
  * @param[in] op Binary operator: '+', '-', '*', '/'
  * @param[in] right The right operand in binary expression.
@@ -207,7 +212,8 @@ NTerm* reduce_arithmetic(NTerm* left, Operator op, NTerm* right, NTerm* nterm);
 
 /**
  * @brief Apply rule for logic operations (== < > != <= >= && ||). Checks type of the operands and if possible converts
- * operand to have the same data type (prints error message if there is a operand mismatch).
+ * operand to have the same data type (prints error message if there is a operand mismatch). The comparison of two known
+ * values is computed at compile time.
  * @param[in] left The left operand in binary expression.
  * @param[in] op Binary operator: '==', '!=', '<', '>', '&&', '||', '>=', '<='
  * @param[in] right The right operand in binary expression.
@@ -219,7 +225,7 @@ NTerm* reduce_logic(NTerm* left, Operator op, NTerm* right, NTerm* nterm);
 /**
  * @brief Apply rule for replacing left operand if nil by a default value from the right operand. Checks type of the
  * operands(prints error message if there is a operand mismatch). If left operand is not nullable, right operand is
- * ignored.
+ * ignored. If the left operand is a known value, the result is chosen at compile time.
  * @param[in] left The left operand in binary expression.
  * @param[in] right The right operand in binary expression. This operand cannot be nil or nullable data type
  * @param[in,out] nterm Non-terminal with default attributes set.
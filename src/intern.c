@@ -0,0 +1,184 @@
+/**
+ * @note Project: Implementace překladače imperativního jazyka IFJ23
+ * @file intern.c
+ * @author agent, agent, VUT FIT
+ * @date 16/10/2026
+ * @brief Implementation for the intern.h
+ */
+
+#include "intern.h"
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+#include "error.h"
+
+/// Initial number of slots in the hash table, has to be a power of 2
+const uint32_t c_intern_slots = 256;
+
+typedef struct {
+    const char* data;
+    uint32_t length;
+    uint32_t hash;
+} InternEntry;
+
+typedef struct {
+    /// Interned names indexed by their ID, the entry 0 is reserved for `SYMBOL_NONE`
+    InternEntry* entries;
+    uint32_t count;
+    uint32_t capacity;
+    /// Open addressing hash table of IDs, `SYMBOL_NONE` marks an empty slot
+    SymbolId* slots;
+    uint32_t slot_count;
+    /// Memory of the names, the arena never moves them so the names stay valid
+    Arena names;
+} Interner;
+
+static Interner g_interner;
+
+static uint32_t hash_bytes(const char* str, size_t length) {
+    return strview_hash((StrView){.data = str, .length = length});
+}
+
+static void intern_out_of_memory() {
+    set_error(Error_Internal);
+    eprint("intern: Out Of Memory\n");
+}
+
+/// Double the hash table, or create it when it does not exist yet
+static bool grow_slots() {
+    uint32_t slot_count = g_interner.slot_count ? g_interner.slot_count * 2 : c_intern_slots;
+    SymbolId* slots = calloc(slot_count, sizeof(SymbolId));
+
+    if (!slots) {
+        return false;
+    }
+
+    for (SymbolId id = 1; id < g_interner.count; id++) {
+        uint32_t idx = g_interner.entries[id].hash & (slot_count - 1);
+
+        while (slots[idx] != SYMBOL_NONE) {
+            idx = (idx + 1) & (slot_count - 1);
+        }
+
+        slots[idx] = id;
+    }
+
+    free(g_interner.slots);
+    g_interner.slots = slots;
+    g_interner.slot_count = slot_count;
+    return true;
+}
+
+static bool grow_entries() {
+    uint32_t capacity = g_interner.capacity ? g_interner.capacity * 2 : c_intern_slots;
+    InternEntry* entries = realloc(g_interner.entries, sizeof(InternEntry) * capacity);
+
+    if (!entries) {
+        return false;
+    }
+
+    if (!g_interner.capacity) {
+        entries[SYMBOL_NONE] = (InternEntry){.data = "", .length = 0, .hash = 0};
+        g_interner.count = 1;
+    }
+
+    g_interner.entries = entries;
+    g_interner.capacity = capacity;
+    return true;
+}
+
+/// Find the slot of the name, the returned slot is empty if the name is not interned
+static uint32_t find_slot(const char* str, size_t length, uint32_t hash) {
+    uint32_t mask = g_interner.slot_count - 1;
+    uint32_t idx = hash & mask;
+
+    for (;;) {
+        SymbolId id = g_interner.slots[idx];
+
+        if (id == SYMBOL_NONE) {
+            return idx;
+        }
+
+        InternEntry* entry = &g_interner.entries[id];
+
+        if (entry->hash == hash && entry->length == length && memcmp(entry->data, str, length) == 0) {
+            return idx;
+        }
+
+        idx = (idx + 1) & mask;
+    }
+}
+
+SymbolId intern_add(const char* str, size_t length) {
+    /// Keep the load factor of the hash table under 1/2
+    if (g_interner.count * 2 >= g_interner.slot_count && !grow_slots()) {
+        intern_out_of_memory();
+        return SYMBOL_NONE;
+    }
+
+    uint32_t hash = hash_bytes(str, length);
+    uint32_t slot = find_slot(str, length, hash);
+
+    if (g_interner.slots[slot] != SYMBOL_NONE) {
+        return g_interner.slots[slot];
+    }
+
+    if (g_interner.count == g_interner.capacity && !grow_entries()) {
+        intern_out_of_memory();
+        return SYMBOL_NONE;
+    }
+
+    const char* name = arena_strndup(&g_interner.names, str, length);
+
+    if (!name) {
+        return SYMBOL_NONE;
+    }
+
+    SymbolId id = g_interner.count++;
+    g_interner.entries[id] = (InternEntry){.data = name, .length = length, .hash = hash};
+    g_interner.slots[slot] = id;
+    return id;
+}
+
+SymbolId intern_add_c_str(const char* str) {
+    return intern_add(str, strlen(str));
+}
+
+SymbolId intern_find(const char* str) {
+    return intern_find_view(strview_from_c_str(str));
+}
+
+SymbolId intern_find_view(StrView name) {
+    if (!g_interner.slot_count) {
+        return SYMBOL_NONE;
+    }
+
+    return g_interner.slots[find_slot(name.data, name.length, hash_bytes(name.data, name.length))];
+}
+
+const char* intern_get(SymbolId id) {
+    MASSERT(id && id < g_interner.count, "intern_get: invalid symbol ID");
+    return g_interner.entries[id].data;
+}
+
+String intern_view(SymbolId id) {
+    MASSERT(id && id < g_interner.count, "intern_view: invalid symbol ID");
+    InternEntry* entry = &g_interner.entries[id];
+    return string_borrow(entry->data, entry->length);
+}
+
+uint32_t intern_hash(SymbolId id) {
+    MASSERT(id && id < g_interner.count, "intern_hash: invalid symbol ID");
+    return g_interner.entries[id].hash;
+}
+
+size_t intern_count() {
+    return g_interner.count ? g_interner.count - 1 : 0;
+}
+
+void intern_free() {
+    arena_free(&g_interner.names);
+    free(g_interner.entries);
+    free(g_interner.slots);
+    g_interner = (Interner){0};
+}
@@ -0,0 +1,87 @@
+/**
+ * @note Project: Implementace překladače imperativního jazyka IFJ23
+ * @file intern.h
+ * @author agent, agent, VUT FIT
+ * @date 16/10/2026
+ * @brief Global interner of identifier names.
+ *
+ * Every distinct name is stored exactly once and identified by a 32-bit symbol ID, so the scanner and
+ * the symbol tables can compare names by comparing integers. Interned names live until `intern_free`.
+ */
+
+#ifndef INTERN_H
+#define INTERN_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "string.h"
+
+/// Identifier of an interned name
+typedef uint32_t SymbolId;
+
+/// Symbol ID that is never assigned to any name
+#define SYMBOL_NONE ((SymbolId)0)
+
+/**
+ * @brief Intern the first `length` bytes of `str`.
+ *
+ * @param[in] str Name to intern, does not have to be null terminated.
+ * @param[in] length Length of the name.
+ * @return ID of the name, the same name always gets the same ID. `SYMBOL_NONE` if out of memory.
+ */
+SymbolId intern_add(const char* str, size_t length);
+
+/**
+ * @brief Intern a null terminated string.
+ * @param[in] str Name to intern.
+ * @return ID of the name or `SYMBOL_NONE` if out of memory.
+ */
+SymbolId intern_add_c_str(const char* str);
+
+/**
+ * @brief Find the ID of an already interned name without interning it.
+ * @param[in] str Null terminated name.
+ * @return ID of the name or `SYMBOL_NONE` if the name has never been interned.
+ */
+SymbolId intern_find(const char* str);
+
+/**
+ * @brief Find the ID of an already interned name without interning it.
+ * @param[in] name The name, does not have to be null terminated.
+ * @return ID of the name or `SYMBOL_NONE` if the name has never been interned.
+ */
+SymbolId intern_find_view(StrView name);
+
+/**
+ * @brief Get the interned name.
+ * @param[in] id Valid symbol ID.
+ * @return Null terminated name owned by the interner.
+ */
+const char* intern_get(SymbolId id);
+
+/**
+ * @brief Get the interned name as a String.
+ *
+ * @param[in] id Valid symbol ID.
+ * @return String borrowing the memory of the interner, it must not be modified nor freed.
+ */
+String intern_view(SymbolId id);
+
+/**
+ * @brief Get the precomputed hash of the interned name.
+ * @param[in] id Valid symbol ID.
+ * @return Hash of the name.
+ */
+uint32_t intern_hash(SymbolId id);
+
+/**
+ * @brief Get the number of interned names.
+ */
+size_t intern_count();
+
+/**
+ * @brief Free all interned names. All symbol IDs are invalidated.
+ */
+void intern_free();
+
+#endif
@@ -5,11 +5,47 @@
 /// @date 08/10/2023
 /// @brief Main program of the IFJ23
 
+#include <stdio.h>
+#include <string.h>
 #include "error.h"
+#include "intern.h"
 #include "parser.h"
 #include "scanner.h"
 
-int main() {
+/// Options given on the command line
+typedef struct {
+    int optimization;  ///< Level selected by the `-O0`/`-O1` option, -1 if the level is not given
+    bool streaming;    ///< `--stream`, functions are written as soon as they are parsed
+    bool verbose;      ///< `-v`, statistics of the compilation are printed to stderr
+} Options;
+
+/// Parse the command line options, `false` on an unknown option
+static bool parse_options(int argc, char** argv, Options* options) {
+    options->optimization = -1;
+    options->streaming = false;
+    options->verbose = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-O0") || !strcmp(argv[i], "-O1")) {
+            options->optimization = argv[i][2] - '0';
+        } else if (!strcmp(argv[i], "--stream")) {
+            options->streaming = true;
+        } else if (!strcmp(argv[i], "-v")) {
+            options->verbose = true;
+        } else {
+            eprintf("Unknown option `%s`, expected -O0, -O1, --stream or -v\n", argv[i]);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parse_options(argc, argv, &options))
+        return 99;
+
     // Initialize the parser to use this file for tokens.
     scanner_init(stdin);
     if (got_error()) {
@@ -23,8 +59,12 @@ int main() {
             print_int_error_msg();
         print_error_msg();
         scanner_free();
+        intern_free();
         return 99;
     }
+    if (options.optimization >= 0)
+        parser_set_optimization(options.optimization);
+    parser_set_streaming(options.streaming);
 
     // Parse the source file.
     parser_begin(true);
@@ -32,9 +72,12 @@ int main() {
         if (got_int_error())
             print_int_error_msg();
         print_error_msg();
+    } else if (options.verbose) {
+        fprintf(stderr, "peephole: removed %zu instructions\n", g_parser.removed_instructions);
     }
 
     parser_free();
     scanner_free();
+    intern_free();
     return got_error();
 }
@@ -6,10 +6,11 @@
  * @date 23/11/2023
  */
 #include "parser.h"
-#include <math.h>
 #include <string.h>
+#include <unistd.h>
 #include "builtin.h"
 #include "codegen.h"
+#include "peephole.h"
 #include "rec_parser.h"
 #include "scanner.h"
 
@@ -30,6 +31,11 @@ void parser_init() {
         return;
     }
     g_parser.currect_code = &g_parser.global_code;
+    writer_init(&g_parser.output, STDOUT_FILENO);
+    g_parser.output_code = false;
+    g_parser.streaming = false;
+    g_parser.optimization = 1;
+    g_parser.removed_instructions = 0;
     g_parser.global_var_counter = 0;
     g_parser.local_var_counter = 0;
 }
@@ -49,13 +55,22 @@ bool add_builtin_functions() {
     return true;
 }
 
+/// Optimize the code in the buffer according to the optimization level and append it to the output
+static void parser_write_code(CodeBuf* buf) {
+    if (g_parser.optimization > 0) {
+        g_parser.removed_instructions += peephole_optimize(buf);
+    }
+
+    code_buf_write(&g_parser.output, buf);
+}
+
 void print_all_func_codes(Node* node) {
     if (!node)
         return;
     if (node->type == NodeType_Function) {
         if (node->value.function.is_used) {
-            code_buf_print(&node->value.function.code_defs);
-            code_buf_print(&node->value.function.code);
+            parser_write_code(&node->value.function.code_defs);
+            parser_write_code(&node->value.function.code);
         }
     }
     print_all_func_codes(node->left);
@@ -63,6 +78,7 @@ void print_all_func_codes(Node* node) {
 }
 
 bool parser_begin(bool output_code) {
+    g_parser.output_code = output_code;
     code_buf_set(g_parser.currect_code);
 
     if (!add_builtin_functions())
@@ -80,18 +96,37 @@ bool parser_begin(bool output_code) {
 
     // Output code for global statements
     if (output_code) {
-        code_buf_print(&g_parser.var_defs_code);
-        code_buf_print(&g_parser.global_code);
+        parser_write_code(&g_parser.var_defs_code);
+        parser_write_code(&g_parser.global_code);
         print_all_func_codes(symstack_bottom()->root);
+        writer_flush(&g_parser.output);
     }
 
-    return true;
+    return !got_error();
+}
+
+void parser_set_streaming(bool streaming) {
+    g_parser.streaming = streaming;
+}
+
+void parser_set_optimization(int level) {
+    g_parser.optimization = level;
+}
+
+void parser_stream_code(CodeBuf* buf) {
+    if (g_parser.output_code) {
+        parser_write_code(buf);
+    }
+
+    code_buf_free(buf);
 }
 
 void parser_free() {
     symstack_free();
     code_buf_free(&g_parser.global_code);
     code_buf_free(&g_parser.var_defs_code);
+    code_generation_free();
+    writer_free(&g_parser.output);
     g_parser.currect_code = NULL;
 }
 
@@ -121,7 +156,8 @@ Token* parser_next_token() {
 }
 
 bool parser_tok_is_fun_id() {
-    NodeType* ntype = symtable_get_symbol_type(symstack_top(), g_parser.token.attribute.data.value.string.data);
+    String* name = &g_parser.token.attribute.data.value.string;
+    NodeType* ntype = symtable_get_symbol_type(symstack_top(), string_data(name));
     if (!ntype)
         return false;
     return g_parser.token.type == Token_Identifier && *ntype == NodeType_Function;
@@ -129,21 +165,19 @@ bool parser_tok_is_fun_id() {
 
 // Insert `name%index` into string `str`
 void create_var_name(String* str, const char* name, int index) {
+    // % and up to 10 digits with a sign
+    char suffix[13];
+    snprintf(suffix, sizeof(suffix), "%%%i", index);
+
     string_clear(str);
-    int index_chars = index != 0 ? (int)((ceil(log10(index)) + 1)) : 1;
-    size_t name_len = strlen(name);
-    string_reserve(str, name_len + index_chars + 2);  // + 2 <--- % a \0
     string_concat_c_str(str, name);
-    sprintf(str->data + name_len, "%%%i", index);
-    str->length = name_len + index_chars + 1;
-    str->data[str->length] = '\0';
-    MASSERT(str->length <= str->capacity, "Wrong int to string conversion.");
+    string_concat_c_str(str, suffix);
 }
 
 void parser_parameter_code_infos(FunctionSymbol* func) {
     for (int i = 0; i < func->param_count; i++) {
         FunctionParameter* param = func->params + i;
-        create_var_name(&param->code_name, param->iname.data, i);
+        create_var_name(&param->code_name, string_data(&param->iname), i);
     }
 }
 
@@ -159,12 +193,8 @@ void parser_variable_code_info(VariableSymbol* var, const char* name) {
 
 void parser_function_code_info(FunctionSymbol* func, const char* name) {
     string_clear(&func->code_name);
-    int len = strlen("func%") + strlen(name) + 2;
-    string_reserve(&func->code_name, len);
-    func->code_name.length = len;
-    MASSERT(func->code_name.length <= func->code_name.capacity, "");
-    sprintf(func->code_name.data, "func%%%s", name);
-    func->code_name.data[len - 1] = '\0';
+    string_concat_c_str(&func->code_name, "func%");
+    string_concat_c_str(&func->code_name, name);
 
     parser_parameter_code_infos(func);
 }
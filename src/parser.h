@@ -31,6 +31,16 @@ typedef struct {
     CodeBuf global_code;
     /// Pointer to currect buffer to which to generate.
     CodeBuf* currect_code;
+    /// Writer of the IFJcode23 output to stdout.
+    Writer output;
+    /// Whether the code is written to `output`, see `parser_begin`.
+    bool output_code;
+    /// Whether functions are written as soon as they are parsed, see `parser_set_streaming`.
+    bool streaming;
+    /// Optimization level of the written code, see `parser_set_optimization`.
+    int optimization;
+    /// Number of instructions removed by the peephole optimizer from the written code.
+    size_t removed_instructions;
     /// Used for counting number of declarations in global scope. This
     /// is used for unique name for each variable in global scope.
     int global_var_counter;
@@ -59,6 +69,36 @@ void parser_init();
  */
 bool parser_begin(bool output_code);
 
+/**
+ * @brief Select whether finished functions are written to the output right away.
+ *
+ * By default the whole program is kept until `parser_begin` ends and only the used functions are written.
+ * In the streaming mode the code of every function is written and released as soon as its body is parsed,
+ * so the memory does not grow with the number of functions. The program then starts by jumping over the functions
+ * to the global code, which is written last.
+ *
+ * @note In the streaming mode a part of the code can be written even if an error is found later.
+ * @param[in] streaming true to enable the streaming mode.
+ */
+void parser_set_streaming(bool streaming);
+
+/**
+ * @brief Select the optimization level of the written code.
+ *
+ * Level 0 writes the code as it was generated, level 1 (the default) runs the peephole optimizer on every buffer
+ * before it is written. The number of removed instructions is counted in `Parser::removed_instructions`, the compiler
+ * prints it with the `-v` option.
+ *
+ * @param[in] level The optimization level.
+ */
+void parser_set_optimization(int level);
+
+/**
+ * @brief Write the code in the buffer to the output, if the output is enabled, and free the buffer.
+ * @param[in,out] buf The buffer to write.
+ */
+void parser_stream_code(CodeBuf* buf);
+
 /// Free all resources allocated with parser.
 void parser_free();
 
@@ -0,0 +1,607 @@
+/**
+ * @note Project: Implementace překladače imperativního jazyka IFJ23
+ * @file peephole.c
+ * @author agent, agent, VUT FIT
+ * @date 16/10/2026
+ * @brief Implementation for the peephole.h
+ */
+
+#include "peephole.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "error.h"
+
+/// Instruction value of a removed instruction, the removed instructions are dropped at the end of every pass
+#define PEEPHOLE_REMOVED UINT8_MAX
+
+/// Position of a label in the buffer
+typedef struct {
+    SymbolId label;   ///< Interned text of the label
+    size_t position;  ///< Position of its `LABEL` instruction
+} PeepholeLabel;
+
+/// State of the optimization of one buffer
+typedef struct {
+    CodeBuf* buf;
+    PeepholeLabel* labels;  ///< Labels of the buffer sorted by their text
+    size_t label_count;
+    uint32_t* visited;  ///< Instructions visited by the current search, marked by `stamp`
+    uint32_t stamp;
+    size_t* stack;  ///< Instructions to visit by the current search
+    SymbolId bool_true;
+    SymbolId bool_false;
+    size_t removed;
+} Peephole;
+
+static bool operand_equals(const CodeOperand* a, const CodeOperand* b) {
+    return a->kind == b->kind && a->frame == b->frame && a->text == b->text;
+}
+
+static bool operand_is_temporary(const CodeOperand* op) {
+    return op->kind == CodeOperand_Variable && op->frame == Frame_Temporary;
+}
+
+/// Instructions storing their result to the variable of the first operand
+static bool instruction_writes_first(uint8_t inst) {
+    switch (inst) {
+        case Instruction_Move:
+        case Instruction_DefVar:
+        case Instruction_Pops:
+        case Instruction_Add:
+        case Instruction_Sub:
+        case Instruction_Mul:
+        case Instruction_Div:
+        case Instruction_Idiv:
+        case Instruction_Lt:
+        case Instruction_Gt:
+        case Instruction_Eq:
+        case Instruction_And:
+        case Instruction_Or:
+        case Instruction_Not:
+        case Instruction_Int2Float:
+        case Instruction_Float2Int:
+        case Instruction_Int2Char:
+        case Instruction_Stri2Int:
+        case Instruction_Read:
+        case Instruction_Concat:
+        case Instruction_Strlen:
+        case Instruction_GetChar:
+        case Instruction_SetChar:
+        case Instruction_Type:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/// Whether the operand at the index is read by the instruction
+static bool instruction_reads_operand(const GeneratedInstruction* inst, int index) {
+    switch (inst->inst) {
+        case PEEPHOLE_REMOVED:
+        case Instruction_DefVar:
+            return false;
+        case Instruction_Write:
+        case Instruction_Pushs:
+        case Instruction_Exit:
+        case Instruction_DebugPrint:
+            return index == 0;
+        case Instruction_JumpIfEq:
+        case Instruction_JumpIfNeq:
+            return index > 0;
+        case Instruction_SetChar:
+            return true;
+        default:
+            return instruction_writes_first(inst->inst) && index > 0;
+    }
+}
+
+static bool instruction_reads(const GeneratedInstruction* inst, const CodeOperand* var) {
+    for (int i = 0; i < inst->operand_count; i++) {
+        if (operand_equals(&inst->operands[i], var) && instruction_reads_operand(inst, i)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool instruction_mentions(const GeneratedInstruction* inst, const CodeOperand* var) {
+    for (int i = 0; i < inst->operand_count; i++) {
+        if (operand_equals(&inst->operands[i], var)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/// Whether the variable is overwritten or dropped by the instruction, its previous value cannot be read after it
+static bool instruction_kills(const GeneratedInstruction* inst, const CodeOperand* var) {
+    if (inst->inst == PEEPHOLE_REMOVED) {
+        return false;
+    }
+
+    if (var->frame == Frame_Temporary && (inst->inst == Instruction_CreateFrame || inst->inst == Instruction_PopFrame)) {
+        return true;
+    }
+
+    return instruction_writes_first(inst->inst) && inst->inst != Instruction_SetChar &&
+           operand_equals(&inst->operands[0], var);
+}
+
+/// Instructions after which the optimizer does not follow the code of the buffer
+static bool instruction_leaves_block(uint8_t inst) {
+    switch (inst) {
+        case Instruction_CreateFrame:
+        case Instruction_PushFrame:
+        case Instruction_PopFrame:
+        case Instruction_Call:
+        case Instruction_Return:
+        case Instruction_Label:
+        case Instruction_Jump:
+        case Instruction_JumpIfEq:
+        case Instruction_JumpIfNeq:
+        case Instruction_JumpIfEqs:
+        case Instruction_JumpIfNeqs:
+        case Instruction_Exit:
+        case Instruction_Break:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static GeneratedInstruction* peephole_at(Peephole* ctx, size_t position) {
+    return position < ctx->buf->size ? &ctx->buf->buf[position] : NULL;
+}
+
+static size_t peephole_next(Peephole* ctx, size_t position) {
+    do {
+        position++;
+    } while (position < ctx->buf->size && ctx->buf->buf[position].inst == PEEPHOLE_REMOVED);
+
+    return position;
+}
+
+static size_t peephole_prev(Peephole* ctx, size_t position) {
+    while (position--) {
+        if (ctx->buf->buf[position].inst != PEEPHOLE_REMOVED) {
+            return position;
+        }
+    }
+
+    return ctx->buf->size;
+}
+
+static void peephole_remove(Peephole* ctx, size_t position) {
+    ctx->buf->buf[position].inst = PEEPHOLE_REMOVED;
+    ctx->removed++;
+}
+
+static int label_compare(const void* a, const void* b) {
+    SymbolId x = ((const PeepholeLabel*)a)->label;
+    SymbolId y = ((const PeepholeLabel*)b)->label;
+    return (x > y) - (x < y);
+}
+
+static void peephole_collect_labels(Peephole* ctx) {
+    ctx->label_count = 0;
+
+    for (size_t i = 0; i < ctx->buf->size; i++) {
+        if (ctx->buf->buf[i].inst == Instruction_Label) {
+            ctx->labels[ctx->label_count++] = (PeepholeLabel){ctx->buf->buf[i].operands[0].text, i};
+        }
+    }
+
+    qsort(ctx->labels, ctx->label_count, sizeof(PeepholeLabel), label_compare);
+}
+
+/// Position of the label or the size of the buffer if the label is not in the buffer
+static size_t peephole_find_label(Peephole* ctx, SymbolId label) {
+    PeepholeLabel key = {label, 0};
+    PeepholeLabel* found = bsearch(&key, ctx->labels, ctx->label_count, sizeof(PeepholeLabel), label_compare);
+    return found ? found->position : ctx->buf->size;
+}
+
+static bool peephole_push(Peephole* ctx, size_t* count, size_t position) {
+    if (position >= ctx->buf->size) {
+        return false;
+    }
+
+    if (ctx->visited[position] != ctx->stamp) {
+        ctx->visited[position] = ctx->stamp;
+        ctx->stack[(*count)++] = position;
+    }
+
+    return true;
+}
+
+/// Push the instructions executed right after the one at the position, false if the code leaves the buffer
+static bool peephole_push_successors(Peephole* ctx, size_t* count, size_t position) {
+    const GeneratedInstruction* inst = &ctx->buf->buf[position];
+
+    switch (inst->inst) {
+        case Instruction_Exit:
+            return true;
+        case Instruction_Jump:
+            return peephole_push(ctx, count, peephole_find_label(ctx, inst->operands[0].text));
+        case Instruction_JumpIfEq:
+        case Instruction_JumpIfNeq:
+            return peephole_push(ctx, count, peephole_find_label(ctx, inst->operands[0].text)) &&
+                   peephole_push(ctx, count, position + 1);
+        case Instruction_Call:
+        case Instruction_Return:
+        case Instruction_PushFrame:
+        case Instruction_JumpIfEqs:
+        case Instruction_JumpIfNeqs:
+        case Instruction_Break:
+            return false;
+        default:
+            return peephole_push(ctx, count, position + 1);
+    }
+}
+
+/// Whether the current value of the variable may be read on any path after the instruction at the position
+static bool peephole_is_read_after(Peephole* ctx, size_t position, const CodeOperand* var) {
+    if (++ctx->stamp == 0) {
+        memset(ctx->visited, 0, sizeof(uint32_t) * ctx->buf->size);
+        ctx->stamp = 1;
+    }
+
+    size_t count = 0;
+
+    if (!peephole_push_successors(ctx, &count, position)) {
+        return true;
+    }
+
+    while (count) {
+        size_t current = ctx->stack[--count];
+        const GeneratedInstruction* inst = &ctx->buf->buf[current];
+
+        if (instruction_reads(inst, var)) {
+            return true;
+        }
+
+        if (instruction_kills(inst, var)) {
+            continue;
+        }
+
+        if (!peephole_push_successors(ctx, &count, current)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/// Whether the instruction before the position is `DEFVAR` of the variable
+static bool peephole_defined_before(Peephole* ctx, size_t position, const CodeOperand* var) {
+    GeneratedInstruction* def = peephole_at(ctx, peephole_prev(ctx, position));
+    return def && def->inst == Instruction_DefVar && operand_equals(&def->operands[0], var);
+}
+
+/// Whether the instruction compares the variable with `bool@true` or `bool@false`, `value` is set to the constant
+static bool peephole_branches_on(Peephole* ctx, const GeneratedInstruction* inst, const CodeOperand* var,
+                                 bool* value) {
+    if (!inst || (inst->inst != Instruction_JumpIfEq && inst->inst != Instruction_JumpIfNeq)) {
+        return false;
+    }
+
+    for (int i = 1; i <= 2; i++) {
+        const CodeOperand* constant = &inst->operands[3 - i];
+
+        if (operand_equals(&inst->operands[i], var) && constant->kind == CodeOperand_Constant &&
+            (constant->text == ctx->bool_true || constant->text == ctx->bool_false)) {
+            *value = constant->text == ctx->bool_true;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * DEFVAR TF@t
+ * MOVE TF@t x
+ * ...
+ * OP ... TF@t ...
+ *
+ * The only read of the temporary reads `x` itself, the temporary is dropped.
+ */
+static bool rule_copy_propagation(Peephole* ctx, size_t position) {
+    GeneratedInstruction* move = &ctx->buf->buf[position];
+    CodeOperand* var = &move->operands[0];
+    CodeOperand* value = &move->operands[1];
+
+    if (move->inst != Instruction_Move || !operand_is_temporary(var) || operand_equals(var, value) ||
+        !peephole_defined_before(ctx, position, var)) {
+        return false;
+    }
+
+    size_t use = peephole_next(ctx, position);
+
+    for (; use < ctx->buf->size; use = peephole_next(ctx, use)) {
+        GeneratedInstruction* inst = &ctx->buf->buf[use];
+
+        if (instruction_reads(inst, var)) {
+            break;
+        }
+
+        if (instruction_mentions(inst, var) || instruction_leaves_block(inst->inst) ||
+            (instruction_writes_first(inst->inst) && operand_equals(&inst->operands[0], value))) {
+            return false;
+        }
+    }
+
+    GeneratedInstruction* inst = peephole_at(ctx, use);
+
+    // TYPE of an uninitialized variable is not an error, unlike the MOVE
+    if (!inst || inst->inst == Instruction_Type ||
+        (instruction_writes_first(inst->inst) && operand_equals(&inst->operands[0], var)) ||
+        peephole_is_read_after(ctx, use, var)) {
+        return false;
+    }
+
+    for (int i = 0; i < inst->operand_count; i++) {
+        if (operand_equals(&inst->operands[i], var)) {
+            inst->operands[i] = *value;
+        }
+    }
+
+    peephole_remove(ctx, peephole_prev(ctx, position));
+    peephole_remove(ctx, position);
+    return true;
+}
+
+/**
+ * DEFVAR TF@t
+ * OP TF@t a b
+ * MOVE x TF@t
+ *
+ * The result is stored to `x` right away: OP x a b
+ */
+static bool rule_store_result(Peephole* ctx, size_t position) {
+    GeneratedInstruction* op = &ctx->buf->buf[position];
+    CodeOperand* var = &op->operands[0];
+
+    if (!instruction_writes_first(op->inst) || op->inst == Instruction_DefVar || op->inst == Instruction_SetChar ||
+        !operand_is_temporary(var) || instruction_reads(op, var) || !peephole_defined_before(ctx, position, var)) {
+        return false;
+    }
+
+    size_t next = peephole_next(ctx, position);
+    GeneratedInstruction* move = peephole_at(ctx, next);
+
+    if (!move || move->inst != Instruction_Move || !operand_equals(&move->operands[1], var) ||
+        operand_equals(&move->operands[0], var) || peephole_is_read_after(ctx, next, var)) {
+        return false;
+    }
+
+    *var = move->operands[0];
+    peephole_remove(ctx, peephole_prev(ctx, position));
+    peephole_remove(ctx, next);
+    return true;
+}
+
+/**
+ * LT TF@t a b            GT TF@t a b
+ * DEFVAR TF@u        →   NOT TF@t TF@t
+ * EQ TF@u a b
+ * OR TF@t TF@t TF@u
+ *
+ * `a <= b` is `!(a > b)` and `a >= b` is `!(a < b)`, the types accepted by LT and GT are the same.
+ * @note The operands of the comparison are ordered, this does not hold for a `float` NaN.
+ */
+static bool rule_less_or_equal(Peephole* ctx, size_t position) {
+    GeneratedInstruction* cmp = &ctx->buf->buf[position];
+    CodeOperand* var = &cmp->operands[0];
+
+    if ((cmp->inst != Instruction_Lt && cmp->inst != Instruction_Gt) || !operand_is_temporary(var) ||
+        instruction_reads(cmp, var)) {
+        return false;
+    }
+
+    size_t def_position = peephole_next(ctx, position);
+    size_t eq_position = peephole_next(ctx, def_position);
+    size_t or_position = peephole_next(ctx, eq_position);
+    GeneratedInstruction* def = peephole_at(ctx, def_position);
+    GeneratedInstruction* eq = peephole_at(ctx, eq_position);
+    GeneratedInstruction* either = peephole_at(ctx, or_position);
+
+    if (!def || !eq || !either || def->inst != Instruction_DefVar || eq->inst != Instruction_Eq ||
+        either->inst != Instruction_Or) {
+        return false;
+    }
+
+    CodeOperand* other = &def->operands[0];
+
+    if (!operand_is_temporary(other) || operand_equals(other, var) || !operand_equals(&eq->operands[0], other) ||
+        !operand_equals(&eq->operands[1], &cmp->operands[1]) || !operand_equals(&eq->operands[2], &cmp->operands[2]) ||
+        !operand_equals(&either->operands[0], var) ||
+        !((operand_equals(&either->operands[1], var) && operand_equals(&either->operands[2], other)) ||
+          (operand_equals(&either->operands[1], other) && operand_equals(&either->operands[2], var))) ||
+        peephole_is_read_after(ctx, or_position, other)) {
+        return false;
+    }
+
+    cmp->inst = cmp->inst == Instruction_Lt ? Instruction_Gt : Instruction_Lt;
+    *def = (GeneratedInstruction){.inst = Instruction_Not, .operand_count = 2, .operands = {*var, *var}};
+    peephole_remove(ctx, eq_position);
+    peephole_remove(ctx, or_position);
+    return true;
+}
+
+/**
+ * EQ TF@t a b               EQ TF@t a b
+ * NOT TF@t TF@t         →   JUMPIFEQ label TF@t bool@true
+ * JUMPIFNEQ label TF@t bool@true
+ *
+ * The value is a `bool` of a comparison, so the branch is inverted instead.
+ */
+static bool rule_branch_on_not(Peephole* ctx, size_t position) {
+    GeneratedInstruction* negation = &ctx->buf->buf[position];
+    CodeOperand* var = &negation->operands[0];
+
+    if (negation->inst != Instruction_Not || !operand_is_temporary(var) || !operand_equals(&negation->operands[1], var)) {
+        return false;
+    }
+
+    GeneratedInstruction* cmp = peephole_at(ctx, peephole_prev(ctx, position));
+
+    if (!cmp || !operand_equals(&cmp->operands[0], var)) {
+        return false;
+    }
+
+    switch (cmp->inst) {
+        case Instruction_Lt:
+        case Instruction_Gt:
+        case Instruction_Eq:
+        case Instruction_And:
+        case Instruction_Or:
+        case Instruction_Not:
+            break;
+        default:
+            return false;
+    }
+
+    size_t next = peephole_next(ctx, position);
+    GeneratedInstruction* jump = peephole_at(ctx, next);
+    bool value;
+
+    if (!peephole_branches_on(ctx, jump, var, &value) || peephole_is_read_after(ctx, next, var)) {
+        return false;
+    }
+
+    jump->inst = jump->inst == Instruction_JumpIfEq ? Instruction_JumpIfNeq : Instruction_JumpIfEq;
+    peephole_remove(ctx, position);
+    return true;
+}
+
+/**
+ * DEFVAR TF@t
+ * EQ TF@t a b                              →   JUMPIFNEQ label a b
+ * JUMPIFNEQ label TF@t bool@true
+ *
+ * EQ and the conditional jumps accept the same types, so only the comparison of the jump is left.
+ */
+static bool rule_compare_and_branch(Peephole* ctx, size_t position) {
+    GeneratedInstruction* eq = &ctx->buf->buf[position];
+    CodeOperand* var = &eq->operands[0];
+
+    if (eq->inst != Instruction_Eq || !operand_is_temporary(var) || instruction_reads(eq, var) ||
+        !peephole_defined_before(ctx, position, var)) {
+        return false;
+    }
+
+    size_t next = peephole_next(ctx, position);
+    GeneratedInstruction* jump = peephole_at(ctx, next);
+    bool value;
+
+    if (!peephole_branches_on(ctx, jump, var, &value) || peephole_is_read_after(ctx, next, var)) {
+        return false;
+    }
+
+    if (!value) {
+        jump->inst = jump->inst == Instruction_JumpIfEq ? Instruction_JumpIfNeq : Instruction_JumpIfEq;
+    }
+
+    jump->operands[1] = eq->operands[1];
+    jump->operands[2] = eq->operands[2];
+    peephole_remove(ctx, peephole_prev(ctx, position));
+    peephole_remove(ctx, position);
+    return true;
+}
+
+/**
+ * JUMP label
+ * LABEL other        →   LABEL other
+ * LABEL label            LABEL label
+ */
+static bool rule_jump_to_next(Peephole* ctx, size_t position) {
+    GeneratedInstruction* jump = &ctx->buf->buf[position];
+
+    if (jump->inst != Instruction_Jump) {
+        return false;
+    }
+
+    for (size_t next = peephole_next(ctx, position); next < ctx->buf->size; next = peephole_next(ctx, next)) {
+        const GeneratedInstruction* label = &ctx->buf->buf[next];
+
+        if (label->inst != Instruction_Label) {
+            return false;
+        }
+
+        if (label->operands[0].text == jump->operands[0].text) {
+            peephole_remove(ctx, position);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/// Pattern table, every rule tries to rewrite the code starting at the position and tells whether it did
+static bool (*const c_rules[])(Peephole*, size_t) = {
+    rule_copy_propagation, rule_store_result, rule_less_or_equal, rule_branch_on_not, rule_compare_and_branch,
+    rule_jump_to_next,
+};
+
+/// Drop the removed instructions from the buffer
+static void peephole_compact(Peephole* ctx) {
+    size_t size = 0;
+
+    for (size_t i = 0; i < ctx->buf->size; i++) {
+        if (ctx->buf->buf[i].inst != PEEPHOLE_REMOVED) {
+            ctx->buf->buf[size++] = ctx->buf->buf[i];
+        }
+    }
+
+    ctx->buf->size = size;
+}
+
+size_t peephole_optimize(CodeBuf* buf) {
+    if (!buf || !buf->size) {
+        return 0;
+    }
+
+    Peephole ctx = {
+        .buf = buf,
+        .labels = malloc(sizeof(PeepholeLabel) * buf->size),
+        .visited = calloc(buf->size, sizeof(uint32_t)),
+        .stack = malloc(sizeof(size_t) * buf->size),
+        .bool_true = intern_add_c_str("bool@true"),
+        .bool_false = intern_add_c_str("bool@false"),
+    };
+
+    if (!ctx.labels || !ctx.visited || !ctx.stack || got_error()) {
+        set_error(Error_Internal);
+        eprint("peephole: Out Of Memory\n");
+        free(ctx.labels);
+        free(ctx.visited);
+        free(ctx.stack);
+        return 0;
+    }
+
+    bool changed = true;
+
+    while (changed) {
+        changed = false;
+        peephole_collect_labels(&ctx);
+
+        for (size_t i = 0; i < buf->size; i++) {
+            for (size_t rule = 0; rule < sizeof(c_rules) / sizeof(*c_rules); rule++) {
+                if (buf->buf[i].inst != PEEPHOLE_REMOVED && c_rules[rule](&ctx, i)) {
+                    changed = true;
+                }
+            }
+        }
+
+        peephole_compact(&ctx);
+    }
+
+    free(ctx.labels);
+    free(ctx.visited);
+    free(ctx.stack);
+    return ctx.removed;
+}
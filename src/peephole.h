@@ -0,0 +1,32 @@
+/**
+ * @note Project: Implementace překladače imperativního jazyka IFJ23
+ * @file peephole.h
+ * @author agent, agent, VUT FIT
+ * @date 16/10/2026
+ * @brief Peephole optimizer of the generated IFJcode23.
+ *
+ * The code generator loads every operand into its own temporary variable and moves every result through `TF@res`,
+ * the optimizer rewrites these short patterns in place before the code is written.
+ */
+
+#ifndef PEEPHOLE_H
+#define PEEPHOLE_H
+
+#include <stddef.h>
+#include "codegen.h"
+
+/**
+ * @brief Rewrite the patterns of the pattern table in the buffer until none of them matches anymore.
+ *
+ * Only the temporary variables which are not read later on any path are removed, so the behaviour of the program,
+ * including its runtime errors, stays the same. Jumps to labels outside of the buffer and frame changes are taken as
+ * reading every variable.
+ *
+ * Sets `Error_Internal` if out of memory, the buffer is then left unchanged.
+ *
+ * @param[in,out] buf The buffer to optimize.
+ * @return Number of removed instructions.
+ */
+size_t peephole_optimize(CodeBuf* buf);
+
+#endif
@@ -6,6 +6,7 @@
  * @date 23/11/2023
  */
 #include "rec_parser.h"
+#include <stdarg.h>
 #include "error.h"
 #include "expr_parser.h"
 #include "scanner.h"
@@ -14,7 +15,8 @@
 
 // Shorthand for checking if there was newline before the current token.
 #define HAS_EOL (g_parser.token_ws.type == Token_Whitespace && g_parser.token_ws.attribute.has_eol)
-#define TOK_ID_STR g_parser.token.attribute.data.value.string.data
+#define TOK_ID_STR string_data(&g_parser.token.attribute.data.value.string)
+#define TOK_ID_SYMBOL g_parser.token.symbol
 #define IS_NIL(data) ((data).type == DataType_Undefined && (data).is_nil)
 
 /* Forward declarations for rule functions, so that they can call each other without issues */
@@ -40,6 +42,33 @@ bool g_func_has_return;
 int g_while_index;
 int g_if_index;
 
+/// `GF@ret`, the exit code of the program
+static const Operand c_exit_code = {.variable = {.frame = Frame_Global, .name = {"ret", 3}}};
+/// `LF@ret`, the return value of the function
+static const Operand c_return_value = {.variable = {.frame = Frame_Local, .name = {"ret", 3}}};
+/// `TF@res`, the result of the last expression
+static const Operand c_expr_result = {
+    .symbol = {.type = SymbolType_Variable, .variable = {.frame = Frame_Temporary, .name = {"res", 3}}}};
+/// `bool@true`
+static const Operand c_true = {
+    .symbol = {.type = SymbolType_Constant, .constant = {.type = DataType_Bool, .value = {.is_true = true}}}};
+
+/// Generate the instruction with the label formatted by `fmt` as its first operand, the symbols follow it
+static void generate_with_label(Instruction inst, const Operand* symb1, const Operand* symb2, const char* fmt, ...) {
+    // labels are short enough to be stored inside of the String
+    String label;
+    string_init(&label);
+
+    va_list args;
+    va_start(args, fmt);
+    string_append_vfmt(&label, fmt, args);
+    va_end(args);
+
+    Operand op = operand_label(string_view(&label));
+    code_generation(inst, &op, symb1, symb2);
+    string_free(&label);
+}
+
 // Entry point to recursive parsing.
 bool rec_parser_begin() {
     g_current_func = NULL;
@@ -47,17 +76,27 @@ bool rec_parser_begin() {
     g_while_index = g_if_index = 0;
 
     code_buf_set(&g_parser.var_defs_code);
-    code_generation_raw(".IFJcode23");
-    code_generation_raw("DEFVAR GF@ret");
-    code_generation_raw("MOVE GF@ret int@0");
+    code_generation(Instruction_Start, NULL, NULL, NULL);
+    if (g_parser.streaming) {
+        // Functions are written before the global code, so the program has to jump over them.
+        Operand main_label = operand_label(strview_from_c_str("main%"));
+        code_generation(Instruction_Jump, &main_label, NULL, NULL);
+        parser_stream_code(&g_parser.var_defs_code);
+        code_generation(Instruction_Label, &main_label, NULL, NULL);
+    }
+    Operand zero = operand_symb_const((Data){.is_nil = false, .type = DataType_Int, .value = {.number = 0}});
+    code_generation(Instruction_DefVar, &c_exit_code, NULL, NULL);
+    code_generation(Instruction_Move, &c_exit_code, &zero, NULL);
     code_buf_set(&g_parser.global_code);
     g_parser.currect_code = &g_parser.global_code;
 
     parser_next_token();
     CALL_RULEp(rule_statementList);
 
-    code_generation_raw("LABEL exit");
-    code_generation_raw("EXIT GF@ret");
+    Operand exit_label = operand_label(strview_from_c_str("exit"));
+    Operand exit_code = operand_symb_var(Frame_Global, strview_from_c_str("ret"));
+    code_generation(Instruction_Label, &exit_label, NULL, NULL);
+    code_generation(Instruction_Exit, &exit_code, NULL, NULL);
     return true;
 }
 
@@ -190,10 +229,10 @@ bool assign_expr(VariableSymbol* var, const char* id_name) {
 
     // Code generation of MOVE or implicit conversion MOVE.
     Operand op1, op2;
-    op1.variable.name = var->code_name.data;
+    op1.variable.name = string_view(&var->code_name);
     op1.variable.frame = var->code_frame;
     op2.symbol.type = SymbolType_Variable;
-    op2.symbol.variable.name = "res";
+    op2.symbol.variable.name = strview_from_c_str("res");
     op2.symbol.variable.frame = Frame_Temporary;
     if (impl_conv != 0) {
         code_generation(impl_conv == 1 ? Instruction_Float2Int : Instruction_Int2Float, &op1, &op2, NULL);
@@ -241,7 +280,7 @@ bool handle_let_statement() {
 
         // Define the variable in IFJcode23
         Operand ifj_var;
-        ifj_var.variable.name = var.code_name.data;
+        ifj_var.variable.name = string_view(&var.code_name);
         ifj_var.variable.frame = var.code_frame;
         code_buf_set(defs_buf);
         code_generation(Instruction_DefVar, &ifj_var, NULL, NULL);
@@ -286,7 +325,7 @@ bool handle_var_statement() {
     TRY_BEGIN {
         // Define the variable in IFJcode23
         Operand ifj_op;
-        ifj_op.variable.name = var.code_name.data;
+        ifj_op.variable.name = string_view(&var.code_name);
         ifj_op.variable.frame = var.code_frame;
         code_buf_set(defs_buf);
         code_generation(Instruction_DefVar, &ifj_op, NULL, NULL);
@@ -336,15 +375,16 @@ bool handle_func_statement() {
         var.type = func->params[i].type;
         var.is_initialized = true;
         var.allow_modification = true;
-        string_concat_c_str(&var.code_name, func->params[i].code_name.data);
+        // The function outlives the scope of its body, so the variable only borrows the name of the parameter
+        var.code_name = string_borrow(string_data(&func->params[i].code_name), func->params[i].code_name.length);
         var.code_frame = Frame_Local;
-        symtable_insert_variable(symstack_top(), func->params[i].iname.data, var);
+        symtable_insert_variable(symstack_top(), string_data(&func->params[i].iname), var);
     }
     parser_scope_function(func);
 
     code_buf_set(&func->code_defs);
     // Generate label indentifying this function.
-    Operand op = {.label = func->code_name.data};
+    Operand op = {.label = string_view(&func->code_name)};
     code_generation(Instruction_Label, &op, NULL, NULL);
     // We get parameters on the temporary frame, so we need to convert it to local frame,
     // to get them as local variables.
@@ -363,9 +403,13 @@ bool handle_func_statement() {
         return false;
     }
 
-    code_generation_raw("LABEL %s_end", func->code_name.data);
+    generate_with_label(Instruction_Label, NULL, NULL, "%s_end", string_data(&func->code_name));
     code_generation(Instruction_PopFrame, NULL, NULL, NULL);
     code_generation(Instruction_Return, NULL, NULL, NULL);
+    if (g_parser.streaming) {
+        parser_stream_code(&func->code_defs);
+        parser_stream_code(&func->code);
+    }
     parser_scope_global();
     symstack_pop();
 
@@ -376,7 +420,7 @@ bool handle_func_statement() {
 
 bool handle_while_statement() {
     g_while_index++;  // Increment while counter to get unique while id.
-    code_generation_raw("LABEL while%i_begin", g_while_index);
+    generate_with_label(Instruction_Label, NULL, NULL, "while%i_begin", g_while_index);
 
     Data expr_data;
     CALL_RULEp(expr_parser_begin, &expr_data);
@@ -388,7 +432,7 @@ bool handle_while_statement() {
     }
 
     // Generate code for checking the while result and jumping if necessary.
-    code_generation_raw("JUMPIFNEQ while%i_end TF@res bool@true", g_while_index);
+    generate_with_label(Instruction_JumpIfNeq, &c_expr_result, &c_true, "while%i_end", g_while_index);
 
     CHECK_TOKEN(Token_BracketLeft, "Unexpected token `%s` after the while clause. Expected `{`.", TOK_STR);
 
@@ -397,9 +441,9 @@ bool handle_while_statement() {
     symstack_pop();
 
     // Jump to beginning of the while to check the condition.
-    code_generation_raw("JUMP while%i_begin", g_while_index);
+    generate_with_label(Instruction_Jump, NULL, NULL, "while%i_begin", g_while_index);
     // Label for code after this while statement.
-    code_generation_raw("LABEL while%i_end", g_while_index);
+    generate_with_label(Instruction_Label, NULL, NULL, "while%i_end", g_while_index);
 
     CHECK_TOKEN(Token_BracketRight, "Unexpected token `%s` at the end of while statement. Expected `}`.", TOK_STR);
     CALL_RULE(rule_statementList);
@@ -409,8 +453,9 @@ bool handle_while_statement() {
 // Handle the loose `ID = <expr>` or `ID()` statements.
 bool handle_id_statement() {
     const char* id_name = TOK_ID_STR;
+    SymbolId id_symbol = TOK_ID_SYMBOL;
     // If ID is a function in the global symtable, then we switch to precedence analysis.
-    if (symtable_get_function(symstack_bottom(), id_name)) {
+    if (symtable_get_function_by_id(symstack_bottom(), id_symbol)) {
         Data expr_data;
         return expr_parser_begin(&expr_data);
     }
@@ -421,7 +466,7 @@ bool handle_id_statement() {
 
     // Search symstack for variable with this name.
     VariableSymbol* var;
-    if ((var = symstack_search_variable(id_name)) == NULL) {
+    if ((var = symstack_search_variable_by_id(id_symbol)) == NULL) {
         undef_var_err("Symbol `" COL_Y("%s") "` is undefined.", id_name);
         return false;
     }
@@ -506,14 +551,14 @@ bool rule_returnExpr() {
             }
 
             // Create a return value variable and move `<expr>` result into it.
-            code_generation_raw("DEFVAR LF@ret");
-            code_generation_raw("MOVE LF@ret TF@res");
+            code_generation(Instruction_DefVar, &c_return_value, NULL, NULL);
+            code_generation(Instruction_Move, &c_return_value, &c_expr_result, NULL);
 
             g_func_has_return = true;
             break;
         }
     }
-    code_generation_raw("JUMP %s_end", func->code_name.data);
+    generate_with_label(Instruction_Jump, NULL, NULL, "%s_end", string_data(&func->code_name));
     return true;
 }
 
@@ -540,7 +585,7 @@ bool rule_ifStatement(int if_num, int after_num) {
     CALL_RULE(rule_statementList);
     CHECK_TOKEN(Token_BracketRight,
                 "Unexpected token `%s` after statement list at the end of `if` statement. Expected `}`.", TOK_STR);
-    code_generation_raw("JUMP if%i_end", if_num);
+    generate_with_label(Instruction_Jump, NULL, NULL, "if%i_end", if_num);
     symstack_pop();
     CALL_RULEp(rule_else, if_num, after_num);
     return true;
@@ -549,10 +594,11 @@ bool rule_ifStatement(int if_num, int after_num) {
 bool rule_ifCondition(bool is_let, int if_num, int after_num) {
     if (is_let) {
         const char* id_name = TOK_ID_STR;
+        SymbolId id_symbol = TOK_ID_SYMBOL;
         CHECK_TOKEN(Token_Identifier, "Unexpected token `" COL_Y("%s") "` in if-let statement. Expected indentifier.");
 
         // Check if identifier is non-modifiable variable --> otherwise error 7 (expr_type_err)
-        VariableSymbol* var = symstack_search_variable(id_name);
+        VariableSymbol* var = symstack_search_variable_by_id(id_symbol);
         if (!var || !var->is_initialized) {
             undef_var_err("Variable `" COL_Y("%s") "` is not %s.", id_name, var ? "initialized" : "defined");
             return false;
@@ -563,8 +609,9 @@ bool rule_ifCondition(bool is_let, int if_num, int after_num) {
 
         // Checking the `nil` value of var. If it is `nil`,
         // then we need to jump after this if statement.
-        code_generation_raw("JUMPIFEQ if%i_after%i %s@%s nil@nil", if_num, after_num, frame_to_string(var->code_frame),
-                            var->code_name.data);
+        Operand symb = operand_symb_var(var->code_frame, string_view(&var->code_name));
+        Operand nil = operand_symb_const((Data){.is_nil = true, .type = DataType_Undefined});
+        generate_with_label(Instruction_JumpIfEq, &symb, &nil, "if%i_after%i", if_num, after_num);
 
         // Either way, we need to add non-maybe type to symtable, because we need to reference
         // the correct variables in the if statement.
@@ -575,7 +622,8 @@ bool rule_ifCondition(bool is_let, int if_num, int after_num) {
             new_var.allow_modification = var->allow_modification;
             new_var.type = maybe_to_normal(var->type);
             // We just reference the original variable, but this time we semantically treat it as without Maybe type.
-            string_concat_c_str(&new_var.code_name, var->code_name.data);
+            // The original variable outlives the scope of the if statement, so its name is only borrowed.
+            new_var.code_name = string_borrow(string_data(&var->code_name), var->code_name.length);
             new_var.code_frame = var->code_frame;
             symtable_insert_variable(symstack_top(), id_name, new_var);
         }  // NOTE: If variable is already of normal type, then we don't need to duplicate it.
@@ -589,13 +637,13 @@ bool rule_ifCondition(bool is_let, int if_num, int after_num) {
         }
 
         // Add code for checking the expression result and jumping if needed.
-        code_generation_raw("JUMPIFNEQ if%i_after%i TF@res bool@true", if_num, after_num);
+        generate_with_label(Instruction_JumpIfNeq, &c_expr_result, &c_true, "if%i_after%i", if_num, after_num);
     }
     return true;
 }
 
 bool rule_else(int if_num, int after_num) {
-    code_generation_raw("LABEL if%i_after%i", if_num, after_num++);
+    generate_with_label(Instruction_Label, NULL, NULL, "if%i_after%i", if_num, after_num++);
     switch (g_parser.token.type) {
         case Token_EOF:
         case Token_BracketRight:
@@ -606,14 +654,14 @@ bool rule_else(int if_num, int after_num) {
         case Token_Func:
         case Token_Return:
         case Token_Identifier:
-            code_generation_raw("LABEL if%i_end", if_num);
+            generate_with_label(Instruction_Label, NULL, NULL, "if%i_end", if_num);
             return rule_statementList();  // For the statemens right after '}' on the same line.
         case Token_Else:
             parser_next_token();
             return rule_elseIf(if_num, after_num);
         default:
             if (HAS_EOL) {
-                code_generation_raw("LABEL if%i_end", if_num);
+                generate_with_label(Instruction_Label, NULL, NULL, "if%i_end", if_num);
                 return rule_statementList();
             }
             syntax_err("Unexpected token `%s`. Expected `else` or end of statement.", TOK_STR);
@@ -632,7 +680,7 @@ bool rule_elseIf(int if_num, int after_num) {
             symstack_pop();
 
             CHECK_TOKEN(Token_BracketRight, "Unexpected token `%s` at the end of else clause. Expected `}`.", TOK_STR);
-            code_generation_raw("LABEL if%i_end", if_num);
+            generate_with_label(Instruction_Label, NULL, NULL, "if%i_end", if_num);
             return rule_statementList();
         case Token_If:
             parser_next_token();
@@ -688,7 +736,7 @@ bool rule_assignExpr(VariableSymbol* var, const char* id_name) {
     if ((var->is_initialized = is_maybe_datatype(var->type))) {
         // Initialize the variable to `nil`.
         Operand op1, op2;
-        op1.variable.name = var->code_name.data;
+        op1.variable.name = string_view(&var->code_name);
         op1.variable.frame = var->code_frame;
         op2.symbol.type = SymbolType_Constant;
         op2.symbol.constant.type = DataType_Undefined;
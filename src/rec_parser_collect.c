@@ -40,7 +40,7 @@ bool col_handle_func_statement() {
     TokenAttribute attr = g_parser.token.attribute;
     CHECK_TOKEN(Token_Identifier, "Unexpected token `%s` after the `func` keyword. Expected name of the function.",
                 TOK_STR);
-    const char* func_name = attr.data.value.string.data;
+    const char* func_name = string_data(&attr.data.value.string);
 
     FunctionSymbol func;
     function_symbol_init(&func);
@@ -80,15 +80,15 @@ bool col_rule_params(FunctionSymbol* func) {
         case Token_ParenRight:
             return true;
         case Token_Identifier: {
-            const char* oname = g_parser.token.attribute.data.value.string.data;
-            if (strcmp(oname, "_") == 0)
-                oname = NULL;
+            // `_` is kept for the error messages, the parameter itself has no name
+            StrView oname_text = string_view(&g_parser.token.attribute.data.value.string);
+            StrView oname = strview_equals_c_str(oname_text, "_") ? strview_from_c_str(NULL) : oname_text;
             parser_next_token();
 
             TokenAttribute attr = g_parser.token.attribute;
             CHECK_TOKEN(Token_Identifier, "Unexpected token `%s` after the parameter name. Expected identifier.",
                         TOK_STR);
-            const char* iname = attr.data.value.string.data;
+            StrView iname = string_view(&attr.data.value.string);
 
             CHECK_TOKEN(Token_DoubleColon, "Unexpected token `%s` after inner parameter name. Expected `,` or `)`.",
                         TOK_STR);
@@ -101,9 +101,10 @@ bool col_rule_params(FunctionSymbol* func) {
             int has_param;
             if ((has_param = funciton_symbol_has_param(func, oname, iname)) != 0) {
                 print_error(&g_parser.token, Error_Semantic, "Semantic",
-                            "Conflicting names for parameter `%s%s" PRINT_RESET " %s%s" PRINT_RESET " : %s`.",
-                            has_param == 1 ? PRINT_Y : PRINT_W, oname, has_param == 2 ? PRINT_Y : PRINT_W, iname,
-                            datatype_to_string(param_type));
+                            "Conflicting names for parameter `%s" STRVIEW_FMT PRINT_RESET " %s" STRVIEW_FMT PRINT_RESET
+                            " : %s`.",
+                            has_param == 1 ? PRINT_Y : PRINT_W, STRVIEW_ARG(oname_text),
+                            has_param == 2 ? PRINT_Y : PRINT_W, STRVIEW_ARG(iname), datatype_to_string(param_type));
                 return false;
             }
 
@@ -6,69 +6,643 @@
  * @brief Implementation for the scanner.h
  */
 
-#include <limits.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
+#include "arena.h"
 #include "error.h"
 #include "scanner.h"
+#include "scanner_number.h"
+#include "scanner_skip.h"
 
-char* KEYWORD[] = {"if", "else", "let", "var", "while", "func", "return", NULL};
-TokenType KEYWORD_TYPE[] = {Token_If, Token_Else, Token_Let, Token_Var, Token_While, Token_Func, Token_Return};
+/**
+ * Perfect hash of the reserved words (keywords, data types and literals) computed from the length
+ * and the first and the last byte of the word. Every reserved word has its own slot, a collision would
+ * be reported by the compiler as an overridden initializer.
+ */
+#define RESERVED_HASH(length, first, last) ((((length) << 2) + (first) + (last)) & 63)
+
+typedef struct {
+    const char* word;
+    size_t length;
+    /// Type of the token, empty slots have zero `length`
+    TokenType type;
+    /// Data type of `Token_DataType` or type of the literal
+    DataType data_type;
+    /// Optional variant of `data_type`
+    DataType optional_data_type;
+    bool is_nil;
+    bool is_true;
+} ReservedWord;
+
+#define RESERVED(str, first, last, ...) \
+    [RESERVED_HASH(sizeof(str) - 1, first, last)] = {.word = str, .length = sizeof(str) - 1, __VA_ARGS__}
+
+// clang-format off
+static const ReservedWord RESERVED_WORDS[64] = {
+    RESERVED("if", 'i', 'f', .type = Token_If),
+    RESERVED("else", 'e', 'e', .type = Token_Else),
+    RESERVED("let", 'l', 't', .type = Token_Let),
+    RESERVED("var", 'v', 'r', .type = Token_Var),
+    RESERVED("while", 'w', 'e', .type = Token_While),
+    RESERVED("func", 'f', 'c', .type = Token_Func),
+    RESERVED("return", 'r', 'n', .type = Token_Return),
+    RESERVED("Int", 'I', 't', .type = Token_DataType, .data_type = DataType_Int,
+             .optional_data_type = DataType_MaybeInt),
+    RESERVED("Double", 'D', 'e', .type = Token_DataType, .data_type = DataType_Double,
+             .optional_data_type = DataType_MaybeDouble),
+    RESERVED("String", 'S', 'g', .type = Token_DataType, .data_type = DataType_String,
+             .optional_data_type = DataType_MaybeString),
+    RESERVED("Bool", 'B', 'l', .type = Token_DataType, .data_type = DataType_Bool,
+             .optional_data_type = DataType_MaybeBool),
+    RESERVED("true", 't', 'e', .type = Token_Data, .data_type = DataType_Bool, .is_true = true),
+    RESERVED("false", 'f', 'e', .type = Token_Data, .data_type = DataType_Bool, .is_true = false),
+    RESERVED("nil", 'n', 'l', .type = Token_Data, .is_nil = true),
+};
+// clang-format on
+
+#undef RESERVED
+
+/// Find the reserved word with a single probe into `RESERVED_WORDS`, return NULL for plain identifiers.
+static const ReservedWord* find_reserved_word(const String* str) {
+    /// The shortest reserved word is `if`
+    if (str->length < 2) {
+        return NULL;
+    }
+
+    unsigned char first = string_data(str)[0];
+    unsigned char last = string_data(str)[str->length - 1];
+    const ReservedWord* reserved = &RESERVED_WORDS[RESERVED_HASH(str->length, first, last)];
+
+    if (reserved->length != str->length || memcmp(reserved->word, string_data(str), str->length) != 0) {
+        return NULL;
+    }
+
+    return reserved;
+}
+
+/**
+ * Offsets of the line starts of the input, used to compute the line and the column of a token from its offset.
+ * Positions are needed only for diagnostics, so it is built on the first use by a single pass over the input.
+ */
+typedef struct {
+    size_t* starts;
+    size_t count;
+    /// Line of the last lookup, positions are mostly looked up in order
+    size_t hint;
+} LineIndex;
+
+static void line_index_free(LineIndex* index) {
+    free(index->starts);
+    index->starts = NULL;
+    index->count = 0;
+    index->hint = 0;
+}
+
+static bool line_index_build(LineIndex* index, const char* data, size_t length) {
+    size_t count = 1;
+
+    for (const char* ch = data; (ch = memchr(ch, '\n', data + length - ch)); ch++) {
+        count++;
+    }
+
+    index->starts = malloc(sizeof(size_t) * count);
+
+    if (!index->starts) {
+        set_error(Error_Internal);
+        eprint("Out Of Memory\n");
+        return false;
+    }
+
+    index->starts[0] = 0;
+    index->count = 1;
+    index->hint = 0;
+
+    for (const char* ch = data; (ch = memchr(ch, '\n', data + length - ch)); ch++) {
+        index->starts[index->count++] = ch - data + 1;
+    }
+
+    return true;
+}
+
+/// Find the 1-based line of `offset` and the number of bytes before it on the same line
+static void line_index_find(LineIndex* index, size_t offset, size_t* line, size_t* column) {
+    size_t idx = index->hint;
+
+    if (idx + 1 < index->count && index->starts[idx + 1] <= offset) {
+        idx++;
+    }
+
+    /// Neither the line of the last lookup nor the next one, binary search for the last line starting before `offset`
+    if (index->starts[idx] > offset || (idx + 1 < index->count && index->starts[idx + 1] <= offset)) {
+        size_t low = 0;
+        size_t high = index->count;
+
+        while (low + 1 < high) {
+            size_t mid = low + (high - low) / 2;
+
+            if (index->starts[mid] <= offset) {
+                low = mid;
+            } else {
+                high = mid;
+            }
+        }
+
+        idx = low;
+    }
+
+    index->hint = idx;
+    *line = idx + 1;
+    *column = offset - index->starts[idx];
+}
+
+/// Line of a block string literal
+typedef struct {
+    /// Offset of the first byte of the line in the literal
+    size_t start;
+    /// Offset of the first byte after the indentation of the line
+    size_t indent_end;
+} BlockLine;
+
+typedef struct {
+    BlockLine* lines;
+    size_t count;
+    size_t capacity;
+} BlockLines;
+
+static void block_lines_free(BlockLines* lines) {
+    free(lines->lines);
+    *lines = (BlockLines){0};
+}
+
+static bool block_lines_push(BlockLines* lines, BlockLine line) {
+    if (lines->count == lines->capacity) {
+        size_t capacity = lines->capacity ? lines->capacity * 2 : 16;
+        BlockLine* new = realloc(lines->lines, sizeof(BlockLine) * capacity);
+
+        if (!new) {
+            set_error(Error_Internal);
+            eprint("Out Of Memory\n");
+            return false;
+        }
 
-char* DATA_TYPE_IDENTIFIER[] = {"Int", "Double", "String", "Bool", NULL};
-DataType DATA_TYPE[] = {DataType_Int, DataType_Double, DataType_String, DataType_Bool};
-DataType OPTIONAL_DATA_TYPE[] = {DataType_MaybeInt, DataType_MaybeDouble, DataType_MaybeString, DataType_MaybeBool};
+        lines->lines = new;
+        lines->capacity = capacity;
+    }
+
+    lines->lines[lines->count++] = line;
+    return true;
+}
 
+/// Number of tokens in the first chunk of the token list, has to be a power of 2
+#define TOKEN_CHUNK_FIRST 256u
+/// Chunk `k` holds `TOKEN_CHUNK_FIRST << k` tokens, 24 chunks are enough for every `unsigned` index
+#define TOKEN_CHUNK_COUNT 24
+
+/// Columns of a chunk of packed tokens
 typedef struct {
-    Token* tokens;
-    unsigned capacity;
+    uint8_t* types;
+    /// Meaning depends on the type: symbol ID, operator, data type, has_eol or index of the literal
+    uint32_t* payloads;
+    /// Offset of the byte that ended the token in the input, as in `Token::offset`
+    uint32_t* offsets;
+} TokenChunk;
+
+/**
+ * Tokens are stored packed as columns of a 1-byte type, a 4-byte payload and a 4-byte source offset, which is
+ * 9 bytes instead of `sizeof(Token)`. Literals are kept in a side table, identifiers by their symbol ID and
+ * the line and the column are computed from the offset when the token is read.
+ *
+ * Both the tokens and the literals are stored in chunks that double in size, so nothing is ever moved and
+ * pushing never copies what is already in the list. The chunks and the payloads of string literals live in
+ * a single arena.
+ */
+typedef struct {
+    TokenChunk chunks[TOKEN_CHUNK_COUNT];
+    unsigned chunk_count;
     unsigned len;
+    Data* literals[TOKEN_CHUNK_COUNT];
+    unsigned literal_chunk_count;
+    unsigned literal_count;
+    Arena arena;
 } TokenList;
 
-const int c_chunk = 10;
-
 static void tokenlist_init(TokenList* list) {
-    list->tokens = malloc(sizeof(Token) * c_chunk);
-    list->capacity = c_chunk;
+    list->chunk_count = 0;
     list->len = 0;
+    list->literal_chunk_count = 0;
+    list->literal_count = 0;
+    arena_init(&list->arena);
+}
+
+static void tokenlist_free(TokenList* list) {
+    arena_free(&list->arena);
+    list->chunk_count = 0;
+    list->len = 0;
+    list->literal_chunk_count = 0;
+    list->literal_count = 0;
+}
+
+/// Find the chunk of the item at `idx` and the index of the item inside of the chunk
+static unsigned tokenlist_chunk(unsigned idx, unsigned* offset) {
+    unsigned chunk = 31 - __builtin_clz(idx / TOKEN_CHUNK_FIRST + 1);
+    *offset = idx - TOKEN_CHUNK_FIRST * ((1u << chunk) - 1);
+    return chunk;
+}
 
-    if (!list->tokens) {
+/// Check that the chunk `chunk` can still be allocated
+static bool tokenlist_check_chunk(unsigned chunk) {
+    if (chunk == TOKEN_CHUNK_COUNT) {
         set_error(Error_Internal);
-        eprint("Out Of Memory\n");
+        eprint("Too many tokens\n");
+        return false;
     }
+
+    return true;
 }
 
-static void tokenlist_free(TokenList* list) {
-    for (unsigned i = 0; i < list->len; i++) {
-        Token token = list->tokens[i];
-        bool is_string = token.type == Token_Identifier ||
-                         (token.type == Token_Data && token.attribute.data.type == DataType_String);
+static Data* tokenlist_literal(TokenList* list, uint32_t idx) {
+    unsigned offset;
+    unsigned chunk = tokenlist_chunk(idx, &offset);
+    return &list->literals[chunk][offset];
+}
+
+static Token tokenlist_get(TokenList* list, unsigned idx) {
+    unsigned offset;
+    TokenChunk* chunk = &list->chunks[tokenlist_chunk(idx, &offset)];
+    uint32_t payload = chunk->payloads[offset];
+    Token token = {0};
+
+    token.type = chunk->types[offset];
+    token.offset = chunk->offsets[offset];
+
+    switch (token.type) {
+        case Token_Identifier:
+            token.symbol = payload;
+            token.attribute.data.value.string = intern_view(payload);
+            break;
+        case Token_Data:
+            token.attribute.data = *tokenlist_literal(list, payload);
+            break;
+        case Token_Operator:
+            token.attribute.op = payload;
+            break;
+        case Token_DataType:
+            token.attribute.data_type = payload;
+            break;
+        case Token_Whitespace:
+            token.attribute.has_eol = payload;
+            break;
+        default:
+            break;
+    }
+
+    return token;
+}
+
+static bool tokenlist_push_literal(TokenList* list, Data data, uint32_t* idx) {
+    unsigned offset;
+    unsigned chunk = tokenlist_chunk(list->literal_count, &offset);
 
-        if (is_string) {
-            string_free(&token.attribute.data.value.string);
+    if (chunk == list->literal_chunk_count) {
+        if (!tokenlist_check_chunk(chunk)) {
+            return false;
         }
+
+        list->literals[chunk] = arena_alloc(&list->arena, sizeof(Data) * (TOKEN_CHUNK_FIRST << chunk));
+
+        if (!list->literals[chunk]) {
+            return false;
+        }
+
+        list->literal_chunk_count++;
     }
 
-    free(list->tokens);
-    list->tokens = NULL;
+    list->literals[chunk][offset] = data;
+    *idx = list->literal_count++;
+    return true;
+}
+
+/// Append a token whose payload is already packed
+static void tokenlist_push_packed(TokenList* list, uint8_t type, uint32_t payload, size_t source_offset) {
+    unsigned offset;
+    unsigned chunk = tokenlist_chunk(list->len, &offset);
+
+    if (source_offset > UINT32_MAX) {
+        set_error(Error_Internal);
+        eprint("Input is too big to retain its tokens, use the streaming mode\n");
+        return;
+    }
+
+    if (chunk == list->chunk_count) {
+        if (!tokenlist_check_chunk(chunk)) {
+            return;
+        }
+
+        size_t count = TOKEN_CHUNK_FIRST << chunk;
+        TokenChunk* new_chunk = &list->chunks[chunk];
+        new_chunk->payloads = arena_alloc(&list->arena, count * (sizeof(uint32_t) * 2 + sizeof(uint8_t)));
+
+        if (!new_chunk->payloads) {
+            return;
+        }
+
+        new_chunk->offsets = new_chunk->payloads + count;
+        new_chunk->types = (uint8_t*)(new_chunk->offsets + count);
+        list->chunk_count++;
+    }
+
+    TokenChunk* current = &list->chunks[chunk];
+    current->types[offset] = type;
+    current->payloads[offset] = payload;
+    current->offsets[offset] = source_offset;
+    list->len++;
 }
 
 static void tokenlist_push(TokenList* list, Token token) {
-    if (list->len == list->capacity) {
-        Token* tmp = realloc(list->tokens, sizeof(Token) * (list->capacity + c_chunk));
-        if (!tmp) {
-            set_error(Error_Internal);
-            eprint("Out Of Memory\n");
+    uint32_t payload = 0;
+
+    switch (token.type) {
+        case Token_Identifier:
+            payload = token.symbol;
+            break;
+        case Token_Data:
+            if (!tokenlist_push_literal(list, token.attribute.data, &payload)) {
+                return;
+            }
+            break;
+        case Token_Operator:
+            payload = token.attribute.op;
+            break;
+        case Token_DataType:
+            payload = token.attribute.data_type;
+            break;
+        case Token_Whitespace:
+            payload = token.attribute.has_eol;
+            break;
+        default:
+            break;
+    }
+
+    tokenlist_push_packed(list, token.type, payload, token.offset);
+}
+
+/// Copy the payload of a string literal into the arena of the token list
+static String tokenlist_store_string(TokenList* list, const String* str) {
+    String stored;
+    string_init(&stored);
+
+    /// Empty literals are kept without data, the same way as `string_take` of an empty string
+    if (str->length) {
+        const char* data = arena_strndup(&list->arena, string_data(str), str->length);
+        stored = string_borrow(data, data ? str->length : 0);
+    }
+
+    return stored;
+}
+
+/// Merge a whitespace token that starts a part scanned from `start` into the whitespace token ending the list
+static bool tokenlist_merge_whitespace(TokenList* list, uint32_t has_eol, uint32_t source_offset, size_t start) {
+    if (!list->len) {
+        return false;
+    }
+
+    unsigned offset;
+    TokenChunk* chunk = &list->chunks[tokenlist_chunk(list->len - 1, &offset)];
+
+    if (chunk->types[offset] != Token_Whitespace) {
+        return false;
+    }
+
+    chunk->payloads[offset] |= has_eol;
+
+    /// The first run of the whitespace ended only because the previous part did, the serial scanner continues it
+    if (chunk->offsets[offset] == start) {
+        chunk->offsets[offset] = source_offset;
+    }
+
+    return true;
+}
+
+/**
+ * Append the tokens of a part of the input scanned from `start` by a worker thread. Identifiers of the part hold
+ * the index of their name among its literals and are interned here in order, so they get the same symbol IDs as
+ * in a serial scan. The end of the part is not the end of the input, so its EOF token is dropped. The memory of
+ * the part is taken over by the list.
+ */
+static void tokenlist_join(TokenList* list, TokenList* part, size_t start) {
+    for (unsigned idx = 0; idx < part->len && !got_error(); idx++) {
+        unsigned offset;
+        TokenChunk* chunk = &part->chunks[tokenlist_chunk(idx, &offset)];
+        uint8_t type = chunk->types[offset];
+        uint32_t payload = chunk->payloads[offset];
+        uint32_t source_offset = chunk->offsets[offset];
+
+        if (type == Token_EOF) {
+            continue;
+        }
+
+        if (type == Token_Identifier) {
+            String name = tokenlist_literal(part, payload)->value.string;
+            payload = intern_add(string_data(&name), name.length);
+        } else if (type == Token_Data && !tokenlist_push_literal(list, *tokenlist_literal(part, payload), &payload)) {
+            return;
+        } else if (type == Token_Whitespace && !idx && tokenlist_merge_whitespace(list, payload, source_offset, start)) {
+            continue;
+        }
+
+        tokenlist_push_packed(list, type, payload, source_offset);
+    }
+
+    arena_adopt(&list->arena, &part->arena);
+}
+
+/// Chunk holding the token at `idx`, `offset` is set to the index of the token inside of it
+static TokenChunk* tokenlist_slot(TokenList* list, unsigned idx, unsigned* offset) {
+    return &list->chunks[tokenlist_chunk(idx, offset)];
+}
+
+/// Index of the first token from `first` on whose offset is at least `source_offset`, the offsets never decrease
+static unsigned tokenlist_lower_bound(TokenList* list, unsigned first, uint32_t source_offset) {
+    unsigned low = first;
+    unsigned high = list->len;
+
+    while (low < high) {
+        unsigned mid = low + (high - low) / 2;
+        unsigned offset;
+        TokenChunk* chunk = tokenlist_slot(list, mid, &offset);
+
+        if (chunk->offsets[offset] < source_offset) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+/// Move the token at `from` to `to`, its offset is moved by `delta`
+static void tokenlist_move(TokenList* list, unsigned from, unsigned to, ptrdiff_t delta) {
+    unsigned src_offset, dst_offset;
+    TokenChunk* src = tokenlist_slot(list, from, &src_offset);
+    TokenChunk* dst = tokenlist_slot(list, to, &dst_offset);
+
+    dst->types[dst_offset] = src->types[src_offset];
+    dst->payloads[dst_offset] = src->payloads[src_offset];
+    dst->offsets[dst_offset] = (uint32_t)(src->offsets[src_offset] + delta);
+}
+
+/**
+ * Replace `removed` tokens starting at `first` by the tokens of `fresh`. The tokens after them are moved in place
+ * and their offsets by `delta`, the tokens before them are not touched at all. The memory of `fresh` is taken over
+ * by the list.
+ */
+static void tokenlist_splice(TokenList* list, unsigned first, unsigned removed, TokenList* fresh, ptrdiff_t delta) {
+    unsigned len = list->len;
+    unsigned tail = first + removed;
+    unsigned new_tail = first + fresh->len;
+
+    /// Room for the additional tokens, filled by the moved ones
+    while (list->len < len - removed + fresh->len) {
+        tokenlist_push_packed(list, Token_EOF, 0, 0);
+
+        if (got_error()) {
             return;
         }
+    }
+
+    if (new_tail > tail) {
+        for (unsigned idx = len; idx-- > tail;) {
+            tokenlist_move(list, idx, idx + (new_tail - tail), delta);
+        }
+    } else {
+        for (unsigned idx = tail; idx < len; idx++) {
+            tokenlist_move(list, idx, idx - (tail - new_tail), delta);
+        }
+    }
+
+    list->len = len - removed + fresh->len;
+
+    for (unsigned idx = 0; idx < fresh->len; idx++) {
+        unsigned offset, dst_offset;
+        TokenChunk* src = tokenlist_slot(fresh, idx, &offset);
+        TokenChunk* dst = tokenlist_slot(list, first + idx, &dst_offset);
+        uint32_t payload = src->payloads[offset];
+
+        if (src->types[offset] == Token_Data && !tokenlist_push_literal(list, *tokenlist_literal(fresh, payload), &payload)) {
+            return;
+        }
+
+        dst->types[dst_offset] = src->types[offset];
+        dst->payloads[dst_offset] = payload;
+        dst->offsets[dst_offset] = src->offsets[offset];
+    }
+
+    arena_adopt(&list->arena, &fresh->arena);
+}
+
+/**
+ * String literals without escapes borrow the input, point them from `old_data` to the same bytes in `data`. Those
+ * after the `removed` bytes at `offset` are moved by `delta`, those inside of them belong to the replaced tokens.
+ */
+static void tokenlist_rebase_spans(TokenList* list, const char* old_data, size_t old_length, const char* data,
+                                   size_t offset, size_t removed, ptrdiff_t delta) {
+    for (unsigned idx = 0; idx < list->literal_count; idx++) {
+        Data* literal = tokenlist_literal(list, idx);
+
+        if (literal->type != DataType_String || literal->is_nil) {
+            continue;
+        }
+
+        String* str = &literal->value.string;
+        uintptr_t start = (uintptr_t)string_data(str);
+
+        if (start < (uintptr_t)old_data || start >= (uintptr_t)old_data + old_length) {
+            continue;
+        }
+
+        size_t position = start - (uintptr_t)old_data;
+
+        if (position < offset) {
+            *str = string_borrow(data + position, str->length);
+        } else if (position >= offset + removed) {
+            *str = string_borrow(data + position + delta, str->length);
+        }
+    }
+}
+
+/// Number of tokens kept by the streaming mode, the scanner queues at most a whitespace and the token after it
+#define TOKEN_RING_SIZE 4
+/// Number of the most recent string literals whose payload stays valid in the streaming mode
+#define PAYLOAD_RING_SIZE 16
+
+/**
+ * Bounded replacement of the token list used by the streaming mode. Only the last few tokens are kept and
+ * the payloads of string literals are stored in a ring of reused buffers, so the memory does not grow
+ * with the size of the input.
+ */
+typedef struct {
+    Token tokens[TOKEN_RING_SIZE];
+    /// Number of tokens pushed since the last reset
+    unsigned len;
+    String payloads[PAYLOAD_RING_SIZE];
+    unsigned payload_count;
+} TokenRing;
+
+static void tokenring_init(TokenRing* ring) {
+    ring->len = 0;
+    ring->payload_count = 0;
+
+    for (int i = 0; i < PAYLOAD_RING_SIZE; i++) {
+        string_init(&ring->payloads[i]);
+    }
+}
+
+static void tokenring_free(TokenRing* ring) {
+    for (int i = 0; i < PAYLOAD_RING_SIZE; i++) {
+        string_free(&ring->payloads[i]);
+    }
+
+    ring->len = 0;
+}
+
+static Token* tokenring_at(TokenRing* ring, unsigned idx) {
+    MASSERT(idx < ring->len && ring->len - idx <= TOKEN_RING_SIZE, "Token is no longer kept by the token ring");
+    return &ring->tokens[idx % TOKEN_RING_SIZE];
+}
+
+static void tokenring_push(TokenRing* ring, Token token) {
+    ring->tokens[ring->len++ % TOKEN_RING_SIZE] = token;
+}
+
+/// Copy the payload of a string literal into the oldest buffer of the ring
+static String tokenring_store_string(TokenRing* ring, const String* str) {
+    String stored;
+    string_init(&stored);
+
+    if (str->length) {
+        String* payload = &ring->payloads[ring->payload_count++ % PAYLOAD_RING_SIZE];
+        string_reserve(payload, str->length + 1);
+
+        if (got_error()) {
+            return stored;
+        }
 
-        list->tokens = tmp;
-        list->capacity += c_chunk;
+        memcpy(string_data(payload), string_data(str), str->length);
+        string_data(payload)[str->length] = '\0';
+        payload->length = str->length;
+
+        /// The buffer stays owned by the ring
+        stored = string_borrow(string_data(payload), payload->length);
     }
 
-    list->tokens[list->len++] = token;
+    return stored;
 }
 
 typedef enum {
@@ -121,6 +695,7 @@ typedef enum {
     State_LineStringEscapeHexStart,
     State_LineStringEscapeHex1,
     State_LineStringEscapeHex2,
+    State_LineStringUtf8,
     State_DoubleQuote,
     State_BlockString,
     State_BlockStringStart,
@@ -132,37 +707,230 @@ typedef enum {
     State_BlockStringEscapeHexStart,
     State_BlockStringEscapeHex1,
     State_BlockStringEscapeHex2,
+    State_BlockStringUtf8,
+
+    /// Number of states, used as a dimension of the transition table
+    State_Count,
 } State;
 
+/// Size of a single read when the input cannot be mapped into memory (pipes, terminals).
+const size_t c_input_block = 1 << 16;
+
+/**
+ * Source of the scanner. The whole input is available as one contiguous span of bytes,
+ * so reading a character is just an index into `data` and stepping back is a decrement.
+ */
 typedef struct {
-    bool is_string;
-    int current_position;
-    union {
-        String string;
-        FILE* file;
-    };
+    /// Contiguous bytes of the input, either mapped from the file or owned by the scanner.
+    const char* data;
+    size_t length;
+    size_t current_position;
+    /// `data` was obtained by `mmap` and has to be released by `munmap`.
+    bool is_mapped;
+    /// Source file, closed in `scanner_free`. NULL when scanning a string.
+    FILE* file;
 } Input;
 
+/// Read the rest of `file` into a heap buffer using large block reads.
+static bool input_read_blocks(Input* input, FILE* file) {
+    size_t capacity = c_input_block;
+    char* buf = malloc(capacity);
+
+    if (!buf) {
+        set_error(Error_Internal);
+        eprint("Out Of Memory\n");
+        return false;
+    }
+
+    size_t length = 0;
+    size_t nread;
+
+    while ((nread = fread(buf + length, 1, capacity - length, file)) > 0) {
+        length += nread;
+
+        if (length == capacity) {
+            char* tmp = realloc(buf, capacity * 2);
+            if (!tmp) {
+                free(buf);
+                set_error(Error_Internal);
+                eprint("Out Of Memory\n");
+                return false;
+            }
+
+            buf = tmp;
+            capacity *= 2;
+        }
+    }
+
+    input->data = buf;
+    input->length = length;
+    input->is_mapped = false;
+    return true;
+}
+
+/// Try to map a regular file into memory, return false if it is not possible.
+static bool input_map_file(Input* input, FILE* file) {
+    struct stat st;
+    int fd = fileno(file);
+
+    if (fd < 0 || fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0) {
+        return false;
+    }
+
+    /// Something has already been read through the stream, the mapping would not match it.
+    if (ftello(file) != 0) {
+        return false;
+    }
+
+    void* mapped = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+
+    madvise(mapped, st.st_size, MADV_SEQUENTIAL);
+
+    input->data = mapped;
+    input->length = st.st_size;
+    input->is_mapped = true;
+    return true;
+}
+
+static bool input_init_file(Input* input, FILE* file) {
+    input->file = file;
+    input->current_position = 0;
+
+    if (input_map_file(input, file)) {
+        return true;
+    }
+
+    return input_read_blocks(input, file);
+}
+
+static bool input_init_str(Input* input, const char* str) {
+    size_t length = strlen(str);
+    char* buf = malloc(length + 1);
+
+    if (!buf) {
+        set_error(Error_Internal);
+        eprint("Out Of Memory\n");
+        return false;
+    }
+
+    memcpy(buf, str, length + 1);
+
+    input->data = buf;
+    input->length = length;
+    input->current_position = 0;
+    input->is_mapped = false;
+    input->file = NULL;
+    return true;
+}
+
+static void input_free(Input* input) {
+    if (input->is_mapped) {
+        munmap((void*)input->data, input->length);
+    } else {
+        free((void*)input->data);
+    }
+
+    if (input->file) {
+        fclose(input->file);
+    }
+
+    input->data = NULL;
+    input->length = 0;
+    input->file = NULL;
+}
+
 typedef struct {
     bool initialized;
     Input input;
+    /// Streaming mode, see `scanner_set_streaming`
+    bool streaming;
+    /// Number of threads scanning the input ahead on the first token, see `scanner_set_threads`
+    unsigned threads;
+    /// Worker thread of the parallel mode, identifiers are interned only when the parts are joined
+    bool defer_intern;
     TokenList token_list;
+    TokenRing token_ring;
     unsigned list_idx;
+    /// Line starts of the input, to find the position of an offset for the diagnostics
+    LineIndex lines;
+    /// Token scanned together with the preceding whitespace, returned by the next call without unpacking it
+    Token pending;
+    bool has_pending;
 
     State current_state;
     int number;
-    int decimalpoint;
-    int exponent;
-    bool is_number_double;
-    bool is_exponent_negative;
+    /// Offset of the first digit of the current numeric literal
+    size_t number_start;
     String string;
-    int line;
-    int position_in_line;
+    /// The current line string literal has no escape so far and is kept only as a span of the input
+    bool string_is_span;
+    /// Offset of the first byte of the current string literal span
+    size_t string_start;
+    /// Lines of the current block string literal, their indentation is removed when the literal ends
+    BlockLines block_lines;
+    /// Offset in `string` of the block string line whose indentation is being read
+    size_t block_line_start;
+    /// Continuation bytes still missing in the current UTF-8 sequence of a string literal
+    int utf8_remaining;
+    /// Range of the next continuation byte, the second byte of a sequence may be more restricted
+    unsigned char utf8_low;
+    unsigned char utf8_high;
     unsigned comment_block_level;
     bool has_eol;
 } Scanner;
 
-Scanner g_scanner;
+/// Every thread has its own scanner, the workers of the parallel mode scan their parts of the input in it
+_Thread_local Scanner g_scanner;
+
+/// Inputs of at least this size are scanned in the streaming mode by default
+const size_t c_stream_threshold = 16 << 20;
+/// Inputs of at least this size are scanned in parallel by default
+const size_t c_parallel_threshold = 1 << 20;
+/// Maximum number of threads of the parallel mode
+#define SCANNER_MAX_THREADS 16
+
+static unsigned scanner_token_count() {
+    return g_scanner.streaming ? g_scanner.token_ring.len : g_scanner.token_list.len;
+}
+
+static Token scanner_token_at(unsigned idx) {
+    if (g_scanner.streaming) {
+        return *tokenring_at(&g_scanner.token_ring, idx);
+    }
+
+    return tokenlist_get(&g_scanner.token_list, idx);
+}
+
+/// Keep the token for later
+static void scanner_push_token(Token token) {
+    if (g_scanner.streaming) {
+        tokenring_push(&g_scanner.token_ring, token);
+    } else {
+        tokenlist_push(&g_scanner.token_list, token);
+    }
+}
+
+static String scanner_store_string(const String* str) {
+    return g_scanner.streaming ? tokenring_store_string(&g_scanner.token_ring, str)
+                               : tokenlist_store_string(&g_scanner.token_list, str);
+}
+
+static State step(char ch);
+static void table_build();
+static void scanner_cleanup();
+
+/// Use all processors for inputs big enough to be worth it
+static unsigned scanner_default_threads(size_t length) {
+    if (length < c_parallel_threshold) {
+        return 1;
+    }
+
+    long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    return processors < 1 ? 1 : processors > SCANNER_MAX_THREADS ? SCANNER_MAX_THREADS : processors;
+}
 
 void scanner_init(FILE* src) {
     if (!src) {
@@ -171,17 +939,26 @@ void scanner_init(FILE* src) {
         return;
     }
 
-    g_scanner.input.is_string = false;
-    g_scanner.input.file = src;
-    g_scanner.input.current_position = 0;
     g_scanner.list_idx = 0;
-    g_scanner.line = 1;
-    g_scanner.position_in_line = 0;
+    g_scanner.has_pending = false;
     g_scanner.current_state = State_Start;
     string_init(&g_scanner.string);
+    g_scanner.block_lines = (BlockLines){0};
+    scanner_cleanup();
+    table_build();
+
+    if (!input_init_file(&g_scanner.input, src)) {
+        return;
+    }
+
     tokenlist_init(&g_scanner.token_list);
+    tokenring_init(&g_scanner.token_ring);
+    g_scanner.lines = (LineIndex){0};
+    g_scanner.streaming = g_scanner.input.length >= c_stream_threshold;
+    g_scanner.threads = g_scanner.streaming ? 1 : scanner_default_threads(g_scanner.input.length);
 
     if (got_error()) {
+        input_free(&g_scanner.input);
         return;
     }
 
@@ -190,15 +967,25 @@ void scanner_init(FILE* src) {
 
 void scanner_init_str(const char* str) {
     g_scanner.list_idx = 0;
-    g_scanner.line = 1;
-    g_scanner.position_in_line = 0;
+    g_scanner.has_pending = false;
     g_scanner.current_state = State_Start;
-    g_scanner.input.is_string = true, g_scanner.input.string = string_from_c_str(str);
-    g_scanner.input.current_position = 0;
     string_init(&g_scanner.string);
+    g_scanner.block_lines = (BlockLines){0};
+    scanner_cleanup();
+    table_build();
+
+    if (!input_init_str(&g_scanner.input, str)) {
+        return;
+    }
+
     tokenlist_init(&g_scanner.token_list);
+    tokenring_init(&g_scanner.token_ring);
+    g_scanner.lines = (LineIndex){0};
+    g_scanner.streaming = g_scanner.input.length >= c_stream_threshold;
+    g_scanner.threads = g_scanner.streaming ? 1 : scanner_default_threads(g_scanner.input.length);
 
     if (got_error()) {
+        input_free(&g_scanner.input);
         return;
     }
 
@@ -207,45 +994,74 @@ void scanner_init_str(const char* str) {
 
 void scanner_free() {
     if (g_scanner.initialized) {
-        if (g_scanner.input.is_string) {
-            string_free(&g_scanner.input.string);
-        } else {
-            if (g_scanner.input.file)
-                fclose(g_scanner.input.file);
-        }
-
+        input_free(&g_scanner.input);
         string_free(&g_scanner.string);
+        block_lines_free(&g_scanner.block_lines);
         tokenlist_free(&g_scanner.token_list);
+        tokenring_free(&g_scanner.token_ring);
+        line_index_free(&g_scanner.lines);
         g_scanner.initialized = false;
     }
 }
 
-static State step(char ch);
+
+void scanner_position(size_t offset, size_t* line, size_t* column) {
+    *line = 0;
+    *column = 0;
+
+    if (!g_scanner.initialized) {
+        return;
+    }
+
+    if (!g_scanner.lines.starts && !line_index_build(&g_scanner.lines, g_scanner.input.data, g_scanner.input.length)) {
+        return;
+    }
+
+    line_index_find(&g_scanner.lines, offset < g_scanner.input.length ? offset : g_scanner.input.length, line, column);
+}
 
 void print_position() {
-    eprintf("Line: %d Position: %d>", g_scanner.line, g_scanner.position_in_line);
-}
-
-double make_number_double(int full, int decimalpart) {
-    double res = (double)full;
-    double point = decimalpart == 0          ? 0.0
-                   : decimalpart < 10        ? (double)decimalpart / 10.0
-                   : decimalpart < 100       ? (double)decimalpart / 100.0
-                   : decimalpart < 1000      ? (double)decimalpart / 1000.0
-                   : decimalpart < 10000     ? (double)decimalpart / 10000.0
-                   : decimalpart < 100000    ? (double)decimalpart / 100000.0
-                   : decimalpart < 1000000   ? (double)decimalpart / 1000000.0
-                   : decimalpart < 10000000  ? (double)decimalpart / 10000000.0
-                   : decimalpart < 100000000 ? (double)decimalpart / 100000000.0
-                                             : (double)decimalpart / 1000000000.0;
-    /// 2147483647 je 2^31-1
-
-    if (point > 1.0) {
-        print_position();
-        eprintf("%d.%d is too large for a Double\n", full, decimalpart);
+    /// The workers of the parallel mode do not print, they would build the line index for nothing
+    if (!get_print_errors()) {
+        return;
+    }
+
+    size_t line, column;
+    scanner_position(g_scanner.input.current_position, &line, &column);
+    eprintf("Line: %zu Position: %zu>", line, column);
+}
+
+/// Convert the numeric literal that ends at the current position
+static void get_number_token(Token* token) {
+    const char* start = g_scanner.input.data + g_scanner.number_start;
+    size_t length = g_scanner.input.current_position - g_scanner.number_start;
+    Data* data = &token->attribute.data;
+
+    if (g_scanner.current_state == State_Number) {
+        data->type = DataType_Int;
+
+        if (!number_parse_int(start, length, &data->value.number)) {
+            print_position();
+            eprint("Number overflow\n");
+            set_error(Error_Lexical);
+            return;
+        }
+    } else {
+        data->type = DataType_Double;
+
+        if (!number_parse_double(start, length, &data->value.number_double)) {
+            if (!got_error()) {
+                print_position();
+                eprintf("%.*s is too large for a Double\n", (int)length, start);
+                set_error(Error_Lexical);
+            }
+
+            return;
+        }
     }
 
-    return res + point;
+    data->is_nil = false;
+    token->type = Token_Data;
 }
 
 void get_current_token(Token* token) {
@@ -275,45 +1091,47 @@ void get_current_token(Token* token) {
             token->type = Token_Equal;
             break;
         case State_Identifier: {
-            for (int i = 0; KEYWORD[i]; i++) {
-                if (strcmp(g_scanner.string.data, KEYWORD[i]) == 0) {
-                    token->type = KEYWORD_TYPE[i];
-                    return;
+            const ReservedWord* reserved = find_reserved_word(&g_scanner.string);
+
+            if (reserved) {
+                token->type = reserved->type;
+
+                if (reserved->type == Token_DataType) {
+                    token->attribute.data_type = reserved->data_type;
+                } else if (reserved->type == Token_Data) {
+                    token->attribute.data.is_nil = reserved->is_nil;
+
+                    if (!reserved->is_nil) {
+                        token->attribute.data.type = reserved->data_type;
+                        token->attribute.data.value.is_true = reserved->is_true;
+                    }
                 }
+
+                return;
             }
 
-            for (int i = 0; DATA_TYPE_IDENTIFIER[i]; i++) {
-                if (strcmp(g_scanner.string.data, DATA_TYPE_IDENTIFIER[i]) == 0) {
-                    token->type = Token_DataType;
-                    token->attribute.data_type = DATA_TYPE[i];
+            if (g_scanner.defer_intern) {
+                /// The interner is not shared with the workers, keep the name among the literals of the part
+                Data name = {.type = DataType_String};
+                name.value.string = tokenlist_store_string(&g_scanner.token_list, &g_scanner.string);
+
+                if (got_error() || !tokenlist_push_literal(&g_scanner.token_list, name, &token->symbol)) {
                     return;
                 }
-            }
 
-            if (strcmp(g_scanner.string.data, "true") == 0) {
-                token->type = Token_Data;
-                token->attribute.data.type = DataType_Bool;
-                token->attribute.data.value.is_true = true;
-                token->attribute.data.is_nil = false;
-                return;
+                token->type = Token_Identifier;
+                token->attribute.data = name;
+                break;
             }
 
-            if (strcmp(g_scanner.string.data, "false") == 0) {
-                token->type = Token_Data;
-                token->attribute.data.type = DataType_Bool;
-                token->attribute.data.value.is_true = false;
-                token->attribute.data.is_nil = false;
-                return;
-            }
+            token->symbol = intern_add(string_data(&g_scanner.string), g_scanner.string.length);
 
-            if (strcmp(g_scanner.string.data, "nil") == 0) {
-                token->type = Token_Data;
-                token->attribute.data.is_nil = true;
+            if (token->symbol == SYMBOL_NONE) {
                 return;
             }
 
             token->type = Token_Identifier;
-            token->attribute.data.value.string = string_take(&g_scanner.string);
+            token->attribute.data.value.string = intern_view(token->symbol);
             break;
         }
 
@@ -378,57 +1196,34 @@ void get_current_token(Token* token) {
             token->type = Token_Operator;
             break;
 
-        case State_MaybeNilType:
-            for (int i = 0; DATA_TYPE_IDENTIFIER[i]; i++) {
-                if (strcmp(g_scanner.string.data, DATA_TYPE_IDENTIFIER[i]) == 0) {
-                    token->type = Token_DataType;
-                    token->attribute.data_type = OPTIONAL_DATA_TYPE[i];
-                    string_clear(&g_scanner.string);
-                    break;
-                }
+        case State_MaybeNilType: {
+            const ReservedWord* reserved = find_reserved_word(&g_scanner.string);
+
+            if (reserved && reserved->type == Token_DataType) {
+                token->attribute.data_type = reserved->optional_data_type;
+                string_clear(&g_scanner.string);
             }
 
             token->type = Token_DataType;
             break;
+        }
         case State_Number:
-            token->attribute.data.type = DataType_Int;
-            token->attribute.data.value.number = g_scanner.number;
-            token->attribute.data.is_nil = false;
-            token->type = Token_Data;
-            break;
         case State_NumberDouble:
-            token->attribute.data.type = DataType_Double;
-            token->attribute.data.value.number_double = make_number_double(g_scanner.number, g_scanner.decimalpoint);
-            token->attribute.data.is_nil = false;
-            token->type = Token_Data;
+        case State_NumberExponent:
+            get_number_token(token);
             break;
-        case State_NumberExponent: {
-            double number = make_number_double(g_scanner.number, g_scanner.decimalpoint);
-
-            if (got_error()) {
-                break;
-            }
-
-            if (g_scanner.is_exponent_negative) {
-                while (g_scanner.exponent--) {
-                    number /= 10;
-                }
+        case State_StringEnd:
+            token->attribute.data.type = DataType_String;
 
+            if (g_scanner.string_is_span) {
+                /// Nothing had to be decoded, the literal borrows the input up to the closing quote
+                size_t end = g_scanner.input.current_position - 1;
+                token->attribute.data.value.string =
+                    string_borrow(g_scanner.input.data + g_scanner.string_start, end - g_scanner.string_start);
             } else {
-                while (g_scanner.exponent--) {
-                    number *= 10;
-                }
+                token->attribute.data.value.string = scanner_store_string(&g_scanner.string);
             }
 
-            token->attribute.data.type = DataType_Double;
-            token->attribute.data.value.number_double = number;
-            token->attribute.data.is_nil = false;
-            token->type = Token_Data;
-            break;
-        }
-        case State_StringEnd:
-            token->attribute.data.type = DataType_String;
-            token->attribute.data.value.string = string_take(&g_scanner.string);
             token->attribute.data.is_nil = false;
             token->type = Token_Data;
             break;
@@ -448,71 +1243,463 @@ void get_current_token(Token* token) {
     }
 }
 
-void scanner_step_back(char ch) {
-    if (!g_scanner.input.current_position) {
+void scanner_step_back() {
+    if (g_scanner.input.current_position) {
+        g_scanner.input.current_position -= 1;
+    }
+}
+
+int scanner_next_char() {
+    size_t idx = g_scanner.input.current_position++;
+    return idx < g_scanner.input.length ? (unsigned char)g_scanner.input.data[idx] : EOF;
+}
+
+void scanner_reset_to_beginning() {
+    if (!g_scanner.initialized) {
+        set_error(Error_Internal);
+        eprint("Scanner is not initialized\n");
         return;
     }
 
-    if (ch == '\n') {
-        g_scanner.line -= 1;
-    } else {
-        g_scanner.position_in_line -= 1;
+    g_scanner.list_idx = 0;
+    g_scanner.has_pending = false;
+
+    if (g_scanner.streaming) {
+        /// Nothing is retained, so the input is scanned again from the start
+        g_scanner.token_ring.len = 0;
+        g_scanner.input.current_position = 0;
+        g_scanner.current_state = State_Start;
+        scanner_cleanup();
+    }
+}
+
+void scanner_set_streaming(bool streaming) {
+    if (!g_scanner.initialized || scanner_token_count()) {
+        set_error(Error_Internal);
+        eprint("The scanner mode can be changed only before the first token\n");
+        return;
+    }
+
+    g_scanner.streaming = streaming;
+}
+
+void scanner_set_threads(unsigned threads) {
+    if (!g_scanner.initialized || scanner_token_count()) {
+        set_error(Error_Internal);
+        eprint("The scanner mode can be changed only before the first token\n");
+        return;
     }
 
-    g_scanner.input.current_position -= 1;
-    if (!g_scanner.input.is_string) {
-        ungetc(ch, g_scanner.input.file);
+    g_scanner.threads = threads < 1 ? 1 : threads > SCANNER_MAX_THREADS ? SCANNER_MAX_THREADS : threads;
+
+    if (g_scanner.threads > 1) {
+        g_scanner.streaming = false;
     }
 }
 
-int scanner_next_char() {
-    int idx = g_scanner.input.current_position++;
-    int ch;
+static void scanner_cleanup() {
+    g_scanner.number = 0;
+    string_clear(&g_scanner.string);
+    g_scanner.string_is_span = false;
+    g_scanner.utf8_remaining = 0;
+    g_scanner.block_lines.count = 0;
+    g_scanner.comment_block_level = 0;
+    g_scanner.has_eol = false;
+}
+
+#ifndef SCANNER_REFERENCE_DFA
+/// Consume the contents of a string literal up to the next escape, quote, newline or invalid UTF-8. The run is copied
+/// at once, or only skipped while the literal is a span of the input.
+static void scanner_skip_string_run(bool is_line_string) {
+    Input* input = &g_scanner.input;
+    size_t start = input->current_position;
+    size_t end = scanner_skip_string(input->data, start, input->length, is_line_string);
+    String* str = &g_scanner.string;
+
+    if (end == start) {
+        return;
+    }
+
+    if (!g_scanner.string_is_span) {
+        string_append_n(str, input->data + start, end - start);
+
+        if (got_error()) {
+            return;
+        }
+    }
+
+    input->current_position = end;
+}
+#endif
+
+/// Consume the whole run of bytes that would keep the DFA in the current whitespace, comment, number or string
+/// state.
+static void scanner_skip_run() {
+#ifndef SCANNER_REFERENCE_DFA
+    SkipKind kind;
+    Input* input = &g_scanner.input;
+
+    if (g_scanner.current_state == State_Number || g_scanner.current_state == State_NumberDouble ||
+        g_scanner.current_state == State_NumberExponent) {
+        /// Digits are never a newline, the value is computed from the whole literal when it ends
+        input->current_position = number_skip_digits(input->data, input->current_position, input->length);
+        return;
+    }
+
+    if (g_scanner.current_state == State_LineString || g_scanner.current_state == State_BlockString) {
+        scanner_skip_string_run(g_scanner.current_state == State_LineString);
+        return;
+    }
+
+    if (g_scanner.comment_block_level) {
+        if (g_scanner.current_state != State_Start) {
+            return;
+        }
 
-    if (g_scanner.input.is_string) {
-        ch = g_scanner.input.string.data[idx];
-        if (!ch)
-            ch = EOF;
+        kind = Skip_BlockComment;
+    } else if (g_scanner.current_state == State_Whitespace) {
+        kind = Skip_Whitespace;
+    } else if (g_scanner.current_state == State_LineComment) {
+        kind = Skip_LineComment;
     } else {
-        ch = fgetc(g_scanner.input.file);
+        return;
+    }
+
+    if (input->current_position >= input->length) {
+        return;
+    }
+
+    size_t newlines;
+    size_t last_newline;
+    input->current_position =
+        scanner_skip(input->data, input->current_position, input->length, kind, &newlines, &last_newline);
+
+    if (newlines) {
+        g_scanner.has_eol = true;
+    }
+#endif
+}
+
+/// Part of the input scanned by a worker thread of the parallel mode
+typedef struct {
+    const char* data;
+    size_t start;
+    size_t end;
+    TokenList tokens;
+    /// Scanned without an error, so the part really started outside of any multi-line token
+    bool valid;
+    pthread_t thread;
+} ScanPart;
+
+static void* scanner_scan_part(void* arg) {
+    ScanPart* part = arg;
+
+    /// A part that fails is scanned again by the serial scanner, which reports the error
+    set_print_errors(false);
+
+    g_scanner.input = (Input){.data = part->data, .length = part->end, .current_position = part->start};
+    g_scanner.current_state = State_Start;
+    g_scanner.defer_intern = true;
+    string_init(&g_scanner.string);
+    g_scanner.block_lines = (BlockLines){0};
+    scanner_cleanup();
+    tokenlist_init(&g_scanner.token_list);
+    g_scanner.initialized = true;
+
+    Token token;
+
+    do {
+        token = scanner_advance();
+    } while (token.type != Token_EOF && !got_error());
+
+    part->valid = !got_error();
+    part->tokens = g_scanner.token_list;
+    string_free(&g_scanner.string);
+    block_lines_free(&g_scanner.block_lines);
+    return NULL;
+}
+
+/// Continue the serial scan at `offset`, which is the end of the last token in the token list or 0 if it is empty
+static void scanner_resume(size_t offset) {
+    /// The token ended the same way as in the serial scan, by the next byte or by the end of the input
+    g_scanner.input.current_position = offset;
+    g_scanner.current_state = !offset || offset < g_scanner.input.length ? State_Start : State_EOF;
+    scanner_cleanup();
+}
+
+/**
+ * Scan the whole input ahead on `g_scanner.threads` threads into the token list.
+ *
+ * The input is split right before newlines, speculating that they are not inside of a block comment or a multi-line
+ * string. A part scanned without an error proves that the next part starts outside of them too. From the first
+ * part that failed on, the input is left to the serial scanner.
+ */
+static void scanner_scan_parallel() {
+    Input* input = &g_scanner.input;
+    TokenList* list = &g_scanner.token_list;
+    ScanPart parts[SCANNER_MAX_THREADS];
+    unsigned threads = g_scanner.threads;
+    unsigned count = 0;
+    size_t start = 0;
+
+    /// Scanned only once, the rest of the scan is serial
+    g_scanner.threads = 1;
+
+    /// Select the skipping kernel now, the workers would race to do it
+    size_t newlines, last_newline;
+    scanner_skip(input->data, 0, 0, Skip_Whitespace, &newlines, &last_newline);
+
+    for (unsigned i = 0; i < threads && start < input->length; i++) {
+        size_t end = input->length;
+
+        if (i + 1 < threads) {
+            size_t target = start + (input->length - start) / (threads - i);
+            target = target > start ? target : start + 1;
+            const char* newline = memchr(input->data + target, '\n', input->length - target);
+            end = newline ? (size_t)(newline - input->data) : input->length;
+        }
+
+        parts[count] = (ScanPart){.data = input->data, .start = start, .end = end};
+
+        if (pthread_create(&parts[count].thread, NULL, scanner_scan_part, &parts[count])) {
+            break;
+        }
+
+        count++;
+        start = end;
+    }
+
+    for (unsigned i = 0; i < count; i++) {
+        pthread_join(parts[i].thread, NULL);
+    }
+
+    bool joining = true;
+
+    for (unsigned i = 0; i < count; i++) {
+        joining = joining && parts[i].valid && !got_error();
+
+        if (joining) {
+            tokenlist_join(list, &parts[i].tokens, parts[i].start);
+        }
+
+        tokenlist_free(&parts[i].tokens);
     }
 
-    if (ch == EOF) {
-        return EOF;
-    } else if (ch == '\n') {
-        g_scanner.line += 1;
-        g_scanner.position_in_line = 0;
+    if (got_error()) {
+        return;
+    }
+
+    /// The trailing whitespace may go on in the part that failed, the serial scanner scans it again with the rest
+    if (list->len) {
+        unsigned offset;
+        TokenChunk* chunk = &list->chunks[tokenlist_chunk(list->len - 1, &offset)];
+
+        if (chunk->types[offset] == Token_Whitespace) {
+            list->len--;
+        }
+    }
+
+    size_t resume = 0;
+
+    if (list->len) {
+        unsigned offset;
+        resume = list->chunks[tokenlist_chunk(list->len - 1, &offset)].offsets[offset];
+    }
+
+    scanner_resume(resume);
+}
+
+/// Replace the bytes of the input, the old ones are released
+static void input_replace(Input* input, char* data, size_t length) {
+    if (input->is_mapped) {
+        munmap((void*)input->data, input->length);
     } else {
-        g_scanner.position_in_line += 1;
+        free((void*)input->data);
     }
 
-    return ch;
+    input->data = data;
+    input->length = length;
+    input->is_mapped = false;
 }
 
-void scanner_reset_to_beginning() {
-    if (!g_scanner.initialized) {
+/// Type and offset of the token at `idx`
+static uint8_t tokenlist_type(TokenList* list, unsigned idx, uint32_t* source_offset) {
+    unsigned offset;
+    TokenChunk* chunk = tokenlist_slot(list, idx, &offset);
+    *source_offset = chunk->offsets[offset];
+    return chunk->types[offset];
+}
+
+/**
+ * Scan the edited input from `resume` into a new token list until the scanner gets to the same state as before
+ * the edit, which is right after a token that ends at the same byte after the edit. From there on, the old tokens
+ * are the same as the new ones would be. Returns the index of the first old token that is kept.
+ */
+static unsigned scanner_relex(TokenList* old, unsigned first, size_t resume, size_t edit_end, ptrdiff_t delta) {
+    unsigned end = old->len;
+    Token token;
+
+    scanner_resume(resume);
+
+    do {
+        token = scanner_advance();
+        TokenList* fresh = &g_scanner.token_list;
+
+        if (got_error() || !fresh->len) {
+            break;
+        }
+
+        uint32_t source_offset, old_offset;
+        uint8_t type = tokenlist_type(fresh, fresh->len - 1, &source_offset);
+
+        if (type == Token_Whitespace || type == Token_EOF || source_offset < edit_end) {
+            continue;
+        }
+
+        unsigned idx = tokenlist_lower_bound(old, first, source_offset - delta);
+
+        if (idx < old->len && tokenlist_type(old, idx, &old_offset) != Token_Whitespace &&
+            old_offset == source_offset - delta) {
+            end = idx + 1;
+            break;
+        }
+    } while (token.type != Token_EOF);
+
+    return end;
+}
+
+TokenEdit scanner_edit(size_t offset, size_t removed, const char* inserted) {
+    TokenEdit edit = {0};
+    Input* input = &g_scanner.input;
+    TokenList* list = &g_scanner.token_list;
+
+    if (!g_scanner.initialized || g_scanner.streaming) {
         set_error(Error_Internal);
-        eprint("Scanner is not initialized\n");
-        return;
+        eprint("Only the retained tokens can be edited\n");
+        return edit;
+    }
+
+    if (offset > input->length || removed > input->length - offset) {
+        set_error(Error_Internal);
+        eprint("Edit is out of the input\n");
+        return edit;
+    }
+
+    size_t inserted_length = strlen(inserted);
+    size_t length = input->length - removed + inserted_length;
+    ptrdiff_t delta = (ptrdiff_t)inserted_length - (ptrdiff_t)removed;
+
+    if (length > UINT32_MAX) {
+        set_error(Error_Internal);
+        eprint("Input is too big to retain its tokens, use the streaming mode\n");
+        return edit;
+    }
+
+    char* data = malloc(length + 1);
+
+    if (!data) {
+        set_error(Error_Internal);
+        eprint("Out Of Memory\n");
+        return edit;
+    }
+
+    memcpy(data, input->data, offset);
+    memcpy(data + offset, inserted, inserted_length);
+    memcpy(data + offset + inserted_length, input->data + offset + removed, input->length - offset - removed);
+    data[length] = '\0';
+
+    tokenlist_rebase_spans(list, input->data, input->length, data, offset, removed, delta);
+    input_replace(input, data, length);
+    line_index_free(&g_scanner.lines);
+
+    /// Tokens ending before the edit are kept, except a whitespace that the edit may continue
+    uint32_t resume = 0;
+    uint32_t last_offset;
+    unsigned first = tokenlist_lower_bound(list, 0, offset);
+
+    if (first && tokenlist_type(list, first - 1, &last_offset) == Token_Whitespace) {
+        first--;
+    }
+
+    if (first) {
+        tokenlist_type(list, first - 1, &resume);
+    }
+
+    edit.first = first;
+
+    /// The rest of the input was not scanned yet, it will be scanned as the tokens are requested
+    if (!list->len || tokenlist_type(list, list->len - 1, &last_offset) != Token_EOF) {
+        g_scanner.list_idx = 0;
+        g_scanner.has_pending = false;
+        edit.removed = list->len - first;
+        list->len = first;
+        scanner_resume(resume);
+        return edit;
     }
 
+    TokenList old = *list;
+    tokenlist_init(list);
+
+    /// Errors are reported when the tokens are requested, the same as in a scan from the start
+    bool print_errors = get_print_errors();
+    set_print_errors(false);
+    unsigned end = scanner_relex(&old, first, resume, offset + inserted_length, delta);
+    set_print_errors(print_errors);
+
+    TokenList fresh = *list;
+    *list = old;
     g_scanner.list_idx = 0;
-    g_scanner.position_in_line = 0;
-    g_scanner.line = 0;
+    g_scanner.has_pending = false;
+
+    /// The scan from the edit on reports the error again when it gets there
+    if (got_error()) {
+        set_error(Error_None);
+        tokenlist_free(&fresh);
+        edit.removed = list->len - first;
+        list->len = first;
+        scanner_resume(resume);
+        return edit;
+    }
+
+    edit.removed = end - first;
+    edit.inserted = fresh.len;
+    tokenlist_splice(list, first, end - first, &fresh, delta);
+    tokenlist_free(&fresh);
+
+    /// All of the tokens are in the list again
+    scanner_resume(length);
+    return edit;
 }
 
-static void scanner_cleanup() {
-    g_scanner.number = 0;
-    g_scanner.decimalpoint = 0;
-    g_scanner.exponent = 0;
-    g_scanner.is_number_double = false;
-    g_scanner.is_exponent_negative = false;
-    string_clear(&g_scanner.string);
-    g_scanner.comment_block_level = 0;
-    g_scanner.has_eol = false;
-}
+Token scanner_advance() {
+    if (!g_scanner.initialized) {
+        set_error(Error_Internal);
+        eprint("Scanner is not initialized\n");
+        return (Token){0};
+    }
+
+    if (g_scanner.has_pending) {
+        g_scanner.has_pending = false;
+        g_scanner.list_idx++;
+        return g_scanner.pending;
+    }
+
+    if (g_scanner.list_idx < scanner_token_count()) {
+        return scanner_token_at(g_scanner.list_idx++);
+    }
+
+    if (g_scanner.threads > 1 && !g_scanner.streaming) {
+        scanner_scan_parallel();
+
+        if (got_error()) {
+            return (Token){0};
+        }
+
+        if (g_scanner.list_idx < scanner_token_count()) {
+            return scanner_token_at(g_scanner.list_idx++);
+        }
+    }
 
-Token scanner_advance() {
     Token token = {0};
     bool got_token = false;
     bool getting_whitespaces = false;
@@ -520,22 +1707,25 @@ Token scanner_advance() {
     whitespace_token.type = Token_Whitespace;
     whitespace_token.attribute.has_eol = false;
 
-    if (!g_scanner.initialized) {
-        set_error(Error_Internal);
-        eprint("Scanner is not initialized\n");
-        return token;
-    }
-
-    if (g_scanner.list_idx < g_scanner.token_list.len) {
-        return g_scanner.token_list.tokens[g_scanner.list_idx++];
-    }
-
     while (!got_token) {
-        token.line = g_scanner.line;
-        token.position_in_line = g_scanner.position_in_line;
+        scanner_skip_run();
+
+        token.offset = g_scanner.input.current_position;
 
         int ch = scanner_next_char();
 
+        /// The `*/` is closed by the character after it, at the end of the input there is none
+        if (ch == EOF && g_scanner.comment_block_level && g_scanner.current_state == State_BlockCommentEnd) {
+            g_scanner.comment_block_level -= 1;
+        }
+
+        if (ch == EOF && g_scanner.comment_block_level) {
+            print_position();
+            eprint("Unterminated block comment\n");
+            set_error(Error_Lexical);
+            return token;
+        }
+
         State next_state = ch != EOF ? step(ch) : State_EOF;
 
         if (got_error()) {
@@ -544,7 +1734,7 @@ Token scanner_advance() {
 
         /// Skip if we are inside a block comment
         if (!g_scanner.comment_block_level && (next_state == State_Start || next_state == State_EOF)) {
-            scanner_step_back(ch);
+            scanner_step_back();
             get_current_token(&token);
             scanner_cleanup();
 
@@ -553,30 +1743,28 @@ Token scanner_advance() {
             }
 
             if (token.type == Token_Whitespace) {
+                /// Consecutive whitespaces and comments are merged, the first one gives the position
+                if (!getting_whitespaces) {
+                    whitespace_token.offset = token.offset;
+                }
+
                 getting_whitespaces = true;
 
                 whitespace_token.attribute.has_eol = whitespace_token.attribute.has_eol || token.attribute.has_eol;
 
-                whitespace_token.line = whitespace_token.line ? whitespace_token.line : token.line;
-
-                whitespace_token.position_in_line =
-                    whitespace_token.position_in_line ? whitespace_token.position_in_line : token.line;
-
                 g_scanner.current_state = next_state;
                 continue;
             }
 
             if (getting_whitespaces) {
-                tokenlist_push(&g_scanner.token_list, whitespace_token);
-                tokenlist_push(&g_scanner.token_list, token);
-
-                getting_whitespaces = false;
-                whitespace_token.attribute.has_eol = false;
-                whitespace_token.line = 0;
-                whitespace_token.position_in_line = 0;
+                scanner_push_token(whitespace_token);
+                scanner_push_token(token);
 
+                g_scanner.pending = token;
+                g_scanner.has_pending = !got_error();
                 g_scanner.current_state = next_state;
-                return g_scanner.token_list.tokens[g_scanner.list_idx++];
+                g_scanner.list_idx++;
+                return whitespace_token;
             }
 
             got_token = true;
@@ -585,7 +1773,7 @@ Token scanner_advance() {
         g_scanner.current_state = next_state;
     }
 
-    tokenlist_push(&g_scanner.token_list, token);
+    scanner_push_token(token);
 
     if (!got_error()) {
         g_scanner.list_idx += 1;
@@ -617,6 +1805,29 @@ static int parse_decimal(char ch) {
     return -1;
 }
 
+/// Push the code point of a `\\u{}` escape encoded in UTF-8
+static void scanner_push_code_point(int code_point) {
+    if (code_point < 0x80) {
+        string_push(&g_scanner.string, code_point);
+        return;
+    }
+
+    if (code_point < 0x800) {
+        string_push(&g_scanner.string, 0xC0 | (code_point >> 6));
+    } else {
+        if (code_point < 0x10000) {
+            string_push(&g_scanner.string, 0xE0 | (code_point >> 12));
+        } else {
+            string_push(&g_scanner.string, 0xF0 | (code_point >> 18));
+            string_push(&g_scanner.string, 0x80 | ((code_point >> 12) & 0x3F));
+        }
+
+        string_push(&g_scanner.string, 0x80 | ((code_point >> 6) & 0x3F));
+    }
+
+    string_push(&g_scanner.string, 0x80 | (code_point & 0x3F));
+}
+
 static int parse_hexadecimal(char ch) {
     if (ch >= '0' && ch <= '9') {
         return ch - '0';
@@ -633,7 +1844,7 @@ static int parse_hexadecimal(char ch) {
 
 static State step_start(char ch) {
     if (ch >= '0' && ch <= '9') {
-        g_scanner.number = ch - '0';
+        g_scanner.number_start = g_scanner.input.current_position - 1;
         return State_Number;
     }
 
@@ -736,16 +1947,9 @@ static State step_identifier(char ch) {
     }
 
     if (ch == '?') {
-        bool maybe_nil_type = false;
+        const ReservedWord* reserved = find_reserved_word(&g_scanner.string);
 
-        for (int i = 0; DATA_TYPE_IDENTIFIER[i]; i++) {
-            if (strcmp(g_scanner.string.data, DATA_TYPE_IDENTIFIER[i]) == 0) {
-                maybe_nil_type = true;
-                break;
-            }
-        }
-
-        if (maybe_nil_type) {
+        if (reserved && reserved->type == Token_DataType) {
             return State_MaybeNilType;
         }
     }
@@ -753,19 +1957,6 @@ static State step_identifier(char ch) {
     return State_Start;
 }
 
-static void push_number(int* number, int to_push) {
-    bool will_overflow = *number > ((INT_MAX - to_push) / 10);
-
-    if (will_overflow) {
-        print_position();
-        eprint("Number overflow\n");
-        set_error(Error_Lexical);
-    }
-
-    *number *= 10;
-    *number += to_push;
-}
-
 static State step_number(char ch) {
     if (ch == '.') {
         return State_NumberDoubleStart;
@@ -775,33 +1966,21 @@ static State step_number(char ch) {
         return State_NumberExponentStart;
     }
 
-    int num = parse_decimal(ch);
-
-    if (num == -1) {
+    if (parse_decimal(ch) == -1) {
         return State_Start;
     }
 
-    push_number(&g_scanner.number, num);
-
-    if (got_error()) {
-        return State_EOF;
-    }
-
     return State_Number;
 }
 
 static State step_number_double_start(char ch) {
-    int num = parse_decimal(ch);
-
-    if (num == -1) {
+    if (parse_decimal(ch) == -1) {
         print_position();
         eprintf("Expect a decimal number, found `%c` instead\n", ch);
         set_error(Error_Lexical);
         return State_EOF;
     }
 
-    g_scanner.decimalpoint = num;
-    g_scanner.is_number_double = true;
     return State_NumberDouble;
 }
 
@@ -810,61 +1989,42 @@ static State step_number_double(char ch) {
         return State_NumberExponentStart;
     }
 
-    int num = parse_decimal(ch);
-
-    if (num == -1) {
+    if (parse_decimal(ch) == -1) {
         return State_Start;
     }
 
-    push_number(&g_scanner.decimalpoint, num);
-
     return State_NumberDouble;
 }
 static State step_number_exponent_start(char ch) {
-    if (ch == '+') {
-        g_scanner.is_exponent_negative = false;
-        return State_NumberExponentSign;
-    }
-
-    if (ch == '-') {
-        g_scanner.is_exponent_negative = true;
+    if (ch == '+' || ch == '-') {
         return State_NumberExponentSign;
     }
 
-    int num = parse_decimal(ch);
-
-    if (num == -1) {
+    if (parse_decimal(ch) == -1) {
         print_position();
         eprintf("Expect a decimal number, found `%c` instead\n", ch);
         set_error(Error_Lexical);
         return State_EOF;
     }
 
-    g_scanner.exponent = num;
     return State_NumberExponent;
 }
 static State step_number_exponent_sign(char ch) {
-    int num = parse_decimal(ch);
-
-    if (num == -1) {
+    if (parse_decimal(ch) == -1) {
         print_position();
         eprintf("Expect a decimal number, found `%c` instead\n", ch);
         set_error(Error_Lexical);
         return State_EOF;
     }
 
-    g_scanner.exponent = num;
     return State_NumberExponent;
 }
 
 static State step_number_exponent(char ch) {
-    int num = parse_decimal(ch);
-
-    if (num == -1) {
+    if (parse_decimal(ch) == -1) {
         return State_Start;
     }
 
-    push_number(&g_scanner.exponent, num);
     return State_NumberExponent;
 }
 
@@ -873,10 +2033,77 @@ static State step_string_start(char ch) {
         return State_DoubleQuote;
     }
 
-    scanner_step_back(ch);
+    scanner_step_back();
     return State_LineString;
 }
 
+/// Push a byte of a string literal unless the literal is only a span of the input
+static void scanner_push_string_byte(char ch) {
+    if (!g_scanner.string_is_span) {
+        string_push(&g_scanner.string, ch);
+    }
+}
+
+static State step_string_utf8_invalid() {
+    print_position();
+    eprint("Invalid UTF-8 sequence in string literal\n");
+    set_error(Error_Lexical);
+    return State_EOF;
+}
+
+/// First byte of a UTF-8 sequence in a string literal, the ranges refuse overlong forms, surrogates and code points
+/// above U+10FFFF
+static State step_string_utf8_start(char ch, bool is_line_string) {
+    unsigned char lead = ch;
+    g_scanner.utf8_low = 0x80;
+    g_scanner.utf8_high = 0xBF;
+
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        g_scanner.utf8_remaining = 1;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+        g_scanner.utf8_remaining = 2;
+        g_scanner.utf8_low = lead == 0xE0 ? 0xA0 : 0x80;
+        g_scanner.utf8_high = lead == 0xED ? 0x9F : 0xBF;
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+        g_scanner.utf8_remaining = 3;
+        g_scanner.utf8_low = lead == 0xF0 ? 0x90 : 0x80;
+        g_scanner.utf8_high = lead == 0xF4 ? 0x8F : 0xBF;
+    } else {
+        return step_string_utf8_invalid();
+    }
+
+    scanner_push_string_byte(ch);
+
+    if (got_error()) {
+        return State_EOF;
+    }
+
+    return is_line_string ? State_LineStringUtf8 : State_BlockStringUtf8;
+}
+
+static State step_string_utf8(char ch, bool is_line_string) {
+    unsigned char byte = ch;
+
+    if (byte < g_scanner.utf8_low || byte > g_scanner.utf8_high) {
+        return step_string_utf8_invalid();
+    }
+
+    scanner_push_string_byte(ch);
+
+    if (got_error()) {
+        return State_EOF;
+    }
+
+    g_scanner.utf8_low = 0x80;
+    g_scanner.utf8_high = 0xBF;
+
+    if (--g_scanner.utf8_remaining) {
+        return is_line_string ? State_LineStringUtf8 : State_BlockStringUtf8;
+    }
+
+    return is_line_string ? State_LineString : State_BlockString;
+}
+
 static State step_line_string(char ch) {
     if (ch == '"') {
         return State_StringEnd;
@@ -886,6 +2113,10 @@ static State step_line_string(char ch) {
         return State_LineStringEscape;
     }
 
+    if ((unsigned char)ch >= 0x80) {
+        return step_string_utf8_start(ch, true);
+    }
+
     if (ch < 0x20 || ch == '\n') {
         print_position();
         eprint("Special character must be escaped by `\\`\n");
@@ -907,13 +2138,15 @@ static State step_double_quote(char ch) {
         return State_BlockStringStart;
     }
 
-    scanner_step_back(ch);
+    scanner_step_back();
     return State_StringEnd;
 }
 
 static State step_block_string_start(char ch) {
     if (ch == '\n') {
-        return State_BlockString;
+        g_scanner.block_line_start = 0;
+        g_scanner.number = 0;
+        return State_BlockStringEnd1;
     }
 
     print_position();
@@ -985,7 +2218,7 @@ static State step_string_escape_hex_start(char ch, bool is_line_string) {
 
 static State step_string_escape_hex(char ch, int nth, bool is_line_string) {
     if (ch == '}') {
-        string_push(&g_scanner.string, ch);
+        scanner_push_code_point(g_scanner.number);
 
         if (got_error()) {
             return State_EOF;
@@ -1016,6 +2249,14 @@ static State step_string_escape_hex(char ch, int nth, bool is_line_string) {
 
 static State step_block_string(char ch) {
     if (ch == '\n') {
+        string_push(&g_scanner.string, ch);
+
+        if (got_error()) {
+            return State_EOF;
+        }
+
+        g_scanner.block_line_start = g_scanner.string.length;
+        g_scanner.number = 0;
         return State_BlockStringEnd1;
     }
 
@@ -1023,6 +2264,10 @@ static State step_block_string(char ch) {
         return State_BlockStringEscape;
     }
 
+    if ((unsigned char)ch >= 0x80) {
+        return step_string_utf8_start(ch, false);
+    }
+
     if (ch < 0x20) {
         print_position();
         eprint("Special character must be escaped by `\\`\n");
@@ -1039,54 +2284,89 @@ static State step_block_string(char ch) {
     return State_BlockString;
 }
 
-static State step_block_string_end(char ch, int nth) {
-    if (nth == 1) {
-        int ident = ch == ' ' ? 1 : ch == '\t' ? 4 : 0;
+/// Remove `level` of indentation (a tab is 4, a space is 1) from every line of the block string literal. The lines
+/// and their indentation are known from the scanning, each line is then moved to its place only once.
+static bool scanner_strip_block_indent(int level) {
+    String* str = &g_scanner.string;
+    BlockLines* lines = &g_scanner.block_lines;
+
+    /// Find what to strip first, the literal is left untouched for the diagnostic
+    for (size_t i = 0; i < lines->count; i++) {
+        BlockLine* line = &lines->lines[i];
+        size_t end = i + 1 < lines->count ? lines->lines[i + 1].start - 1 : str->length;
+        size_t position = line->start;
+        int indent = 0;
+
+        for (; indent < level && position < line->indent_end; position++) {
+            indent += string_data(str)[position] == '\t' ? 4 : 1;
+        }
 
-        if (ident) {
-            g_scanner.number += ident;
-            return State_BlockStringEnd1;
+        /// Lines without any content do not need the whole indentation
+        if (indent < level && position < end) {
+            eprintf("string_remove_ident: cannot remove ident of %d levels for the given string\n%s\n", level,
+                    string_data(str));
+            set_error(Error_Lexical);
+            return false;
         }
+
+        line->indent_end = position;
     }
 
-    if (ch == '"') {
-        switch (nth) {
-            case 1:
-                return State_BlockStringEnd2;
-            case 2:
-                return State_BlockStringEnd3;
-            case 3: {
-                string_remove_ident(&g_scanner.string, g_scanner.number);
+    size_t length = 0;
 
-                if (got_error()) {
-                    set_error(Error_Lexical);
-                    return State_EOF;
-                }
+    for (size_t i = 0; i < lines->count; i++) {
+        size_t start = lines->lines[i].indent_end;
+        size_t end = i + 1 < lines->count ? lines->lines[i + 1].start : str->length;
 
-                return State_StringEnd;
-            }
-            default: {
-                set_error(Error_Internal);
-                print_position();
-                eprint("Something when wrong");
-                return State_EOF;
-            }
-        }
+        memmove(string_data(str) + length, string_data(str) + start, end - start);
+        length += end - start;
     }
 
-    while (g_scanner.number--) {
-        string_push(&g_scanner.string, ' ');
+    if (string_data(str)) {
+        str->length = length;
+        string_data(str)[length] = '\0';
     }
 
-    while (nth-- > 0) {
-        string_push(&g_scanner.string, '"');
+    return true;
+}
 
-        if (got_error()) {
-            return State_EOF;
+/// The indentation of a block string line ended, `nth - 1` quotes after it were read so far
+static State step_block_string_end(char ch, int nth) {
+    if (nth == 1 && (ch == ' ' || ch == '\t')) {
+        string_push(&g_scanner.string, ch);
+        g_scanner.number += ch == '\t' ? 4 : 1;
+        return got_error() ? State_EOF : State_BlockStringEnd1;
+    }
+
+    if (ch == '"' && nth < 3) {
+        return nth == 1 ? State_BlockStringEnd2 : State_BlockStringEnd3;
+    }
+
+    if (ch == '"') {
+        /// The closing line and the newline before it are not a part of the literal
+        size_t start = g_scanner.block_line_start;
+        g_scanner.string.length = start ? start - 1 : 0;
+
+        if (string_data(&g_scanner.string)) {
+            string_data(&g_scanner.string)[g_scanner.string.length] = '\0';
         }
+
+        return scanner_strip_block_indent(g_scanner.number) ? State_StringEnd : State_EOF;
     }
 
-    return State_BlockString;
+    /// The line has a content, the quotes read so far belong to it and the DFA continues with `ch`
+    BlockLine line = {.start = g_scanner.block_line_start, .indent_end = g_scanner.string.length};
+
+    if (!block_lines_push(&g_scanner.block_lines, line)) {
+        return State_EOF;
+    }
+
+    while (nth-- > 1) {
+        string_push(&g_scanner.string, '"');
+    }
+
+    scanner_step_back();
+    return got_error() ? State_EOF : State_BlockString;
 }
 
 State step_comment_block(char ch) {
@@ -1123,14 +2403,19 @@ State step_comment_block(char ch) {
 
         case State_BlockCommentStart:
             g_scanner.comment_block_level += 1;
-            scanner_step_back(ch);
+            scanner_step_back();
             return State_Start;
 
         case State_BlockCommentEnd:
             /// Doesn't need to check for underflow since we only get
             /// into this scope when the `comment_block_level` is greater than 0
             g_scanner.comment_block_level -= 1;
-            scanner_step_back(ch);
+
+            /// When leaving the outermost comment, `scanner_advance` steps back on its own
+            if (g_scanner.comment_block_level) {
+                scanner_step_back();
+            }
+
             return State_Start;
 
         default:
@@ -1154,15 +2439,8 @@ static State step_whitespace(char ch) {
     }
 }
 
-static State step(char ch) {
-    if (ch == '\n') {
-        g_scanner.has_eol = true;
-    }
-
-    if (g_scanner.comment_block_level) {
-        return step_comment_block(ch);
-    }
-
+/// Reference implementation of a single DFA step, dispatching to the `step_*` function of the current state.
+static State step_reference(char ch) {
     switch (g_scanner.current_state) {
         case State_EOF:
             return State_EOF;
@@ -1205,6 +2483,8 @@ static State step(char ch) {
             return step_string_escape_hex(ch, 1, true);
         case State_LineStringEscapeHex2:
             return step_string_escape_hex(ch, 2, true);
+        case State_LineStringUtf8:
+            return step_string_utf8(ch, true);
         case State_BlockString:
             return step_block_string(ch);
         case State_BlockStringStart:
@@ -1225,6 +2505,8 @@ static State step(char ch) {
             return step_string_escape_hex(ch, 1, false);
         case State_BlockStringEscapeHex2:
             return step_string_escape_hex(ch, 2, false);
+        case State_BlockStringUtf8:
+            return step_string_utf8(ch, false);
 
         case State_Minus:
             return ch == '>' ? State_ArrowRight : State_Start;
@@ -1265,19 +2547,451 @@ static State step(char ch) {
 
         case State_BlockCommentStart:
             g_scanner.comment_block_level += 1;
-            scanner_step_back(ch);
+            scanner_step_back();
             return State_Start;
 
         case State_BlockCommentEnd:
-            /// We already ensure that we are currently outside of the comment block
-            /// at the beginning of this function
+            /// Inside of a comment block `step_comment_block` is used instead of this function
             print_position();
             eprint("unexpected end of block comment");
             set_error(Error_Lexical);
             return State_EOF;
+
+        case State_Count:
+            break;
     }
 
     set_error(Error_Lexical);
     eprint("Unreachable");
     return State_EOF;
 }
+
+#ifdef SCANNER_REFERENCE_DFA
+
+/// The reference DFA does not use any table
+static void table_build() {}
+
+static State step(char ch) {
+    if (ch == '\n') {
+        g_scanner.has_eol = true;
+    }
+
+    if (g_scanner.comment_block_level) {
+        return step_comment_block(ch);
+    }
+
+    return step_reference(ch);
+}
+
+#else
+
+/// Character classes of the table driven DFA. Bytes in the same class behave the same in every state.
+typedef enum {
+    /// Control characters and bytes outside of ASCII
+    CharClass_Control,
+    /// Printable characters without any special meaning
+    CharClass_Other,
+    CharClass_Space,
+    CharClass_Tab,
+    CharClass_Newline,
+    /// \r, \v, \f and \0
+    CharClass_WhitespaceControl,
+    CharClass_Digit,
+    /// a-f and A-F except for `e` and `E`
+    CharClass_HexLetter,
+    CharClass_LetterE,
+    /// `n`, `r` and `t` used in escape sequences
+    CharClass_LetterEscape,
+    CharClass_LetterU,
+    /// Rest of the letters and `_`
+    CharClass_Letter,
+    CharClass_Colon,
+    CharClass_BraceLeft,
+    CharClass_BraceRight,
+    CharClass_ParenLeft,
+    CharClass_ParenRight,
+    CharClass_Plus,
+    CharClass_Minus,
+    CharClass_Star,
+    CharClass_Slash,
+    CharClass_Equal,
+    CharClass_Less,
+    CharClass_Greater,
+    CharClass_Pipe,
+    CharClass_Ampersand,
+    CharClass_Bang,
+    CharClass_Question,
+    CharClass_Quote,
+    CharClass_Comma,
+    CharClass_Dot,
+    CharClass_Backslash,
+
+    CharClass_Count,
+} CharClass;
+
+// clang-format off
+static const unsigned char CHAR_CLASS[256] = {
+    ['\0'] = CharClass_WhitespaceControl, ['\r'] = CharClass_WhitespaceControl,
+    ['\v'] = CharClass_WhitespaceControl, ['\f'] = CharClass_WhitespaceControl,
+    [' '] = CharClass_Space, ['\t'] = CharClass_Tab, ['\n'] = CharClass_Newline,
+
+    ['0'] = CharClass_Digit, ['1'] = CharClass_Digit, ['2'] = CharClass_Digit, ['3'] = CharClass_Digit,
+    ['4'] = CharClass_Digit, ['5'] = CharClass_Digit, ['6'] = CharClass_Digit, ['7'] = CharClass_Digit,
+    ['8'] = CharClass_Digit, ['9'] = CharClass_Digit,
+
+    ['a'] = CharClass_HexLetter, ['b'] = CharClass_HexLetter, ['c'] = CharClass_HexLetter,
+    ['d'] = CharClass_HexLetter, ['f'] = CharClass_HexLetter, ['A'] = CharClass_HexLetter,
+    ['B'] = CharClass_HexLetter, ['C'] = CharClass_HexLetter, ['D'] = CharClass_HexLetter,
+    ['F'] = CharClass_HexLetter,
+    ['e'] = CharClass_LetterE, ['E'] = CharClass_LetterE,
+    ['n'] = CharClass_LetterEscape, ['r'] = CharClass_LetterEscape, ['t'] = CharClass_LetterEscape,
+    ['u'] = CharClass_LetterU,
+
+    ['g'] = CharClass_Letter, ['h'] = CharClass_Letter, ['i'] = CharClass_Letter, ['j'] = CharClass_Letter,
+    ['k'] = CharClass_Letter, ['l'] = CharClass_Letter, ['m'] = CharClass_Letter, ['o'] = CharClass_Letter,
+    ['p'] = CharClass_Letter, ['q'] = CharClass_Letter, ['s'] = CharClass_Letter, ['v'] = CharClass_Letter,
+    ['w'] = CharClass_Letter, ['x'] = CharClass_Letter, ['y'] = CharClass_Letter, ['z'] = CharClass_Letter,
+    ['G'] = CharClass_Letter, ['H'] = CharClass_Letter, ['I'] = CharClass_Letter, ['J'] = CharClass_Letter,
+    ['K'] = CharClass_Letter, ['L'] = CharClass_Letter, ['M'] = CharClass_Letter, ['N'] = CharClass_Letter,
+    ['O'] = CharClass_Letter, ['P'] = CharClass_Letter, ['Q'] = CharClass_Letter, ['R'] = CharClass_Letter,
+    ['S'] = CharClass_Letter, ['T'] = CharClass_Letter, ['U'] = CharClass_Letter, ['V'] = CharClass_Letter,
+    ['W'] = CharClass_Letter, ['X'] = CharClass_Letter, ['Y'] = CharClass_Letter, ['Z'] = CharClass_Letter,
+    ['_'] = CharClass_Letter,
+
+    [':'] = CharClass_Colon, ['{'] = CharClass_BraceLeft, ['}'] = CharClass_BraceRight,
+    ['('] = CharClass_ParenLeft, [')'] = CharClass_ParenRight, ['+'] = CharClass_Plus,
+    ['-'] = CharClass_Minus, ['*'] = CharClass_Star, ['/'] = CharClass_Slash,
+    ['='] = CharClass_Equal, ['<'] = CharClass_Less, ['>'] = CharClass_Greater,
+    ['|'] = CharClass_Pipe, ['&'] = CharClass_Ampersand, ['!'] = CharClass_Bang,
+    ['?'] = CharClass_Question, ['"'] = CharClass_Quote, [','] = CharClass_Comma,
+    ['.'] = CharClass_Dot, ['\\'] = CharClass_Backslash,
+
+    ['#'] = CharClass_Other, ['$'] = CharClass_Other, ['%'] = CharClass_Other, ['\''] = CharClass_Other,
+    [';'] = CharClass_Other, ['@'] = CharClass_Other, ['['] = CharClass_Other, [']'] = CharClass_Other,
+    ['^'] = CharClass_Other, ['`'] = CharClass_Other, ['~'] = CharClass_Other, [0x7F] = CharClass_Other,
+};
+// clang-format on
+
+/// Side effect performed when taking a transition of the table driven DFA.
+typedef enum {
+    Action_None,
+    /// Push the character into the string buffer
+    Action_Push,
+    Action_IdentifierBegin,
+    /// Remember where the numeric literal starts, its value is computed when it ends
+    Action_NumberBegin,
+    /// Give the character back to the input
+    Action_StepBack,
+    Action_PushEscape,
+    /// Start a line string literal as a span of the input
+    Action_LineStringBegin,
+    /// Copy the span of the string literal into `g_scanner.string` before the first escape is decoded
+    Action_EscapeBegin,
+    Action_HexBegin,
+    Action_HexPush,
+    Action_HexEnd,
+    Action_BlockIndent,
+    Action_CommentOpen,
+    Action_CommentClose,
+    /// Rare transitions (errors, block string ends, optional types) are left to the reference `step_*` functions
+    Action_Reference,
+} Action;
+
+typedef struct {
+    unsigned char next;    ///< Next State
+    unsigned char action;  ///< Action performed before moving to `next`
+} Transition;
+
+/// Transitions outside of block comments
+static Transition g_transitions[State_Count][CharClass_Count];
+/// Transitions inside of block comments
+static Transition g_comment_transitions[State_Count][CharClass_Count];
+
+static void table_row(Transition (*table)[CharClass_Count], State state, State next, Action action) {
+    for (int cls = 0; cls < CharClass_Count; cls++) {
+        table[state][cls] = (Transition){.next = next, .action = action};
+    }
+}
+
+static void table_set(Transition (*table)[CharClass_Count], State state, CharClass cls, State next, Action action) {
+    table[state][cls] = (Transition){.next = next, .action = action};
+}
+
+/// Set transition for every class that can continue an identifier
+static void table_set_letters(State state, State next, Action action) {
+    table_set(g_transitions, state, CharClass_HexLetter, next, action);
+    table_set(g_transitions, state, CharClass_LetterE, next, action);
+    table_set(g_transitions, state, CharClass_LetterEscape, next, action);
+    table_set(g_transitions, state, CharClass_LetterU, next, action);
+    table_set(g_transitions, state, CharClass_Letter, next, action);
+}
+
+static void table_set_hex(State state, State next, Action action) {
+    table_set(g_transitions, state, CharClass_Digit, next, action);
+    table_set(g_transitions, state, CharClass_HexLetter, next, action);
+    table_set(g_transitions, state, CharClass_LetterE, next, action);
+}
+
+static void table_set_whitespace(State state, State next, Action action) {
+    table_set(g_transitions, state, CharClass_Space, next, action);
+    table_set(g_transitions, state, CharClass_Tab, next, action);
+    table_set(g_transitions, state, CharClass_Newline, next, action);
+    table_set(g_transitions, state, CharClass_WhitespaceControl, next, action);
+}
+
+static void table_build_string(bool is_line_string) {
+    State string = is_line_string ? State_LineString : State_BlockString;
+    State escape = is_line_string ? State_LineStringEscape : State_BlockStringEscape;
+    State unicode = is_line_string ? State_LineStringEscapeUnicode : State_BlockStringEscapeUnicode;
+    State hex_start = is_line_string ? State_LineStringEscapeHexStart : State_BlockStringEscapeHexStart;
+    State hex1 = is_line_string ? State_LineStringEscapeHex1 : State_BlockStringEscapeHex1;
+    State hex2 = is_line_string ? State_LineStringEscapeHex2 : State_BlockStringEscapeHex2;
+    State utf8 = is_line_string ? State_LineStringUtf8 : State_BlockStringUtf8;
+
+    table_row(g_transitions, string, string, Action_Push);
+    table_set(g_transitions, string, CharClass_Backslash, escape, Action_EscapeBegin);
+    table_set(g_transitions, string, CharClass_Control, State_EOF, Action_Reference);
+    table_set(g_transitions, string, CharClass_Tab, State_EOF, Action_Reference);
+    table_set(g_transitions, string, CharClass_WhitespaceControl, State_EOF, Action_Reference);
+
+    if (is_line_string) {
+        table_set(g_transitions, string, CharClass_Quote, State_StringEnd, Action_None);
+        table_set(g_transitions, string, CharClass_Newline, State_EOF, Action_Reference);
+    } else {
+        table_set(g_transitions, string, CharClass_Newline, State_BlockStringEnd1, Action_Reference);
+    }
+
+    table_row(g_transitions, escape, State_EOF, Action_Reference);
+    table_set(g_transitions, escape, CharClass_Backslash, string, Action_PushEscape);
+    table_set(g_transitions, escape, CharClass_Quote, string, Action_PushEscape);
+    table_set(g_transitions, escape, CharClass_LetterEscape, string, Action_PushEscape);
+    table_set(g_transitions, escape, CharClass_LetterU, unicode, Action_None);
+
+    table_row(g_transitions, unicode, State_EOF, Action_Reference);
+    table_set(g_transitions, unicode, CharClass_BraceLeft, hex_start, Action_None);
+
+    table_row(g_transitions, hex_start, State_EOF, Action_Reference);
+    table_set_hex(hex_start, hex1, Action_HexBegin);
+
+    table_row(g_transitions, hex1, State_EOF, Action_Reference);
+    table_set_hex(hex1, hex2, Action_HexPush);
+    table_set(g_transitions, hex1, CharClass_BraceRight, string, Action_HexEnd);
+
+    table_row(g_transitions, hex2, State_EOF, Action_Reference);
+    table_set(g_transitions, hex2, CharClass_BraceRight, string, Action_HexEnd);
+
+    /// Bytes outside of ASCII are in `CharClass_Control`, their sequences are validated by the reference functions
+    table_row(g_transitions, utf8, State_EOF, Action_Reference);
+}
+
+/// Fill both transition tables. Mirrors the reference `step_*` functions state by state.
+static void table_build() {
+    static bool built = false;
+
+    if (built) {
+        return;
+    }
+
+    /// Single character tokens and finished multi character tokens
+    for (int state = 0; state < State_Count; state++) {
+        table_row(g_transitions, state, State_Start, Action_None);
+        table_row(g_comment_transitions, state, State_Start, Action_None);
+    }
+
+    table_row(g_transitions, State_EOF, State_EOF, Action_None);
+
+    table_row(g_transitions, State_Start, State_EOF, Action_Reference);
+    table_set(g_transitions, State_Start, CharClass_Digit, State_Number, Action_NumberBegin);
+    table_set_letters(State_Start, State_Identifier, Action_IdentifierBegin);
+    table_set_whitespace(State_Start, State_Whitespace, Action_None);
+    table_set(g_transitions, State_Start, CharClass_Colon, State_DoubleColon, Action_None);
+    table_set(g_transitions, State_Start, CharClass_BraceRight, State_BracketRight, Action_None);
+    table_set(g_transitions, State_Start, CharClass_BraceLeft, State_BracketLeft, Action_None);
+    table_set(g_transitions, State_Start, CharClass_ParenRight, State_ParenRight, Action_None);
+    table_set(g_transitions, State_Start, CharClass_ParenLeft, State_ParenLeft, Action_None);
+    table_set(g_transitions, State_Start, CharClass_Plus, State_Plus, Action_None);
+    table_set(g_transitions, State_Start, CharClass_Minus, State_Minus, Action_None);
+    table_set(g_transitions, State_Start, CharClass_Star, State_Multiply, Action_None);
+    table_set(g_transitions, State_Start, CharClass_Slash, State_Divide, Action_None);
+    table_set(g_transitions, State_Start, CharClass_Equal, State_EqualSign, Action_None);
+    table_set(g_transitions, State_Start, CharClass_Less, State_LessThan, Action_None);
+    table_set(g_transitions, State_Start, CharClass_Greater, State_MoreThan, Action_None);
+    table_set(g_transitions, State_Start, CharClass_Pipe, State_Pipe, Action_None);
+    table_set(g_transitions, State_Start, CharClass_Ampersand, State_Ampersand, Action_None);
+    table_set(g_transitions, State_Start, CharClass_Bang, State_Negation, Action_None);
+    table_set(g_transitions, State_Start, CharClass_Question, State_QuestionMark, Action_None);
+    table_set(g_transitions, State_Start, CharClass_Quote, State_StringStart, Action_None);
+    table_set(g_transitions, State_Start, CharClass_Comma, State_Comma, Action_None);
+
+    table_set_whitespace(State_Whitespace, State_Whitespace, Action_None);
+
+    table_row(g_transitions, State_QuestionMark, State_EOF, Action_Reference);
+    table_set(g_transitions, State_QuestionMark, CharClass_Question, State_DoubleQuestionMark, Action_None);
+
+    table_set(g_transitions, State_Divide, CharClass_Star, State_BlockCommentStart, Action_None);
+    table_set(g_transitions, State_Divide, CharClass_Slash, State_LineComment, Action_None);
+
+    table_set_letters(State_Identifier, State_Identifier, Action_Push);
+    table_set(g_transitions, State_Identifier, CharClass_Digit, State_Identifier, Action_Push);
+    table_set(g_transitions, State_Identifier, CharClass_Question, State_EOF, Action_Reference);
+
+    table_set(g_transitions, State_Number, CharClass_Dot, State_NumberDoubleStart, Action_None);
+    table_set(g_transitions, State_Number, CharClass_LetterE, State_NumberExponentStart, Action_None);
+    table_set(g_transitions, State_Number, CharClass_Digit, State_Number, Action_None);
+
+    table_row(g_transitions, State_NumberDoubleStart, State_EOF, Action_Reference);
+    table_set(g_transitions, State_NumberDoubleStart, CharClass_Digit, State_NumberDouble, Action_None);
+
+    table_set(g_transitions, State_NumberDouble, CharClass_LetterE, State_NumberExponentStart, Action_None);
+    table_set(g_transitions, State_NumberDouble, CharClass_Digit, State_NumberDouble, Action_None);
+
+    table_row(g_transitions, State_NumberExponentStart, State_EOF, Action_Reference);
+    table_set(g_transitions, State_NumberExponentStart, CharClass_Plus, State_NumberExponentSign, Action_None);
+    table_set(g_transitions, State_NumberExponentStart, CharClass_Minus, State_NumberExponentSign, Action_None);
+    table_set(g_transitions, State_NumberExponentStart, CharClass_Digit, State_NumberExponent, Action_None);
+
+    table_row(g_transitions, State_NumberExponentSign, State_EOF, Action_Reference);
+    table_set(g_transitions, State_NumberExponentSign, CharClass_Digit, State_NumberExponent, Action_None);
+
+    table_set(g_transitions, State_NumberExponent, CharClass_Digit, State_NumberExponent, Action_None);
+
+    table_row(g_transitions, State_StringStart, State_LineString, Action_LineStringBegin);
+    table_set(g_transitions, State_StringStart, CharClass_Quote, State_DoubleQuote, Action_None);
+
+    table_row(g_transitions, State_DoubleQuote, State_StringEnd, Action_StepBack);
+    table_set(g_transitions, State_DoubleQuote, CharClass_Quote, State_BlockStringStart, Action_None);
+
+    table_build_string(true);
+    table_build_string(false);
+
+    table_row(g_transitions, State_BlockStringStart, State_EOF, Action_Reference);
+    table_set(g_transitions, State_BlockStringStart, CharClass_Newline, State_BlockStringEnd1, Action_Reference);
+
+    table_row(g_transitions, State_BlockStringEnd1, State_EOF, Action_Reference);
+    table_set(g_transitions, State_BlockStringEnd1, CharClass_Space, State_BlockStringEnd1, Action_BlockIndent);
+    table_set(g_transitions, State_BlockStringEnd1, CharClass_Tab, State_BlockStringEnd1, Action_BlockIndent);
+    table_set(g_transitions, State_BlockStringEnd1, CharClass_Quote, State_BlockStringEnd2, Action_None);
+
+    table_row(g_transitions, State_BlockStringEnd2, State_EOF, Action_Reference);
+    table_set(g_transitions, State_BlockStringEnd2, CharClass_Quote, State_BlockStringEnd3, Action_None);
+
+    table_row(g_transitions, State_BlockStringEnd3, State_EOF, Action_Reference);
+
+    table_set(g_transitions, State_Minus, CharClass_Greater, State_ArrowRight, Action_None);
+    table_set(g_transitions, State_EqualSign, CharClass_Equal, State_DoubleEqualSign, Action_None);
+    table_set(g_transitions, State_LessThan, CharClass_Equal, State_LessOrEqual, Action_None);
+    table_set(g_transitions, State_MoreThan, CharClass_Equal, State_MoreOrEqual, Action_None);
+    table_set(g_transitions, State_Negation, CharClass_Equal, State_NotEqual, Action_None);
+    table_set(g_transitions, State_Pipe, CharClass_Pipe, State_Or, Action_None);
+    table_set(g_transitions, State_Ampersand, CharClass_Ampersand, State_And, Action_None);
+
+    table_row(g_transitions, State_LineComment, State_LineComment, Action_None);
+    table_set(g_transitions, State_LineComment, CharClass_Newline, State_Whitespace, Action_None);
+
+    table_row(g_transitions, State_BlockCommentStart, State_Start, Action_CommentOpen);
+    table_row(g_transitions, State_BlockCommentEnd, State_EOF, Action_Reference);
+
+    /// Inside of a block comment we only look for nested openings and closings
+    table_set(g_comment_transitions, State_Start, CharClass_Slash, State_Divide, Action_None);
+    table_set(g_comment_transitions, State_Start, CharClass_Star, State_Multiply, Action_None);
+    table_set(g_comment_transitions, State_Divide, CharClass_Star, State_BlockCommentStart, Action_None);
+    table_set(g_comment_transitions, State_Divide, CharClass_Slash, State_Divide, Action_None);
+    table_set(g_comment_transitions, State_Multiply, CharClass_Star, State_Multiply, Action_None);
+    table_set(g_comment_transitions, State_Multiply, CharClass_Slash, State_BlockCommentEnd, Action_None);
+    table_row(g_comment_transitions, State_BlockCommentStart, State_Start, Action_CommentOpen);
+    table_row(g_comment_transitions, State_BlockCommentEnd, State_Start, Action_CommentClose);
+
+    built = true;
+}
+
+/// Table driven DFA step. Produces the same states and side effects as `step_reference`.
+static State step_table(char ch) {
+    Transition (*table)[CharClass_Count] = g_scanner.comment_block_level ? g_comment_transitions : g_transitions;
+    Transition transition = table[g_scanner.current_state][CHAR_CLASS[(unsigned char)ch]];
+
+    switch ((Action)transition.action) {
+        case Action_None:
+            break;
+        case Action_Push:
+            if (!g_scanner.string_is_span) {
+                string_push(&g_scanner.string, ch);
+            }
+            break;
+        case Action_IdentifierBegin:
+            string_clear(&g_scanner.string);
+            string_push(&g_scanner.string, ch);
+            break;
+        case Action_NumberBegin:
+            g_scanner.number_start = g_scanner.input.current_position - 1;
+            break;
+        case Action_StepBack:
+            scanner_step_back();
+            break;
+        case Action_LineStringBegin:
+            scanner_step_back();
+            g_scanner.string_is_span = true;
+            g_scanner.string_start = g_scanner.input.current_position;
+            break;
+        case Action_EscapeBegin:
+            if (g_scanner.string_is_span) {
+                const char* start = g_scanner.input.data + g_scanner.string_start;
+                size_t length = g_scanner.input.current_position - 1 - g_scanner.string_start;
+
+                string_clear(&g_scanner.string);
+                string_append_n(&g_scanner.string, start, length);
+
+                if (got_error()) {
+                    return State_EOF;
+                }
+
+                g_scanner.string_is_span = false;
+            }
+            break;
+        case Action_PushEscape:
+            string_push(&g_scanner.string, ch == 'r' ? '\r' : ch == 't' ? '\t' : ch == 'n' ? '\n' : ch);
+            break;
+        case Action_HexBegin:
+            g_scanner.number = parse_hexadecimal(ch);
+            break;
+        case Action_HexPush:
+            g_scanner.number = g_scanner.number * 16 + parse_hexadecimal(ch);
+            break;
+        case Action_HexEnd:
+            scanner_push_code_point(g_scanner.number);
+            break;
+        case Action_BlockIndent:
+            string_push(&g_scanner.string, ch);
+            g_scanner.number += ch == '\t' ? 4 : 1;
+            break;
+        case Action_CommentOpen:
+            g_scanner.comment_block_level += 1;
+            scanner_step_back();
+            break;
+        case Action_CommentClose:
+            g_scanner.comment_block_level -= 1;
+
+            /// When leaving the outermost comment, `scanner_advance` steps back on its own
+            if (g_scanner.comment_block_level) {
+                scanner_step_back();
+            }
+            break;
+        case Action_Reference:
+            return step_reference(ch);
+    }
+
+    if (got_error()) {
+        return State_EOF;
+    }
+
+    return transition.next;
+}
+
+static State step(char ch) {
+    if (ch == '\n') {
+        g_scanner.has_eol = true;
+    }
+
+    return step_table(ch);
+}
+
+#endif
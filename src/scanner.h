@@ -13,7 +13,9 @@
 #define SCANNER_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
+#include "intern.h"
 #include "string.h"
 
 /// Represents data type
@@ -34,7 +36,7 @@ typedef enum {
 
 typedef union {
     String string;
-    int number;
+    int64_t number;
     double number_double;
     bool is_true;
 } DataValue;
@@ -128,16 +130,20 @@ typedef union {
 
 typedef struct Token {
     TokenType type;
+    /// Interned name of `Token_Identifier`, `SYMBOL_NONE` for other tokens
+    SymbolId symbol;
     TokenAttribute attribute;
-    size_t line;
-    size_t position_in_line;
+    /// Offset of the byte that ended the token in the input, the one right after its last byte. Merged whitespaces and
+    /// comments end where the first of them does. See `scanner_position` for its line and column
+    size_t offset;
 } Token;
 
 /**
  * @brief Initialize a Scanner instance with a source file.
  *
  * This function initializes the scanner with the provided source file. It prepares the scanner
- * to start analyzing the source file.
+ * to start analyzing the source file. Regular files are mapped into memory, other streams (pipes, terminals)
+ * are read whole using large block reads, so the scanner always works over a contiguous span of bytes.
  *
  * @param[in] src Pointer to the source file to be analyzed.
  */
@@ -160,6 +166,28 @@ void scanner_init_str(const char* str);
  */
 void scanner_free();
 
+/**
+ * @brief Find the line and the column of an offset in the input.
+ *
+ * The tokens keep only their offset. The line starts of the input are found on the first call and the position is
+ * looked up by a binary search, so nothing is tracked per byte while scanning.
+ *
+ * @param[in] offset Offset in the input, e.g. `Token::offset`.
+ * @param[out] line 1-based line of the offset, 0 if the scanner is not initialized.
+ * @param[out] column Number of bytes before the offset on its line.
+ */
+void scanner_position(size_t offset, size_t* line, size_t* column);
+
+/// Tokens replaced by `scanner_edit`
+typedef struct {
+    /// Index of the first token that changed, the tokens before it are kept
+    unsigned first;
+    /// Number of the old tokens that were replaced
+    unsigned removed;
+    /// Number of the new tokens in their place, the tokens after them are the old ones
+    unsigned inserted;
+} TokenEdit;
+
 /**
  * @brief Reset the scanner to its initial position in the input source.
  *
@@ -170,6 +198,58 @@ void scanner_free();
  */
 void scanner_reset_to_beginning();
 
+/**
+ * @brief Apply an edit to the input and scan again only the tokens it affects.
+ *
+ * The scanning starts after the last token that ends before the edit and stops as soon as a token ends at the same
+ * byte after the edit as one of the old tokens, since the scanner is in the same state there. The tokens before
+ * the edit are not touched and the tokens after the scanned ones are kept, only moved. If the tokens were not all
+ * scanned yet or the edited part has an error, the tokens from the edit on are dropped and scanned again
+ * as they are requested, so the error is reported the same way as in a scan from the start.
+ *
+ * The scanner is reset to the beginning afterwards, the same as by `scanner_reset_to_beginning`.
+ *
+ * @note Not available in the streaming mode, the InternalError is set.
+ *
+ * @param[in] offset Offset of the first edited byte of the input.
+ * @param[in] removed Number of bytes removed at `offset`.
+ * @param[in] inserted Text inserted at `offset`.
+ * @return Range of the tokens that were replaced.
+ */
+TokenEdit scanner_edit(size_t offset, size_t removed, const char* inserted);
+
+/**
+ * @brief Select whether the scanner retains the whole token stream.
+ *
+ * By default every token is retained, so `scanner_reset_to_beginning` replays them without scanning the input
+ * again. In the streaming mode only a few most recent tokens are kept and a reset scans the input again, so the
+ * memory does not grow with the size of the input. Inputs of 16 MiB and more are streamed by default.
+ *
+ * @note In the streaming mode the payload of a string literal stays valid only until 16 more string literals
+ *       are scanned. Clone it if it is needed for longer.
+ * @note Has to be called after the initialization and before the first token is scanned,
+ *       otherwise the InternalError is set.
+ *
+ * @param[in] streaming true to enable the streaming mode, false to retain all tokens.
+ */
+void scanner_set_streaming(bool streaming);
+
+/**
+ * @brief Select the number of threads scanning the input.
+ *
+ * With more than one thread the whole input is scanned ahead when the first token is requested. It is split into
+ * parts at newlines, each scanned by its own thread, and the tokens are joined in order, so the result is the same
+ * as of the serial scan. A part that does not start outside of a block comment or a multi-line string fails and
+ * the input is scanned serially from there on. Inputs of 1 MiB and more are scanned on all processors by default.
+ *
+ * @note Disables the streaming mode if `threads` is more than 1.
+ * @note Has to be called after the initialization and before the first token is scanned,
+ *       otherwise the InternalError is set.
+ *
+ * @param[in] threads Number of threads, 1 for the serial scan.
+ */
+void scanner_set_threads(unsigned threads);
+
 /**
  * @brief Advance the scanner to recognize the next token.
  *
@@ -179,6 +259,10 @@ void scanner_reset_to_beginning();
  * @note If the attribute is of type String (Identifier or Data) and you intend to use it as your
  *       own string, it's important to clone it using the `string_clone` function. You are then
  *       responsible for deallocating this cloned string when you're done with it.
+ *       The string of an Identifier is owned by the interner (see intern.h) and is shared by all
+ *       occurrences of the same name, `Token::symbol` holds its symbol ID.
+ *       The string of a string literal without escape sequences borrows the bytes of the input and is
+ *       not null terminated, always use its `length`. It stays valid until `scanner_free`.
  *       If one or more errors occur during tokenization, the LexicalError or InternalError will be set.
  *
  * @return The recognized Token.
@@ -0,0 +1,207 @@
+/**
+ * @note Project: Implementace překladače imperativního jazyka IFJ23
+ * @file scanner_number.c
+ * @author agent, agent, VUT FIT
+ * @date 16/10/2026
+ * @brief Implementation for the scanner_number.h
+ */
+
+#include "scanner_number.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "error.h"
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define NUMBER_SWAR
+#endif
+
+/// Up to 19 decimal digits always fit `uint64_t`
+#define MAX_DIGITS 19
+/// Integers up to 2^53 are exact in a double
+#define MAX_EXACT_MANTISSA (1ull << 53)
+/// Bigger exponents are clamped, the result is 0 or infinity long before
+#define MAX_EXPONENT 100000
+
+/// Powers of ten that are exact in a double
+static const double c_pow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+#define MAX_EXACT_POW10 22
+
+static bool is_digit(char ch) {
+    return ch >= '0' && ch <= '9';
+}
+
+#ifdef NUMBER_SWAR
+
+static uint64_t load_eight(const char* data) {
+    uint64_t chunk;
+    memcpy(&chunk, data, sizeof(chunk));
+    return chunk;
+}
+
+/// Check that all 8 bytes of the chunk are decimal digits
+static bool is_eight_digits(uint64_t chunk) {
+    return !(((chunk + 0x4646464646464646) | (chunk - 0x3030303030303030)) & 0x8080808080808080);
+}
+
+/// Value of 8 digits, the first digit is in the lowest byte
+static uint32_t parse_eight_digits(uint64_t chunk) {
+    const uint64_t mask = 0x000000FF000000FF;
+    const uint64_t mul1 = 100 + (1000000ull << 32);
+    const uint64_t mul2 = 1 + (10000ull << 32);
+
+    chunk -= 0x3030303030303030;
+    chunk = chunk * 10 + (chunk >> 8);
+    return (uint32_t)((((chunk & mask) * mul1) + (((chunk >> 16) & mask) * mul2)) >> 32);
+}
+
+#endif
+
+size_t number_skip_digits(const char* data, size_t position, size_t length) {
+#ifdef NUMBER_SWAR
+    while (length - position >= 8 && is_eight_digits(load_eight(data + position))) {
+        position += 8;
+    }
+#endif
+
+    while (position < length && is_digit(data[position])) {
+        position++;
+    }
+
+    return position;
+}
+
+/// Append the digits starting at `position` to `value`, wraps around if there are more than `MAX_DIGITS` of them
+static size_t accumulate_digits(const char* data, size_t position, size_t length, uint64_t* value) {
+#ifdef NUMBER_SWAR
+    while (length - position >= 8) {
+        uint64_t chunk = load_eight(data + position);
+
+        if (!is_eight_digits(chunk)) {
+            break;
+        }
+
+        *value = *value * 100000000 + parse_eight_digits(chunk);
+        position += 8;
+    }
+#endif
+
+    while (position < length && is_digit(data[position])) {
+        *value = *value * 10 + (data[position] - '0');
+        position++;
+    }
+
+    return position;
+}
+
+static size_t skip_zeros(const char* data, size_t position, size_t length) {
+    while (position < length && data[position] == '0') {
+        position++;
+    }
+
+    return position;
+}
+
+bool number_parse_int(const char* data, size_t length, int64_t* value) {
+    size_t start = skip_zeros(data, 0, length);
+    uint64_t result = 0;
+    size_t end = accumulate_digits(data, start, length, &result);
+
+    if (end - start > MAX_DIGITS || result > INT64_MAX) {
+        return false;
+    }
+
+    *value = (int64_t)result;
+    return true;
+}
+
+/// Correctly rounded conversion by the C library, used when the fast path cannot guarantee exactness
+static bool parse_double_slow(const char* data, size_t length, double* value) {
+    char buffer[64];
+    char* str = length < sizeof(buffer) ? buffer : malloc(length + 1);
+
+    if (!str) {
+        set_error(Error_Internal);
+        eprint("number: Out Of Memory\n");
+        return false;
+    }
+
+    memcpy(str, data, length);
+    str[length] = '\0';
+    *value = strtod(str, NULL);
+
+    if (str != buffer) {
+        free(str);
+    }
+
+    return !isinf(*value);
+}
+
+bool number_parse_double(const char* data, size_t length, double* value) {
+    uint64_t mantissa = 0;
+    size_t position = skip_zeros(data, 0, length);
+    size_t start = position;
+
+    position = accumulate_digits(data, position, length, &mantissa);
+    size_t digits = position - start;
+    long exponent = 0;
+
+    if (position < length && data[position] == '.') {
+        size_t fraction = ++position;
+
+        /// Zeros right after the point are not significant if there is nothing before them
+        if (!digits) {
+            position = skip_zeros(data, position, length);
+        }
+
+        start = position;
+        position = accumulate_digits(data, position, length, &mantissa);
+        digits += position - start;
+        exponent -= (long)(position - fraction);
+    }
+
+    if (position < length && (data[position] == 'e' || data[position] == 'E')) {
+        bool negative = ++position < length && data[position] == '-';
+        long exponent_value = 0;
+
+        if (position < length && (data[position] == '-' || data[position] == '+')) {
+            position++;
+        }
+
+        for (; position < length && is_digit(data[position]); position++) {
+            if (exponent_value < MAX_EXPONENT) {
+                exponent_value = exponent_value * 10 + (data[position] - '0');
+            }
+        }
+
+        exponent += negative ? -exponent_value : exponent_value;
+    }
+
+    if (!mantissa && digits <= MAX_DIGITS) {
+        *value = 0.0;
+        return true;
+    }
+
+    /// Clinger's fast path, both operands are exact so the single operation rounds correctly
+    if (digits <= MAX_DIGITS && mantissa <= MAX_EXACT_MANTISSA) {
+        if (exponent >= -MAX_EXACT_POW10 && exponent <= MAX_EXACT_POW10) {
+            *value = exponent < 0 ? (double)mantissa / c_pow10[-exponent] : (double)mantissa * c_pow10[exponent];
+            return true;
+        }
+
+        /// Move the exponent into the mantissa while it stays exact, e.g. `12e25` is `12000e22`
+        if (exponent > MAX_EXACT_POW10) {
+            for (; exponent > MAX_EXACT_POW10 && mantissa <= MAX_EXACT_MANTISSA / 10; exponent--) {
+                mantissa *= 10;
+            }
+
+            if (exponent == MAX_EXACT_POW10) {
+                *value = (double)mantissa * c_pow10[MAX_EXACT_POW10];
+                return true;
+            }
+        }
+    }
+
+    return parse_double_slow(data, length, value);
+}
@@ -0,0 +1,52 @@
+/**
+ * @note Project: Implementace překladače imperativního jazyka IFJ23
+ * @file scanner_number.h
+ * @author agent, agent, VUT FIT
+ * @date 16/10/2026
+ * @brief Conversion of numeric literals for the scanner.
+ *
+ * The scanner only validates the shape of a numeric literal, the value is computed once from the bytes of the
+ * whole literal. Digits are consumed 8 at a time (SWAR) and doubles are correctly rounded: literals that fit
+ * Clinger's fast path are converted exactly in `double` arithmetic, the rest is left to `strtod`.
+ */
+
+#ifndef SCANNER_NUMBER_H
+#define SCANNER_NUMBER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Skip a run of decimal digits.
+ *
+ * @param[in] data Bytes of the input.
+ * @param[in] position Index of the first byte of the run.
+ * @param[in] length Length of `data`.
+ * @return Index of the first byte that is not a digit or `length`.
+ */
+size_t number_skip_digits(const char* data, size_t position, size_t length);
+
+/**
+ * @brief Convert an integer literal.
+ *
+ * @param[in] data Digits of the literal, does not have to be null terminated.
+ * @param[in] length Number of digits.
+ * @param[out] value Value of the literal.
+ * @return `false` if the value does not fit a 64-bit signed integer.
+ */
+bool number_parse_int(const char* data, size_t length, int64_t* value);
+
+/**
+ * @brief Convert a double literal (`digits[.digits][(e|E)[+|-]digits]`) to the nearest double.
+ *
+ * Sets `Error_Internal` if out of memory.
+ *
+ * @param[in] data Bytes of the literal, does not have to be null terminated.
+ * @param[in] length Length of the literal.
+ * @param[out] value Value of the literal.
+ * @return `false` if the value is too large for a double or out of memory.
+ */
+bool number_parse_double(const char* data, size_t length, double* value);
+
+#endif
@@ -0,0 +1,345 @@
+/**
+ * @note Project: Implementace překladače imperativního jazyka IFJ23
+ * @file scanner_skip.c
+ * @author agent, agent, VUT FIT
+ * @date 16/10/2026
+ * @brief Implementation for the scanner_skip.h
+ */
+
+#include "scanner_skip.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SKIP_X86
+#include <immintrin.h>
+#endif
+
+typedef size_t (*SkipFn)(const char*, size_t, size_t, SkipKind, size_t*, size_t*);
+typedef size_t (*SkipStringFn)(const char*, size_t, size_t, bool);
+
+static size_t skip_resolve(const char* data, size_t position, size_t length, SkipKind kind, size_t* newlines,
+                           size_t* last_newline);
+static size_t skip_string_resolve(const char* data, size_t position, size_t length, bool is_line_string);
+
+/// Currently selected kernels, resolved on the first call
+static SkipFn g_skip = skip_resolve;
+static SkipStringFn g_skip_string = skip_string_resolve;
+
+static bool is_run_byte(unsigned char ch, SkipKind kind) {
+    switch (kind) {
+        case Skip_Whitespace:
+            return ch == ' ' || ch == '\0' || (ch >= '\t' && ch <= '\r');
+        case Skip_LineComment:
+            return ch != '\n';
+        case Skip_BlockComment:
+            return ch != '*' && ch != '/';
+    }
+
+    return false;
+}
+
+static size_t skip_scalar(const char* data, size_t position, size_t length, SkipKind kind, size_t* newlines,
+                          size_t* last_newline) {
+    while (position < length && is_run_byte(data[position], kind)) {
+        if (data[position] == '\n') {
+            *newlines += 1;
+            *last_newline = position;
+        }
+
+        position++;
+    }
+
+    return position;
+}
+
+/// Length of the valid UTF-8 sequence starting with a byte outside of ASCII, 0 if it is not valid or not complete
+static size_t utf8_sequence(const unsigned char* data, size_t position, size_t length) {
+    unsigned char lead = data[position];
+    /// Range of the second byte, it also refuses overlong forms, surrogates and code points above U+10FFFF
+    unsigned char low = 0x80;
+    unsigned char high = 0xBF;
+    size_t size;
+
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        size = 2;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+        size = 3;
+        low = lead == 0xE0 ? 0xA0 : 0x80;
+        high = lead == 0xED ? 0x9F : 0xBF;
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+        size = 4;
+        low = lead == 0xF0 ? 0x90 : 0x80;
+        high = lead == 0xF4 ? 0x8F : 0xBF;
+    } else {
+        return 0;
+    }
+
+    if (length - position < size || data[position + 1] < low || data[position + 1] > high) {
+        return 0;
+    }
+
+    for (size_t i = 2; i < size; i++) {
+        if (data[position + i] < 0x80 || data[position + i] > 0xBF) {
+            return 0;
+        }
+    }
+
+    return size;
+}
+
+static bool is_string_stop(unsigned char ch, bool is_line_string) {
+    return ch < 0x20 || ch == '\\' || (ch == '"' && is_line_string);
+}
+
+/// Skip the string run until `limit`, a sequence may end after it. Sets `stopped` if the run ended before `limit`.
+static size_t skip_string_until(const char* data, size_t position, size_t limit, size_t length, bool is_line_string,
+                                bool* stopped) {
+    const unsigned char* bytes = (const unsigned char*)data;
+
+    while (position < limit) {
+        if (bytes[position] < 0x80) {
+            if (is_string_stop(bytes[position], is_line_string)) {
+                *stopped = true;
+                return position;
+            }
+
+            position++;
+            continue;
+        }
+
+        size_t size = utf8_sequence(bytes, position, length);
+
+        if (!size) {
+            *stopped = true;
+            return position;
+        }
+
+        position += size;
+    }
+
+    *stopped = false;
+    return position;
+}
+
+static size_t skip_string_scalar(const char* data, size_t position, size_t length, bool is_line_string) {
+    bool stopped;
+    return skip_string_until(data, position, length, length, is_line_string, &stopped);
+}
+
+#ifdef SKIP_X86
+
+/// Count the newlines in `mask` of the block starting at `position`
+static void count_newlines(uint32_t mask, size_t position, size_t* newlines, size_t* last_newline) {
+    if (mask) {
+        *newlines += __builtin_popcount(mask);
+        *last_newline = position + 31 - __builtin_clz(mask);
+    }
+}
+
+__attribute__((target("sse2"))) static size_t skip_sse2(const char* data, size_t position, size_t length,
+                                                          SkipKind kind, size_t* newlines, size_t* last_newline) {
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i control_range = _mm_set1_epi8('\r' - '\t');
+    const __m128i star = _mm_set1_epi8('*');
+    const __m128i slash = _mm_set1_epi8('/');
+
+    for (; position + 16 <= length; position += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)(data + position));
+        uint32_t newline_mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, newline));
+        uint32_t stop_mask;
+
+        switch (kind) {
+            case Skip_Whitespace: {
+                /// \t..\r is checked as an unsigned range: (ch - '\t') <= '\r' - '\t'
+                __m128i shifted = _mm_sub_epi8(block, tab);
+                __m128i is_control = _mm_cmpeq_epi8(_mm_min_epu8(shifted, control_range), shifted);
+                __m128i is_space = _mm_or_si128(_mm_cmpeq_epi8(block, space), _mm_cmpeq_epi8(block, zero));
+                stop_mask = ~_mm_movemask_epi8(_mm_or_si128(is_control, is_space)) & 0xFFFF;
+                break;
+            }
+            case Skip_LineComment:
+                stop_mask = newline_mask;
+                break;
+            case Skip_BlockComment:
+            default:
+                stop_mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, star), _mm_cmpeq_epi8(block, slash)));
+                break;
+        }
+
+        if (stop_mask) {
+            int offset = __builtin_ctz(stop_mask);
+            count_newlines(newline_mask & ((1u << offset) - 1), position, newlines, last_newline);
+            return position + offset;
+        }
+
+        count_newlines(newline_mask, position, newlines, last_newline);
+    }
+
+    return skip_scalar(data, position, length, kind, newlines, last_newline);
+}
+
+__attribute__((target("avx2"))) static size_t skip_avx2(const char* data, size_t position, size_t length,
+                                                          SkipKind kind, size_t* newlines, size_t* last_newline) {
+    const __m256i newline = _mm256_set1_epi8('\n');
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i control_range = _mm256_set1_epi8('\r' - '\t');
+    const __m256i star = _mm256_set1_epi8('*');
+    const __m256i slash = _mm256_set1_epi8('/');
+
+    for (; position + 32 <= length; position += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)(data + position));
+        uint32_t newline_mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, newline));
+        uint32_t stop_mask;
+
+        switch (kind) {
+            case Skip_Whitespace: {
+                __m256i shifted = _mm256_sub_epi8(block, tab);
+                __m256i is_control = _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, control_range), shifted);
+                __m256i is_space = _mm256_or_si256(_mm256_cmpeq_epi8(block, space), _mm256_cmpeq_epi8(block, zero));
+                stop_mask = ~(uint32_t)_mm256_movemask_epi8(_mm256_or_si256(is_control, is_space));
+                break;
+            }
+            case Skip_LineComment:
+                stop_mask = newline_mask;
+                break;
+            case Skip_BlockComment:
+            default:
+                stop_mask = _mm256_movemask_epi8(
+                    _mm256_or_si256(_mm256_cmpeq_epi8(block, star), _mm256_cmpeq_epi8(block, slash)));
+                break;
+        }
+
+        if (stop_mask) {
+            int offset = __builtin_ctz(stop_mask);
+            count_newlines(newline_mask & (((uint64_t)1 << offset) - 1), position, newlines, last_newline);
+            return position + offset;
+        }
+
+        count_newlines(newline_mask, position, newlines, last_newline);
+    }
+
+    /// Finish the tail with 16 byte blocks
+    return skip_sse2(data, position, length, kind, newlines, last_newline);
+}
+
+__attribute__((target("sse2"))) static size_t skip_string_sse2(const char* data, size_t position, size_t length,
+                                                                 bool is_line_string) {
+    const __m128i backslash = _mm_set1_epi8('\\');
+    /// A block string does not stop on quotes, comparing with the backslash again keeps the loop branch free
+    const __m128i quote = _mm_set1_epi8(is_line_string ? '"' : '\\');
+    const __m128i control_end = _mm_set1_epi8(0x20);
+
+    while (position + 16 <= length) {
+        __m128i block = _mm_loadu_si128((const __m128i*)(data + position));
+        /// The signed comparison takes the bytes outside of ASCII as negative, they are masked out by `non_ascii`
+        __m128i stop = _mm_or_si128(_mm_cmplt_epi8(block, control_end),
+                                    _mm_or_si128(_mm_cmpeq_epi8(block, backslash), _mm_cmpeq_epi8(block, quote)));
+        uint32_t non_ascii = _mm_movemask_epi8(block);
+        uint32_t stop_mask = _mm_movemask_epi8(stop) & ~non_ascii;
+
+        if (!non_ascii) {
+            if (stop_mask) {
+                return position + __builtin_ctz(stop_mask);
+            }
+
+            position += 16;
+            continue;
+        }
+
+        bool stopped;
+        position = skip_string_until(data, position, position + 16, length, is_line_string, &stopped);
+
+        if (stopped) {
+            return position;
+        }
+    }
+
+    return skip_string_scalar(data, position, length, is_line_string);
+}
+
+__attribute__((target("avx2"))) static size_t skip_string_avx2(const char* data, size_t position, size_t length,
+                                                                 bool is_line_string) {
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i quote = _mm256_set1_epi8(is_line_string ? '"' : '\\');
+    const __m256i control_end = _mm256_set1_epi8(0x20);
+
+    while (position + 32 <= length) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)(data + position));
+        __m256i stop = _mm256_or_si256(
+            _mm256_cmpgt_epi8(control_end, block),
+            _mm256_or_si256(_mm256_cmpeq_epi8(block, backslash), _mm256_cmpeq_epi8(block, quote)));
+        uint32_t non_ascii = _mm256_movemask_epi8(block);
+        uint32_t stop_mask = _mm256_movemask_epi8(stop) & ~non_ascii;
+
+        if (!non_ascii) {
+            if (stop_mask) {
+                return position + __builtin_ctz(stop_mask);
+            }
+
+            position += 32;
+            continue;
+        }
+
+        bool stopped;
+        position = skip_string_until(data, position, position + 32, length, is_line_string, &stopped);
+
+        if (stopped) {
+            return position;
+        }
+    }
+
+    return skip_string_sse2(data, position, length, is_line_string);
+}
+
+#endif
+
+SkipImpl scanner_skip_select(SkipImpl impl) {
+#ifdef SKIP_X86
+    __builtin_cpu_init();
+
+    if (impl >= SkipImpl_AVX2 && __builtin_cpu_supports("avx2")) {
+        g_skip = skip_avx2;
+        g_skip_string = skip_string_avx2;
+        return SkipImpl_AVX2;
+    }
+
+    if (impl >= SkipImpl_SSE2 && __builtin_cpu_supports("sse2")) {
+        g_skip = skip_sse2;
+        g_skip_string = skip_string_sse2;
+        return SkipImpl_SSE2;
+    }
+#else
+    (void)impl;
+#endif
+
+    g_skip = skip_scalar;
+    g_skip_string = skip_string_scalar;
+    return SkipImpl_Scalar;
+}
+
+static size_t skip_resolve(const char* data, size_t position, size_t length, SkipKind kind, size_t* newlines,
+                           size_t* last_newline) {
+    scanner_skip_select(SkipImpl_AVX2);
+    return g_skip(data, position, length, kind, newlines, last_newline);
+}
+
+static size_t skip_string_resolve(const char* data, size_t position, size_t length, bool is_line_string) {
+    scanner_skip_select(SkipImpl_AVX2);
+    return g_skip_string(data, position, length, is_line_string);
+}
+
+size_t scanner_skip(const char* data, size_t position, size_t length, SkipKind kind, size_t* newlines,
+                    size_t* last_newline) {
+    *newlines = 0;
+    return g_skip(data, position, length, kind, newlines, last_newline);
+}
+
+size_t scanner_skip_string(const char* data, size_t position, size_t length, bool is_line_string) {
+    return g_skip_string(data, position, length, is_line_string);
+}
@@ -0,0 +1,76 @@
+/**
+ * @note Project: Implementace překladače imperativního jazyka IFJ23
+ * @file scanner_skip.h
+ * @author agent, agent, VUT FIT
+ * @date 16/10/2026
+ * @brief Fast skipping of whitespace and comment runs for the scanner.
+ *
+ * The scanner spends most of its time in long runs of bytes that do not change its state
+ * (indentation, license headers, commented out code, contents of string literals). These functions jump over such
+ * runs using SSE2/AVX2 when the CPU supports it, otherwise a scalar loop is used.
+ */
+
+#ifndef SCANNER_SKIP_H
+#define SCANNER_SKIP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/// Kind of the run to skip
+typedef enum {
+    /// Stops at the first byte that is not a whitespace (space, \t, \n, \v, \f, \r, \0)
+    Skip_Whitespace,
+    /// Stops at the first `\n`
+    Skip_LineComment,
+    /// Stops at the first `*` or `/`
+    Skip_BlockComment,
+} SkipKind;
+
+/// Implementation of the skipping kernel
+typedef enum {
+    SkipImpl_Scalar,
+    SkipImpl_SSE2,
+    SkipImpl_AVX2,
+} SkipImpl;
+
+/**
+ * @brief Skip a run of bytes of the given kind.
+ *
+ * @param[in] data Bytes of the input.
+ * @param[in] position Index of the first byte of the run.
+ * @param[in] length Length of `data`.
+ * @param[in] kind Kind of the run.
+ * @param[out] newlines Number of `\n` inside of the skipped run.
+ * @param[out] last_newline Index of the last `\n` inside of the skipped run, valid only if `newlines` is not 0.
+ * @return Index of the first byte that ends the run or `length`.
+ */
+size_t scanner_skip(const char* data, size_t position, size_t length, SkipKind kind, size_t* newlines,
+                    size_t* last_newline);
+
+/**
+ * @brief Skip the contents of a string literal up to the next byte that needs the DFA.
+ *
+ * The run ends before `\`, a control character (including `\n`), `"` in a single line string, or the first byte
+ * of a UTF-8 sequence that is not valid or not complete. Everything skipped is therefore valid UTF-8 and can be copied
+ * to the literal as it is. Blocks of ASCII bytes are checked by the vector kernels, sequences outside of ASCII are
+ * decoded one by one.
+ *
+ * @param[in] data Bytes of the input.
+ * @param[in] position Index of the first byte of the run.
+ * @param[in] length Length of `data`.
+ * @param[in] is_line_string `"` ends the run, a block string takes it as a content.
+ * @return Index of the first byte that ends the run or `length`.
+ */
+size_t scanner_skip_string(const char* data, size_t position, size_t length, bool is_line_string);
+
+/**
+ * @brief Select the implementation used by `scanner_skip` and `scanner_skip_string`.
+ *
+ * By default the fastest implementation supported by the CPU is selected on the first call.
+ *
+ * @param[in] impl Wanted implementation.
+ * @return The best supported implementation that is not faster than `impl`.
+ */
+SkipImpl scanner_skip_select(SkipImpl impl);
+
+#endif
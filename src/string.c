@@ -35,37 +35,93 @@ size_t strlcpy(char* __restrict dst, const char* __restrict src, size_t dsize) {
     return (src - osrc - 1); /* count does not include NUL */
 }
 
+/// Mark the data as stored inline, the flag shares the byte after the inline data
+static void string_set_small(String* str) {
+    str->storage.small[STRING_SMALL_CAPACITY] = 1;
+}
+
+static void string_set_heap(String* str, char* data, size_t capacity) {
+    str->storage.small[STRING_SMALL_CAPACITY] = 0;
+    str->storage.heap.data = data;
+    str->storage.heap.capacity = capacity;
+}
+
+String string_borrow(const char* data, size_t length) {
+    String res;
+    string_init(&res);
+    string_set_heap(&res, (char*)data, 0);
+    res.length = length;
+    return res;
+}
+
 void string_init(String* str) {
     if (!str)
         return;
 
-    str->data = NULL;
-    str->length = 0;
-    str->capacity = 0;
+    memset(str, 0, sizeof(String));
 }
 
 void string_free(String* str) {
-    if (str && str->data) {
-        free(str->data);
-        str->data = NULL;
-        str->length = 0;
-        str->capacity = 0;
+    if (!str)
+        return;
+
+    if (!str->storage.small[STRING_SMALL_CAPACITY] && str->storage.heap.capacity) {
+        free(str->storage.heap.data);
     }
+
+    string_init(str);
 }
 
 void string_clear(String* str) {
-    if (string_len(str)) {
-        str->length = 0;
-        str->data[0] = '\0';
+    if (!string_len(str)) {
+        return;
+    }
+
+    /// Borrowed data are never written, the string simply stops pointing to them
+    if (!string_capacity(str)) {
+        string_init(str);
+        return;
     }
+
+    str->length = 0;
+    string_data(str)[0] = '\0';
 }
 
 void string_reserve(String* str, size_t capacity) {
-    if (capacity <= str->capacity) {
+    size_t current = string_capacity(str);
+
+    if (capacity <= current) {
+        return;
+    }
+
+    /// Only a borrowing string can have a smaller capacity, its data are copied
+    if (capacity <= STRING_SMALL_CAPACITY) {
+        const char* borrowed = str->storage.heap.data;
+
+        if (str->length) {
+            memmove(str->storage.small, borrowed, str->length);
+        }
+
+        str->storage.small[str->length] = '\0';
+        string_set_small(str);
         return;
     }
 
-    char* new = (char*)realloc(str->data, sizeof(char) * capacity);
+    char* new;
+
+    if (current && !str->storage.small[STRING_SMALL_CAPACITY]) {
+        new = (char*)realloc(str->storage.heap.data, sizeof(char) * capacity);
+    } else {
+        new = (char*)malloc(sizeof(char) * capacity);
+
+        if (new) {
+            const char* data = string_data(str);
+            if (str->length) {
+                memcpy(new, data, str->length);
+            }
+            new[str->length] = '\0';
+        }
+    }
 
     if (!new) {
         set_error(Error_Internal);
@@ -73,8 +129,19 @@ void string_reserve(String* str, size_t capacity) {
         return;
     }
 
-    str->data = new;
-    str->capacity = capacity;
+    string_set_heap(str, new, capacity);
+}
+
+/// Make room for `capacity` bytes, the capacity grows geometrically so appending one byte at a time is linear
+static void string_grow(String* str, size_t capacity) {
+    size_t current = string_capacity(str);
+
+    if (capacity <= current) {
+        return;
+    }
+
+    size_t grown = (size_t)(current * STRING_GROWTH_FACTOR);
+    string_reserve(str, grown > capacity ? grown : capacity);
 }
 
 size_t string_len(String* str) {
@@ -82,34 +149,36 @@ size_t string_len(String* str) {
 }
 
 void string_push(String* str, char ch) {
-    string_reserve(str, str->length + 2);
+    string_grow(str, str->length + 2);
 
     if (got_error()) {
         return;
     }
 
-    str->data[str->length++] = ch;
-    str->data[str->length] = '\0';
+    char* data = string_data(str);
+    data[str->length++] = ch;
+    data[str->length] = '\0';
 }
 
-void string_concat_c_str(String* str, const char* str2) {
-    size_t length = strlen(str2);
-
+void string_append_n(String* str, const char* data, size_t length) {
     if (!length) {
         return;
     }
 
-    size_t new_length = str->length + length;
+    string_grow(str, str->length + length + 1);
 
-    if (new_length >= str->capacity) {
-        string_reserve(str, new_length + 1);
-        if (got_error()) {
-            return;
-        }
+    if (got_error()) {
+        return;
     }
 
-    strlcpy(str->data + str->length, str2, length + 1);
-    str->length = new_length;
+    char* dst = string_data(str) + str->length;
+    memcpy(dst, data, length);
+    dst[length] = '\0';
+    str->length += length;
+}
+
+void string_concat_c_str(String* str, const char* str2) {
+    string_append_n(str, str2, strlen(str2));
 }
 
 String string_from_c_str(const char* str) {
@@ -126,51 +195,80 @@ String string_from_c_str(const char* str) {
     string_reserve(&res, len + 1);
 
     if (!got_error()) {
-        strlcpy(res.data, str, len + 1);
+        strlcpy(string_data(&res), str, len + 1);
         res.length = len;
     }
 
     return res;
 }
 
-String string_from_format(const char* fmt, ...) {
-    String res;
-    string_init(&res);
+void string_append_vfmt(String* str, const char* fmt, va_list args) {
+    // Make the string writable, an empty or borrowing string has no capacity
+    string_grow(str, str->length + 1);
 
-    va_list args;
-    va_start(args, fmt);
+    if (got_error()) {
+        return;
+    }
 
-    // Get the total length of the string after insertion of args.
-    size_t fmt_len = vsnprintf(NULL, 0, fmt, args);
+    size_t spare = string_capacity(str) - str->length;
 
-    // Allocate enough memory for the string.
-    res.data = calloc(fmt_len + 1, sizeof(char));
-    if (!res.data) {
-        SET_INT_ERROR(IntError_Memory, "string_from_format: Calloc failed!");
-        return res;
+    va_list retry;
+    va_copy(retry, args);
+
+    // Format right behind the current data, only retry when the output does not fit
+    int fmt_len = vsnprintf(string_data(str) + str->length, spare, fmt, args);
+
+    if (fmt_len < 0) {
+        va_end(retry);
+        set_error(Error_Internal);
+        eprint("string_append_fmt: Invalid format\n");
+        return;
     }
-    res.capacity = fmt_len + 1;
 
-    // Reset the args, so we can use it again.
-    va_end(args);
+    if ((size_t)fmt_len >= spare) {
+        // A string made only of the output is sized exactly, like `string_from_c_str`
+        if (str->length) {
+            string_grow(str, str->length + fmt_len + 1);
+        } else {
+            string_reserve(str, fmt_len + 1);
+        }
+
+        if (got_error()) {
+            va_end(retry);
+            string_data(str)[str->length] = '\0';
+            return;
+        }
+
+        vsnprintf(string_data(str) + str->length, fmt_len + 1, fmt, retry);
+    }
+
+    va_end(retry);
+    str->length += fmt_len;
+    MASSERT(str->length < string_capacity(str), "string_append_fmt: Wrong string length");
+}
+
+void string_append_fmt(String* str, const char* fmt, ...) {
+    va_list args;
     va_start(args, fmt);
+    string_append_vfmt(str, fmt, args);
+    va_end(args);
+}
 
-    // Insert string in given format into `res`.
-    vsprintf(res.data, fmt, args);
-    res.length = fmt_len;
-    MASSERT(res.length <= res.capacity, "string_from_format: Wrong string length");
+String string_from_format(const char* fmt, ...) {
+    String res;
+    string_init(&res);
 
+    va_list args;
+    va_start(args, fmt);
+    string_append_vfmt(&res, fmt, args);
     va_end(args);
+
     return res;
 }
 
 String string_take(String* str) {
-    String new = {.data = str->data, .length = str->length, .capacity = str->capacity};
-
-    str->data = NULL;
-    str->length = 0;
-    str->capacity = 0;
-
+    String new = *str;
+    string_init(str);
     return new;
 }
 
@@ -184,10 +282,12 @@ String string_clone(String* str) {
         return new;
     }
 
-    strlcpy(new.data, str->data, str->length);
-
+    char* data = string_data(&new);
+    if (str->length) {
+        memcpy(data, string_data(str), str->length);
+    }
+    data[str->length] = '\0';
     new.length = str->length;
-    new.capacity = str->length + 1;
 
     return new;
 }
@@ -198,8 +298,10 @@ void string_remove_ident(String* str, int ident_level) {
 
     int current_ident = 0;
 
-    for (int i = 0; str->data[i]; i++) {
-        char ch = str->data[i];
+    const char* data = string_data(str);
+
+    for (int i = 0; data[i]; i++) {
+        char ch = data[i];
 
         if (ch == '\n') {
             current_ident = 0;
@@ -217,7 +319,7 @@ void string_remove_ident(String* str, int ident_level) {
 
         if (!ident && (current_ident < ident_level)) {
             eprintf("string_remove_ident: cannot remove ident of %d levels for the given string\n%s\n", ident_level,
-                    str->data);
+                    data);
             string_free(&new);
             set_error(Error_Internal);
             return;
@@ -238,3 +340,41 @@ void string_remove_ident(String* str, int ident_level) {
     string_free(str);
     *str = new;
 }
+
+StrView strview_from_c_str(const char* str) {
+    return (StrView){.data = str, .length = str ? strlen(str) : 0};
+}
+
+bool strview_equals(StrView a, StrView b) {
+    return a.length == b.length && (!a.length || memcmp(a.data, b.data, a.length) == 0);
+}
+
+bool strview_equals_c_str(StrView view, const char* str) {
+    return strview_equals(view, strview_from_c_str(str));
+}
+
+int strview_compare(StrView a, StrView b) {
+    size_t length = a.length < b.length ? a.length : b.length;
+    int result = length ? memcmp(a.data, b.data, length) : 0;
+
+    if (result || a.length == b.length) {
+        return result;
+    }
+
+    return a.length < b.length ? -1 : 1;
+}
+
+uint32_t strview_hash(StrView view) {
+    uint32_t hash = 2166136261u;
+
+    for (size_t i = 0; i < view.length; i++) {
+        hash ^= (unsigned char)view.data[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+void string_append_view(String* str, StrView view) {
+    string_append_n(str, view.data, view.length);
+}
@@ -9,28 +9,84 @@
 #ifndef STRING_H
 #define STRING_H
 
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <strings.h>
 #include "error.h"
 
+/// Strings up to this many bytes (including the null terminator) are stored inside of the String itself
+#define STRING_SMALL_CAPACITY 23
+
+#ifndef STRING_GROWTH_FACTOR
+/// The capacity of a string growing by appends is multiplied by this factor (greater than 1), so appending is
+/// amortised constant
+#define STRING_GROWTH_FACTOR 2.0
+#endif
+
 /**
  * @struct String
  * @brief A struct representing a dynamically allocated string.
  *
- * This struct contains a dynamically allocated character array to store the string data and a length
- * field to keep track of the string's length.
- * The inner data is is null-terminated, making it compatible with
- * standard C string functions from `<string.h>`.
+ * This struct contains a character array to store the string data and a length field to keep track of the string's
+ * length. The inner data is is null-terminated, making it compatible with standard C string functions from
+ * `<string.h>`. Use `string_data` to access it.
+ *
+ * The data are stored in one of three ways:
+ * - short strings are stored inline, without any allocation (the byte after `small` data is nonzero),
+ * - longer strings own a heap allocation of `heap.capacity` bytes,
+ * - a string with zero `heap.capacity` borrows its data (e.g. from the source code), it is never written nor freed.
+ *
+ * A String is moved by copying the struct, a pointer to the data of a short string is valid only as long as the
+ * String it was taken from.
  */
 typedef struct {
-    char* data;
     size_t length;
-    size_t capacity;
+    union {
+        struct {
+            char* data;
+            size_t capacity;
+        } heap;
+        char small[STRING_SMALL_CAPACITY + 1];
+    } storage;
 } String;
 
+/**
+ * @brief Get the null-terminated data of the string.
+ *
+ * @param[in] str The String struct to examine.
+ * @return The data, NULL if nothing was ever stored in the string.
+ */
+inline static char* string_data(const String* str) {
+    return str->storage.small[STRING_SMALL_CAPACITY] ? (char*)str->storage.small : str->storage.heap.data;
+}
+
+/**
+ * @brief Get the number of bytes the string can hold without an allocation (including the null terminator).
+ *
+ * @param[in] str The String struct to examine.
+ * @return The capacity, 0 if the string borrows its data.
+ */
+inline static size_t string_capacity(const String* str) {
+    return str->storage.small[STRING_SMALL_CAPACITY] ? STRING_SMALL_CAPACITY : str->storage.heap.capacity;
+}
+
+/**
+ * @brief Create a string borrowing the given data, the string does not own them.
+ *
+ * Modifying the string copies the data first.
+ *
+ * @param[in] data The data, does not have to be null terminated.
+ * @param[in] length Length of the data.
+ * @return The borrowing String.
+ */
+String string_borrow(const char* data, size_t length);
+
 /**
  * @brief Initialize an empty string.
  *
- * This function initializes an empty string, but does not allocate data yet.
+ * This function initializes an empty string, but does not allocate data yet. Strings shorter than
+ * `STRING_SMALL_CAPACITY` never allocate.
  *
  * @param[out] str The String struct to initialize.
  */
@@ -70,8 +126,9 @@ size_t string_len(String* str);
 /**
  * @brief Reserve memory for the string to accommodate a specified capacity.
  *
- * This function reserves memory for the string to accommodate a specified capacity.
- * If the requested capacity is less than the current capacity, no action is taken.
+ * This function reserves memory for the string to accommodate exactly the specified capacity.
+ * If the requested capacity is less than the current capacity, no action is taken. Appending functions grow the
+ * capacity by `STRING_GROWTH_FACTOR` instead.
  *
  * @param[in,out] str The String struct to reserve memory for.
  * @param[in] capacity The desired capacity to reserve.
@@ -89,6 +146,18 @@ void string_reserve(String* str, size_t capacity);
  */
 void string_push(String* str, char ch);
 
+/**
+ * @brief Append `length` bytes to the end of the string.
+ *
+ * The bytes do not have to be null terminated and must not point into the string itself.
+ * If memory allocation fails during the operation, the error is set to InternalError.
+ *
+ * @param[in,out] str The String struct to modify.
+ * @param[in] data The bytes to append.
+ * @param[in] length Number of bytes to append.
+ */
+void string_append_n(String* str, const char* data, size_t length);
+
 /**
  * @brief Concatenate a C-style string to the end of a String.
  *
@@ -110,6 +179,27 @@ void string_concat_c_str(String* str, const char* str2);
  */
 String string_from_c_str(const char* str);
 
+/**
+ * @brief Append the output of a printf-like format to the end of the string.
+ *
+ * The output is formatted straight into the spare capacity of the string, the format is only evaluated
+ * again when the output does not fit. If memory allocation fails, the error is set to InternalError.
+ *
+ * @param[in,out] str The String struct to modify.
+ * @param[in] fmt Printf-like string format.
+ * @param[in] ... Format arguments, must not point into the string itself.
+ */
+void string_append_fmt(String* str, const char* fmt, ...);
+
+/**
+ * @brief `string_append_fmt` taking the format arguments as `va_list`.
+ *
+ * @param[in,out] str The String struct to modify.
+ * @param[in] fmt Printf-like string format.
+ * @param[in] args Format arguments, must not point into the string itself.
+ */
+void string_append_vfmt(String* str, const char* fmt, va_list args);
+
 /**
  * @brief Initialize string from a given format.
  *
@@ -151,4 +241,81 @@ String string_clone(String* str);
  */
 void string_remove_ident(String* str, int ident_level);
 
+/**
+ * @struct StrView
+ * @brief A read-only view of characters owned by somebody else (a String, the interner or the source code).
+ *
+ * The data do not have to be null terminated, use `STRVIEW_FMT` and `STRVIEW_ARG` to print them.
+ * A view with NULL data is empty and stands for a missing name.
+ */
+typedef struct {
+    const char* data;
+    size_t length;
+} StrView;
+
+/// printf format of a StrView, `STRVIEW_ARG` gives its arguments
+#define STRVIEW_FMT "%.*s"
+#define STRVIEW_ARG(view) (int)(view).length, (view).data
+
+/**
+ * @brief Get a view of the data of the string, the view is valid until the string is modified or moved.
+ *
+ * @param[in] str The String struct to view.
+ * @return The view.
+ */
+inline static StrView string_view(const String* str) {
+    return (StrView){.data = string_data(str), .length = str->length};
+}
+
+/**
+ * @brief Get a view of a C string.
+ *
+ * @param[in] str Null terminated string or NULL.
+ * @return The view, with NULL data for a NULL string.
+ */
+StrView strview_from_c_str(const char* str);
+
+/**
+ * @brief Compare the characters of two views.
+ *
+ * @param[in] a The first view.
+ * @param[in] b The second view.
+ * @return `true` if both views have the same characters.
+ */
+bool strview_equals(StrView a, StrView b);
+
+/**
+ * @brief Compare the characters of a view and a C string.
+ *
+ * @param[in] view The view.
+ * @param[in] str Null terminated string.
+ * @return `true` if both have the same characters.
+ */
+bool strview_equals_c_str(StrView view, const char* str);
+
+/**
+ * @brief Order two views lexicographically, a prefix is ordered before the longer view.
+ *
+ * @param[in] a The first view.
+ * @param[in] b The second view.
+ * @return Negative, zero or positive value like `strcmp`.
+ */
+int strview_compare(StrView a, StrView b);
+
+/**
+ * @brief Hash the characters of a view (FNV-1a).
+ *
+ * @param[in] view The view to hash.
+ * @return The hash.
+ */
+uint32_t strview_hash(StrView view);
+
+/**
+ * @brief Append the characters of a view to the end of the string.
+ *
+ * @param[in,out] str The String struct to modify.
+ * @param[in] view The view to append, must not point into the string itself.
+ */
+void string_append_view(String* str, StrView view);
+
 #endif
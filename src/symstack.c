@@ -123,19 +123,27 @@ bool symstack_pop() {
 }
 
 Symtable* symstack_search(const char* sym_name) {
+    return symstack_search_by_id(intern_find(sym_name));
+}
+
+VariableSymbol* symstack_search_variable(const char* var_name) {
+    return symstack_search_variable_by_id(intern_find(var_name));
+}
+
+Symtable* symstack_search_by_id(SymbolId sym_id) {
     CHECK_SS(NULL);
     for (SymStackNode* node = g_symstack->top; node; node = node->next) {
-        if (symtable_get_symbol_type(&node->symtable, sym_name) != NULL)
+        if (symtable_get_symbol_type_by_id(&node->symtable, sym_id) != NULL)
             return &node->symtable;
     }
     return NULL;
 }
 
-VariableSymbol* symstack_search_variable(const char* var_name) {
+VariableSymbol* symstack_search_variable_by_id(SymbolId var_id) {
     CHECK_SS(NULL);
     for (SymStackNode* node = g_symstack->top; node; node = node->next) {
         VariableSymbol* sym;
-        if ((sym = symtable_get_variable(&node->symtable, var_name)) != NULL)
+        if ((sym = symtable_get_variable_by_id(&node->symtable, var_id)) != NULL)
             return sym;
     }
     return NULL;
@@ -112,6 +112,22 @@ Symtable* symstack_search(const char* sym_name);
  */
 VariableSymbol* symstack_search_variable(const char* var_name);
 
+/**
+ * @brief Search the stack for symbol by the symbol ID of its name.
+ *
+ * The same as `symstack_search`, but the name is already interned, so every scope compares only integers.
+ * @param[in] sym_id Symbol ID of the name to search for.
+ * @return `Pointer to symbol table` containing symbol or `NULL` if the symbol doesn't exist.
+ */
+Symtable* symstack_search_by_id(SymbolId sym_id);
+
+/**
+ * @brief Search the stack for variable symbol by the symbol ID of its name.
+ * @param[in] var_id Symbol ID of the name of the variable to search for.
+ * @return Pointer to the VariableSymbol or NULL when not found.
+ */
+VariableSymbol* symstack_search_variable_by_id(SymbolId var_id);
+
 /**
  * @brief Get the index of symtable on the stack.
  *
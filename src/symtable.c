@@ -53,25 +53,24 @@ void function_symbol_free(FunctionSymbol* sym) {
     string_free(&sym->code_name);
 }
 
-int string_comp(const char* a, const char* b) {
-    if (a == NULL || b == NULL)
-        return -1;
-    return strcmp(a, b);
+/// Missing names (unnamed parameters) are never equal to anything
+static bool name_equals(StrView a, StrView b) {
+    return a.data && b.data && strview_equals(a, b);
 }
 
-int funciton_symbol_has_param(FunctionSymbol* sym, const char* oname, const char* iname) {
+int funciton_symbol_has_param(FunctionSymbol* sym, StrView oname, StrView iname) {
     for (int i = 0; i < sym->param_count; i++) {
-        if (string_comp(sym->params[i].oname.data, oname) == 0)
+        if (name_equals(string_view(&sym->params[i].oname), oname))
             return 1;
-        if (string_comp(sym->params[i].iname.data, iname) == 0)
+        if (name_equals(string_view(&sym->params[i].iname), iname))
             return 2;
     }
     return 0;
 }
 
-FunctionParameter* function_symbol_get_param_named(FunctionSymbol* sym, const char* oname) {
+FunctionParameter* function_symbol_get_param_named(FunctionSymbol* sym, StrView oname) {
     for (int i = 0; i < sym->param_count; i++) {
-        if (strcmp(sym->params[i].oname.data, oname) == 0)
+        if (name_equals(string_view(&sym->params[i].oname), oname))
             return sym->params + i;
     }
     return NULL;
@@ -96,17 +95,17 @@ bool function_symbol_insert_param(FunctionSymbol* sym, FunctionParameter param)
     return true;
 }
 
-bool function_symbol_emplace_param(FunctionSymbol* sym, DataType type, const char* oname, const char* iname) {
-    MASSERT(sym && iname, "Function symbol and iname cannot be NULL.");
+bool function_symbol_emplace_param(FunctionSymbol* sym, DataType type, StrView oname, StrView iname) {
+    MASSERT(sym && iname.data, "Function symbol and iname cannot be NULL.");
 
     // Create new FunctionParameter
     FunctionParameter p;
     function_parameter_init(&p);
     p.type = type;
-    string_concat_c_str(&p.iname, iname);
-    if (oname)
-        string_concat_c_str(&p.oname, oname);
-    p.is_named = oname != NULL;
+    string_append_view(&p.iname, iname);
+    if (oname.data)
+        string_append_view(&p.oname, oname);
+    p.is_named = oname.data != NULL;
 
     return function_symbol_insert_param(sym, p);
 }
@@ -141,8 +140,6 @@ void node_free(Node** node) {
     else
         variable_symbol_free(&aux->value.variable);
 
-    string_free(&aux->key);
-
     free(aux);
     *node = NULL;
 }
@@ -153,7 +150,7 @@ void symtable_free(Symtable* symtable) {
     node_free(&symtable->root);
 }
 
-static Node* create_node(const char* key, NodeType type, NodeValue value) {
+static Node* create_node(SymbolId key, NodeType type, NodeValue value) {
     Node* node = malloc(sizeof(Node));
 
     if (!node) {
@@ -161,18 +158,13 @@ static Node* create_node(const char* key, NodeType type, NodeValue value) {
         return NULL;
     }
 
-    node->key = string_from_c_str(key);
+    node->key = key;
     node->type = type;
     node->value = value;
     node->left = NULL;
     node->right = NULL;
     node->height = 1;
 
-    if (got_error()) {
-        free(node);
-        return NULL;
-    }
-
     return node;
 }
 
@@ -200,13 +192,13 @@ Node* node_rotate_left(Node* x) {
     x->right = y->left;
     y->left = x;
 
-    y->height = max(node_height(y->left), node_height(y->right)) + 1;
     x->height = max(node_height(x->left), node_height(x->right)) + 1;
+    y->height = max(node_height(y->left), node_height(y->right)) + 1;
 
     return y;
 }
 
-static Node* node_bvs_insert(Node* node, const char* key, NodeType type, NodeValue value, bool* inserted) {
+static Node* node_bvs_insert(Node* node, SymbolId key, NodeType type, NodeValue value, bool* inserted) {
     if (!node) {
         Node* new_node = create_node(key, type, value);
 
@@ -218,35 +210,35 @@ static Node* node_bvs_insert(Node* node, const char* key, NodeType type, NodeVal
         return new_node;
     }
 
-    int cmp = strcmp(key, node->key.data);
-
-    if (cmp > 0) {
+    if (key > node->key) {
         node->right = node_bvs_insert(node->right, key, type, value, inserted);
-    } else if (cmp < 0) {
+    } else if (key < node->key) {
         node->left = node_bvs_insert(node->left, key, type, value, inserted);
     }
 
+    node->height = max(node_height(node->left), node_height(node->right)) + 1;
+
     // Balance
     int balance = node_height(node->left) - node_height(node->right);
 
     // Left Left Case
-    if (balance > 1 && strcmp(key, node->left->key.data) < 0) {
+    if (balance > 1 && key < node->left->key) {
         return node_rotate_right(node);
     }
 
     // Right Right Case
-    if (balance < -1 && strcmp(key, node->right->key.data) > 0) {
+    if (balance < -1 && key > node->right->key) {
         return node_rotate_left(node);
     }
 
     // Left Right Case
-    if (balance > 1 && strcmp(key, node->left->key.data) > 0) {
+    if (balance > 1 && key > node->left->key) {
         node->left = node_rotate_left(node->left);
         return node_rotate_right(node);
     }
 
     // Right Left Case
-    if (balance < -1 && strcmp(key, node->right->key.data) < 0) {
+    if (balance < -1 && key < node->right->key) {
         node->right = node_rotate_right(node->right);
         return node_rotate_left(node);
     }
@@ -259,19 +251,23 @@ static bool symtable_insert(Symtable* symtable, const char* key, NodeType type,
         return false;
     }
 
+    SymbolId id = intern_add_c_str(key);
+
+    if (id == SYMBOL_NONE) {
+        return false;
+    }
+
     bool inserted = false;
-    symtable->root = node_bvs_insert(symtable->root, key, type, value, &inserted);
+    symtable->root = node_bvs_insert(symtable->root, id, type, value, &inserted);
     return inserted;
 }
 
-static Node* node_bvs_get(Node* node, const char* key) {
-    if (!node) {
-        return NULL;
+static Node* node_bvs_get(Node* node, SymbolId key) {
+    while (node && node->key != key) {
+        node = key > node->key ? node->right : node->left;
     }
 
-    int cmp = strcmp(key, node->key.data);
-
-    return cmp > 0 ? node_bvs_get(node->right, key) : cmp < 0 ? node_bvs_get(node->left, key) : node;
+    return node;
 }
 
 bool symtable_insert_function(Symtable* symtable, const char* key, FunctionSymbol function) {
@@ -287,6 +283,18 @@ bool symtable_insert_variable(Symtable* symtable, const char* key, VariableSymbo
 }
 
 FunctionSymbol* symtable_get_function(Symtable* symtable, const char* key) {
+    return symtable_get_function_by_id(symtable, intern_find(key));
+}
+
+VariableSymbol* symtable_get_variable(Symtable* symtable, const char* key) {
+    return symtable_get_variable_by_id(symtable, intern_find(key));
+}
+
+NodeType* symtable_get_symbol_type(Symtable* symtable, const char* key) {
+    return symtable_get_symbol_type_by_id(symtable, intern_find(key));
+}
+
+FunctionSymbol* symtable_get_function_by_id(Symtable* symtable, SymbolId key) {
     Node* node = node_bvs_get(symtable->root, key);
 
     if (node && node->type == NodeType_Function) {
@@ -296,7 +304,7 @@ FunctionSymbol* symtable_get_function(Symtable* symtable, const char* key) {
     return NULL;
 }
 
-VariableSymbol* symtable_get_variable(Symtable* symtable, const char* key) {
+VariableSymbol* symtable_get_variable_by_id(Symtable* symtable, SymbolId key) {
     Node* node = node_bvs_get(symtable->root, key);
 
     if (node && node->type == NodeType_Variable) {
@@ -306,7 +314,7 @@ VariableSymbol* symtable_get_variable(Symtable* symtable, const char* key) {
     return NULL;
 }
 
-NodeType* symtable_get_symbol_type(Symtable* symtable, const char* key) {
+NodeType* symtable_get_symbol_type_by_id(Symtable* symtable, SymbolId key) {
     Node* node = node_bvs_get(symtable->root, key);
     return node == NULL ? NULL : &node->type;
 }
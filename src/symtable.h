@@ -16,6 +16,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include "codegen.h"
+#include "intern.h"
 #include "scanner.h"
 #include "string.h"
 
@@ -94,7 +95,7 @@ typedef union {
  * @brief Represents a node of an AVL tree that contains an item (variable or function) in the symbol table.
  */
 typedef struct item_t {
-    String key;           /**< Key (name) of the item. */
+    SymbolId key;         /**< Interned key (name) of the item, nodes are ordered by the symbol ID. */
     NodeType type;        /**< Type of the node (a function or a variable)*/
     NodeValue value;      /**< Value of the node */
     struct item_t* left;  /**< Pointer to the left item */
@@ -149,7 +150,7 @@ void function_symbol_free(FunctionSymbol* sym);
  * @param[in] iname Name of the parameter inside the function.
  * @return 0 when the parameter in NOT present. Otherwise 1 if `oname` exist or 2 if iname `exists`.
  */
-int funciton_symbol_has_param(FunctionSymbol* sym, const char* oname, const char* iname);
+int funciton_symbol_has_param(FunctionSymbol* sym, StrView oname, StrView iname);
 
 /**
  * @brief Get function parameter by outside name.
@@ -157,7 +158,7 @@ int funciton_symbol_has_param(FunctionSymbol* sym, const char* oname, const char
  * @param[in] oname Name of the parameter when calling the function.
  * @return Pointer to function parameter on NULL when not found.
  */
-FunctionParameter* function_symbol_get_param_named(FunctionSymbol* sym, const char* oname);
+FunctionParameter* function_symbol_get_param_named(FunctionSymbol* sym, StrView oname);
 
 /**
  * @brief Insert function parameter to parameters in function symbol.
@@ -172,11 +173,11 @@ bool function_symbol_insert_param(FunctionSymbol* sym, FunctionParameter param);
  * @brief Construct FunctionParameter and insert it into parameter array.
  * @param[in,out] sym FunctionSymbol to insert the new FunctionParameter in.
  * @param[in] type ::DataType of parameter.
- * @param[in] oname Name of the parameter in function calls or NULL for unnamed parameter.
+ * @param[in] oname Name of the parameter in function calls or a view with NULL data for unnamed parameter.
  * @param[in] iname Name of the parameter inside function definition.
  * @return True if insertion was successful, False otherwise.
  */
-bool function_symbol_emplace_param(FunctionSymbol* sym, DataType type, const char* oname, const char* iname);
+bool function_symbol_emplace_param(FunctionSymbol* sym, DataType type, StrView oname, StrView iname);
 
 /**
  * @brief Initialize the variable symbol.
@@ -268,4 +269,34 @@ VariableSymbol* symtable_get_variable(Symtable* symtable, const char* str);
  */
 NodeType* symtable_get_symbol_type(Symtable* symtable, const char* str);
 
+/**
+ * @brief Get a function symbol from the symbol table by the symbol ID of its name.
+ *
+ * The same as `symtable_get_function`, but the name is already interned (e.g. `Token::symbol`),
+ * so the search only compares integers.
+ *
+ * @param[in] symtable The Symtable struct to search.
+ * @param[in] key Symbol ID of the name of the function.
+ * @return A pointer to the FunctionSymbol if found; otherwise, NULL.
+ */
+FunctionSymbol* symtable_get_function_by_id(Symtable* symtable, SymbolId key);
+
+/**
+ * @brief Get a variable symbol from the symbol table by the symbol ID of its name.
+ *
+ * @param[in] symtable The Symtable struct to search.
+ * @param[in] key Symbol ID of the name of the variable.
+ * @return A pointer to the VariableSymbol if found; otherwise, NULL.
+ */
+VariableSymbol* symtable_get_variable_by_id(Symtable* symtable, SymbolId key);
+
+/**
+ * @brief Get the type of a symbol in the symbol table by the symbol ID of its name.
+ *
+ * @param[in] symtable The Symtable struct to search.
+ * @param[in] key Symbol ID of the name of the symbol.
+ * @return A pointer to the NodeType of the symbol if found; otherwise, NULL.
+ */
+NodeType* symtable_get_symbol_type_by_id(Symtable* symtable, SymbolId key);
+
 #endif
@@ -0,0 +1,91 @@
+/**
+ * @note Project: Implementace překladače imperativního jazyka IFJ23
+ * @file test/arena.c
+ * @author agent, agent, VUT FIT
+ * @date 16/10/2026
+ * @brief Tester for arena.h
+ */
+
+#include "../arena.h"
+#include <stdalign.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "test.h"
+
+int main() {
+    atexit(summary);
+
+    Arena arena;
+    arena_init(&arena);
+
+    suite("Test arena_alloc") {
+        char* a = arena_alloc(&arena, 3);
+        long* b = arena_alloc(&arena, sizeof(long) * 4);
+        test(a && b);
+        test((uintptr_t)b % alignof(max_align_t) == 0);
+        test((char*)b >= a + 3);
+
+        memset(a, 'a', 3);
+        b[3] = 42;
+        test(b[3] == 42);
+    }
+
+    suite("Test arena_strndup") {
+        char* str = arena_strndup(&arena, "hello world", 5);
+        test(str && strcmp(str, "hello") == 0);
+
+        char* empty = arena_strndup(&arena, "", 0);
+        test(empty && !*empty);
+    }
+
+    suite("Test arena blocks") {
+        char* first = arena_strndup(&arena, "first", 5);
+        bool kept = true;
+
+        /// Allocations bigger than a block and many small ones spanning several blocks
+        char* big = arena_alloc(&arena, 1 << 20);
+        test(big);
+        big[(1 << 20) - 1] = 'x';
+
+        for (int i = 0; i < 10000; i++) {
+            int* num = arena_alloc(&arena, sizeof(int) * 8);
+            kept = kept && num;
+            num[7] = i;
+        }
+
+        test(kept);
+        test(strcmp(first, "first") == 0);
+    }
+
+    suite("Test arena_adopt") {
+        Arena other;
+        arena_init(&other);
+
+        char* moved = arena_strndup(&other, "moved", 5);
+        char* big = arena_alloc(&other, 1 << 20);
+        test(moved && big);
+
+        arena_adopt(&arena, &other);
+        test(!other.block);
+        test(strcmp(moved, "moved") == 0);
+
+        /// Adopting into an empty arena takes over the blocks as they are
+        arena_adopt(&other, &arena);
+        test(!arena.block && other.block);
+        test(strcmp(moved, "moved") == 0);
+
+        arena_adopt(&arena, &other);
+        char* str = arena_strndup(&arena, "after", 5);
+        test(str && strcmp(str, "after") == 0);
+    }
+
+    suite("Test arena_free") {
+        arena_free(&arena);
+        test(!arena.block);
+
+        char* str = arena_strndup(&arena, "again", 5);
+        test(str && strcmp(str, "again") == 0);
+        arena_free(&arena);
+    }
+}
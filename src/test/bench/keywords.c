@@ -0,0 +1,81 @@
+/**
+ * @note Project: Implementace překladače imperativního jazyka IFJ23
+ * @file test/bench/keywords.c
+ * @author agent, agent, VUT FIT
+ * @date 16/10/2026
+ * @brief Micro-benchmark of the keyword recognition on identifier heavy input.
+ *
+ * Usage: bench_keywords [words] [rounds]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../../error.h"
+#include "../../scanner.h"
+
+/// Half of the words are reserved, the rest are identifiers sharing their length and first/last bytes
+static const char* WORDS[] = {
+    "if",     "else",  "let",   "var",     "while",  "func", "return", "Int",    "Double", "String",
+    "Bool",   "true",  "false", "nil",     "i",      "x",    "ef",     "elsie",  "lot",    "vapor",
+    "whale",  "funk",  "result", "Index",  "Dance",  "Strong", "Blue", "trace", "fable",  "null",
+    "counter", "_tmp", "value1", "identifier_long_name",
+};
+
+static double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char** argv) {
+    unsigned long words = argc > 1 ? strtoul(argv[1], NULL, 10) : 5000;
+    unsigned long rounds = argc > 2 ? strtoul(argv[2], NULL, 10) : 400;
+    size_t word_count = sizeof(WORDS) / sizeof(*WORDS);
+    String input;
+    string_init(&input);
+
+    unsigned seed = 1;
+    for (unsigned long i = 0; i < words; i++) {
+        seed = seed * 1103515245 + 12345;
+        string_concat_c_str(&input, WORDS[(seed >> 16) % word_count]);
+        string_push(&input, i % 16 == 15 ? '\n' : ' ');
+    }
+
+    if (got_error()) {
+        return got_error();
+    }
+
+    double best = 0;
+    unsigned long tokens = 0;
+
+    for (unsigned long round = 0; round < rounds; round++) {
+        scanner_init_str(string_data(&input));
+
+        double start = now();
+        Token token;
+        tokens = 0;
+
+        do {
+            token = scanner_advance();
+            tokens++;
+        } while (token.type != Token_EOF && !got_error());
+
+        double elapsed = now() - start;
+        scanner_free();
+
+        if (got_error()) {
+            return got_error();
+        }
+
+        if (!round || elapsed < best) {
+            best = elapsed;
+        }
+    }
+
+    printf("%lu tokens, %zu bytes: best of %lu rounds %.3f ms, %.1f ns/token, %.1f MB/s\n", tokens, input.length,
+           rounds, best * 1e3, best * 1e9 / tokens, input.length / best / 1e6);
+
+    string_free(&input);
+    return 0;
+}
@@ -0,0 +1,266 @@
+/**
+ * @note Project: Implementace překladače imperativního jazyka IFJ23
+ * @file test/bench/scanner.c
+ * @author agent, agent, VUT FIT
+ * @date 16/10/2026
+ * @brief Throughput benchmark of the scanner on synthetic corpora.
+ *
+ * Every corpus is generated into a temporary file, scanned by `scanner_advance` until EOF and reported as a single
+ * JSON line, so the results can be collected and compared between revisions. The time covers only the scanning,
+ * the best of the rounds is reported. Every corpus is scanned in its own child process after the generated text is freed,
+ * so the reported peak RSS is of the scanning alone.
+ *
+ * Usage: bench_scanner [size_mb] [rounds] [big_size_mb]
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include "../../error.h"
+#include "../../scanner.h"
+
+typedef void (*GenerateFn)(String* out, unsigned* seed);
+
+typedef struct {
+    const char* name;
+    GenerateFn generate;
+    bool big;
+} Corpus;
+
+/// Result of scanning a corpus, sent from the child process
+typedef struct {
+    bool ok;
+    unsigned long tokens;
+    double seconds;
+} ScanResult;
+
+static const char* IDENTIFIERS[] = {
+    "counter", "value", "i", "x", "result", "identifier_long_name", "_tmp", "index2", "total", "name",
+};
+static const char* KEYWORDS[] = {"let", "var", "if", "else", "while", "func", "return", "Int", "Double", "String"};
+static const char* OPERATORS[] = {" = ", " + ", " - ", " * ", " / ", " == ", " != ", " <= ", " >= ", " ?? "};
+static const char* STRINGS[] = {
+    "\"a string literal with plain ASCII text in it\"", "\"escaped\\ttext\\n with \\\"quotes\\\" \\u{41}\"",
+    "\"p\xc5\x99\xc3\xadli\xc5\xa1 \xc5\xbelu\xc5\xa5ou\xc4\x8dk\xc3\xbd k\xc5\xaf\xc5\x88\"", "\"\"", "\"x\"",
+    "\"\"\"\n    a block string\n      with two lines\n    \"\"\"",
+};
+static const char* NUMBERS[] = {"0", "42", "9223372036854775807", "3.14", "1e10", "2.5E-3", "1234567890.0987654321"};
+
+static unsigned next_random(unsigned* seed) {
+    *seed = *seed * 1103515245 + 12345;
+    return *seed >> 8;
+}
+
+#define PICK(array, seed) (array)[next_random(seed) % (sizeof(array) / sizeof(*(array)))]
+
+/// Statements built of identifiers, keywords and operators
+static void generate_identifiers(String* out, unsigned* seed) {
+    string_concat_c_str(out, PICK(KEYWORDS, seed));
+    string_push(out, ' ');
+    string_concat_c_str(out, PICK(IDENTIFIERS, seed));
+
+    for (unsigned i = next_random(seed) % 4; i > 0; i--) {
+        string_concat_c_str(out, PICK(OPERATORS, seed));
+        string_concat_c_str(out, PICK(IDENTIFIERS, seed));
+    }
+
+    string_push(out, '\n');
+}
+
+/// Assignments of string and numeric literals
+static void generate_literals(String* out, unsigned* seed) {
+    string_concat_c_str(out, PICK(IDENTIFIERS, seed));
+    string_concat_c_str(out, " = ");
+    string_concat_c_str(out, next_random(seed) % 2 ? PICK(STRINGS, seed) : PICK(NUMBERS, seed));
+    string_push(out, '\n');
+}
+
+/// Line and block comments around short statements
+static void generate_comments(String* out, unsigned* seed) {
+    switch (next_random(seed) % 3) {
+        case 0:
+            string_concat_c_str(out, "// a line comment explaining the next statement in some detail\n");
+            break;
+        case 1:
+            string_concat_c_str(out, "/* a block comment\n * spanning over\n * several lines */\n");
+            break;
+        default:
+            string_concat_c_str(out, "    ");
+            generate_identifiers(out, seed);
+            break;
+    }
+}
+
+/// Block comments nested up to 64 levels deep
+static void generate_nested_comments(String* out, unsigned* seed) {
+    unsigned depth = next_random(seed) % 64 + 1;
+
+    for (unsigned i = 0; i < depth; i++) {
+        string_concat_c_str(out, "/* level ");
+    }
+
+    string_concat_c_str(out, "innermost text * / with stars and slashes\n");
+
+    for (unsigned i = 0; i < depth; i++) {
+        string_concat_c_str(out, " */");
+    }
+
+    string_push(out, '\n');
+}
+
+/// All of the above in a single file
+static void generate_mixed(String* out, unsigned* seed) {
+    static const GenerateFn generators[] = {generate_identifiers, generate_literals, generate_comments,
+                                            generate_identifiers, generate_literals, generate_nested_comments};
+    PICK(generators, seed)(out, seed);
+}
+
+static const Corpus CORPORA[] = {
+    {"identifiers", generate_identifiers, false},  {"literals", generate_literals, false},
+    {"comments", generate_comments, false},        {"nested_comments", generate_nested_comments, false},
+    {"single_file", generate_mixed, true},
+};
+
+static double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/// Generate the corpus into a temporary file of about `size` bytes, `path` is filled with its name
+static bool generate_file(const Corpus* corpus, size_t size, char* path, size_t* length) {
+    String input;
+    string_init(&input);
+    string_reserve(&input, size + 4096);
+    unsigned seed = 1;
+
+    while (input.length < size && !got_error()) {
+        corpus->generate(&input, &seed);
+    }
+
+    int fd = mkstemp(path);
+    FILE* file = fd != -1 ? fdopen(fd, "w") : NULL;
+    bool ok = !got_error() && file && fwrite(string_data(&input), 1, input.length, file) == input.length;
+
+    if (file) {
+        ok = fclose(file) == 0 && ok;
+    } else if (fd != -1) {
+        close(fd);
+    }
+
+    *length = input.length;
+    string_free(&input);
+    return ok;
+}
+
+/// Scan the file `rounds` times, the best time is kept
+static ScanResult scan_file(const char* path, unsigned long rounds) {
+    ScanResult result = {.ok = true, .tokens = 0, .seconds = 0};
+
+    for (unsigned long round = 0; round < rounds; round++) {
+        /// The scanner closes the file in `scanner_free`
+        scanner_init(fopen(path, "r"));
+
+        double start = now();
+        Token token;
+        result.tokens = 0;
+
+        do {
+            token = scanner_advance();
+            result.tokens++;
+        } while (token.type != Token_EOF && !got_error());
+
+        double elapsed = now() - start;
+        scanner_free();
+
+        if (got_error()) {
+            result.ok = false;
+            return result;
+        }
+
+        if (!round || elapsed < result.seconds) {
+            result.seconds = elapsed;
+        }
+    }
+
+    return result;
+}
+
+/// Scan the file in a child process, `peak_rss_kb` is filled with the peak RSS of the child
+static bool scan_in_child(const char* path, unsigned long rounds, ScanResult* result, long* peak_rss_kb) {
+    int fds[2];
+
+    if (pipe(fds)) {
+        return false;
+    }
+
+    fflush(stdout);
+    pid_t pid = fork();
+
+    if (pid == 0) {
+        close(fds[0]);
+        ScanResult child_result = scan_file(path, rounds);
+        bool sent = write(fds[1], &child_result, sizeof(child_result)) == sizeof(child_result);
+        _exit(sent ? 0 : 1);
+    }
+
+    close(fds[1]);
+    bool received = pid != -1 && read(fds[0], result, sizeof(*result)) == sizeof(*result);
+    close(fds[0]);
+
+    int status;
+    struct rusage usage;
+
+    if (pid == -1 || wait4(pid, &status, 0, &usage) != pid || !WIFEXITED(status) || WEXITSTATUS(status)) {
+        return false;
+    }
+
+    *peak_rss_kb = usage.ru_maxrss;
+    return received;
+}
+
+static bool run(const Corpus* corpus, size_t size, unsigned long rounds) {
+    char path[] = "/tmp/bench_scanner_XXXXXX";
+    size_t length;
+
+    if (!generate_file(corpus, size, path, &length)) {
+        fprintf(stderr, "bench_scanner: cannot generate the corpus %s\n", corpus->name);
+        return false;
+    }
+
+    ScanResult result;
+    long peak_rss_kb;
+    bool scanned = scan_in_child(path, rounds, &result, &peak_rss_kb);
+    remove(path);
+
+    if (!scanned || !result.ok) {
+        fprintf(stderr, "bench_scanner: the corpus %s does not scan\n", corpus->name);
+        return false;
+    }
+
+    printf("{\"corpus\": \"%s\", \"bytes\": %zu, \"tokens\": %lu, \"rounds\": %lu, \"seconds\": %.6f, "
+           "\"mb_per_s\": %.1f, \"tokens_per_s\": %.0f, \"peak_rss_kb\": %ld}\n",
+           corpus->name, length, result.tokens, rounds, result.seconds, length / result.seconds / 1e6,
+           result.tokens / result.seconds, peak_rss_kb);
+    fflush(stdout);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    size_t size = (argc > 1 ? strtoul(argv[1], NULL, 10) : 8) << 20;
+    unsigned long rounds = argc > 2 ? strtoul(argv[2], NULL, 10) : 5;
+    size_t big_size = (argc > 3 ? strtoul(argv[3], NULL, 10) : 100) << 20;
+    bool ok = true;
+
+    for (size_t i = 0; i < sizeof(CORPORA) / sizeof(*CORPORA); i++) {
+        /// The big file is scanned only once, it is not much faster the second time
+        ok = run(&CORPORA[i], CORPORA[i].big ? big_size : size, CORPORA[i].big ? 1 : rounds) && ok;
+    }
+
+    return ok ? 0 : 1;
+}
@@ -10,6 +10,17 @@
 #include <string.h>
 #include "test.h"
 
+/// Render the generated instruction and compare it with the expected text
+static bool instruction_is(const GeneratedInstruction* inst, const char* expected) {
+    String code;
+    string_init(&code);
+    code_instruction_render(&code, inst);
+
+    bool same = !strcmp(string_data(&code), expected);
+    string_free(&code);
+    return same;
+}
+
 int main() {
     atexit(summary);
 
@@ -47,18 +58,18 @@ int main() {
 
         code_buf_set(&buf1);
         test(g_code_buf->size == 3);
-        test(strcmp(g_code_buf->buf[0].code.data, ".IFJcode23") == 0);
-        test(strcmp(g_code_buf->buf[1].code.data, "CREATEFRAME") == 0);
-        test(strcmp(g_code_buf->buf[2].code.data, "PUSHFRAME") == 0);
+        test(instruction_is(&g_code_buf->buf[0], ".IFJcode23"));
+        test(instruction_is(&g_code_buf->buf[1], "CREATEFRAME"));
+        test(instruction_is(&g_code_buf->buf[2], "PUSHFRAME"));
 
         code_buf_set(&buf2);
         test(g_code_buf->size == 2);
-        test(strcmp(g_code_buf->buf[0].code.data, "CREATEFRAME") == 0);
-        test(strcmp(g_code_buf->buf[1].code.data, "PUSHFRAME") == 0);
+        test(instruction_is(&g_code_buf->buf[0], "CREATEFRAME"));
+        test(instruction_is(&g_code_buf->buf[1], "PUSHFRAME"));
 
         code_buf_set(&buf3);
         test(g_code_buf->size == 1);
-        test(strcmp(g_code_buf->buf[0].code.data, "POPFRAME") == 0);
+        test(instruction_is(&g_code_buf->buf[0], "POPFRAME"));
     }
 
     suite("code_buf_print_to_string") {
@@ -74,7 +85,7 @@ int main() {
         String inst = code_buf_print_to_string(g_code_buf);
 
         char* expected = ".IFJcode23\nCREATEFRAME\nPUSHFRAME\nCREATEFRAME\nPUSHFRAME\nPOPFRAME\n";
-        test(strcmp(inst.data, expected) == 0);
+        test(strcmp(string_data(&inst), expected) == 0);
         string_free(&inst);
     }
 
@@ -120,28 +131,28 @@ int main() {
         code_generation(Instruction_Stri2Ints, NULL, NULL, NULL);
         code_generation(Instruction_Break, NULL, NULL, NULL);
 
-        test(strcmp(buf1.buf[0].code.data, ".IFJcode23") == 0);
-        test(strcmp(buf1.buf[1].code.data, "CREATEFRAME") == 0);
-        test(strcmp(buf1.buf[2].code.data, "PUSHFRAME") == 0);
-        test(strcmp(buf1.buf[3].code.data, "POPFRAME") == 0);
-        test(strcmp(buf1.buf[4].code.data, "RETURN") == 0);
-        test(strcmp(buf1.buf[5].code.data, "CLEARS") == 0);
-        test(strcmp(buf1.buf[6].code.data, "ADDS") == 0);
-        test(strcmp(buf1.buf[7].code.data, "SUBS") == 0);
-        test(strcmp(buf1.buf[8].code.data, "MULS") == 0);
-        test(strcmp(buf1.buf[9].code.data, "DIVS") == 0);
-        test(strcmp(buf1.buf[10].code.data, "IDIVS") == 0);
-        test(strcmp(buf1.buf[11].code.data, "LTS") == 0);
-        test(strcmp(buf1.buf[12].code.data, "GTS") == 0);
-        test(strcmp(buf1.buf[13].code.data, "EQS") == 0);
-        test(strcmp(buf1.buf[14].code.data, "ANDS") == 0);
-        test(strcmp(buf1.buf[15].code.data, "ORS") == 0);
-        test(strcmp(buf1.buf[16].code.data, "NOTS") == 0);
-        test(strcmp(buf1.buf[17].code.data, "INT2FLOATS") == 0);
-        test(strcmp(buf1.buf[18].code.data, "FLOAT2INTS") == 0);
-        test(strcmp(buf1.buf[19].code.data, "INT2CHARS") == 0);
-        test(strcmp(buf1.buf[20].code.data, "STRI2INTS") == 0);
-        test(strcmp(buf1.buf[21].code.data, "BREAK") == 0);
+        test(instruction_is(&buf1.buf[0], ".IFJcode23"));
+        test(instruction_is(&buf1.buf[1], "CREATEFRAME"));
+        test(instruction_is(&buf1.buf[2], "PUSHFRAME"));
+        test(instruction_is(&buf1.buf[3], "POPFRAME"));
+        test(instruction_is(&buf1.buf[4], "RETURN"));
+        test(instruction_is(&buf1.buf[5], "CLEARS"));
+        test(instruction_is(&buf1.buf[6], "ADDS"));
+        test(instruction_is(&buf1.buf[7], "SUBS"));
+        test(instruction_is(&buf1.buf[8], "MULS"));
+        test(instruction_is(&buf1.buf[9], "DIVS"));
+        test(instruction_is(&buf1.buf[10], "IDIVS"));
+        test(instruction_is(&buf1.buf[11], "LTS"));
+        test(instruction_is(&buf1.buf[12], "GTS"));
+        test(instruction_is(&buf1.buf[13], "EQS"));
+        test(instruction_is(&buf1.buf[14], "ANDS"));
+        test(instruction_is(&buf1.buf[15], "ORS"));
+        test(instruction_is(&buf1.buf[16], "NOTS"));
+        test(instruction_is(&buf1.buf[17], "INT2FLOATS"));
+        test(instruction_is(&buf1.buf[18], "FLOAT2INTS"));
+        test(instruction_is(&buf1.buf[19], "INT2CHARS"));
+        test(instruction_is(&buf1.buf[20], "STRI2INTS"));
+        test(instruction_is(&buf1.buf[21], "BREAK"));
 
         code_buf_free(&buf1);
     }
@@ -151,17 +162,17 @@ int main() {
 
         symb.symbol.type = SymbolType_Variable;
         symb.symbol.variable.frame = Frame_Local;
-        symb.symbol.variable.name = "test_sym";
+        symb.symbol.variable.name = strview_from_c_str("test_sym");
 
         code_generation(Instruction_Pushs, &symb, NULL, NULL);
         code_generation(Instruction_Write, &symb, NULL, NULL);
         code_generation(Instruction_Exit, &symb, NULL, NULL);
         code_generation(Instruction_DebugPrint, &symb, NULL, NULL);
 
-        test(strcmp(buf1.buf[0].code.data, "PUSHS LF@test_sym") == 0);
-        test(strcmp(buf1.buf[1].code.data, "WRITE LF@test_sym") == 0);
-        test(strcmp(buf1.buf[2].code.data, "EXIT LF@test_sym") == 0);
-        test(strcmp(buf1.buf[3].code.data, "DPRINT LF@test_sym") == 0);
+        test(instruction_is(&buf1.buf[0], "PUSHS LF@test_sym"));
+        test(instruction_is(&buf1.buf[1], "WRITE LF@test_sym"));
+        test(instruction_is(&buf1.buf[2], "EXIT LF@test_sym"));
+        test(instruction_is(&buf1.buf[3], "DPRINT LF@test_sym"));
 
         code_buf_free(&buf1);
     }
@@ -169,13 +180,13 @@ int main() {
     suite("Instructions: var") {
         Operand var;
         var.variable.frame = Frame_Global;
-        var.variable.name = "test_var";
+        var.variable.name = strview_from_c_str("test_var");
 
         code_generation(Instruction_DefVar, &var, NULL, NULL);
         code_generation(Instruction_Pops, &var, NULL, NULL);
 
-        test(strcmp(buf1.buf[0].code.data, "DEFVAR GF@test_var") == 0);
-        test(strcmp(buf1.buf[1].code.data, "POPS GF@test_var") == 0);
+        test(instruction_is(&buf1.buf[0], "DEFVAR GF@test_var"));
+        test(instruction_is(&buf1.buf[1], "POPS GF@test_var"));
 
         code_buf_free(&buf1);
     }
@@ -185,7 +196,7 @@ int main() {
         Operand type;
 
         var.variable.frame = Frame_Temporary;
-        var.variable.name = "test_var";
+        var.variable.name = strview_from_c_str("test_var");
 
         type.data_type = DataType_Int;
         code_generation(Instruction_Read, &var, &type, NULL);
@@ -196,10 +207,10 @@ int main() {
         type.data_type = DataType_Bool;
         code_generation(Instruction_Read, &var, &type, NULL);
 
-        test(strcmp(buf1.buf[0].code.data, "READ TF@test_var int") == 0);
-        test(strcmp(buf1.buf[1].code.data, "READ TF@test_var float") == 0);
-        test(strcmp(buf1.buf[2].code.data, "READ TF@test_var string") == 0);
-        test(strcmp(buf1.buf[3].code.data, "READ TF@test_var bool") == 0);
+        test(instruction_is(&buf1.buf[0], "READ TF@test_var int"));
+        test(instruction_is(&buf1.buf[1], "READ TF@test_var float"));
+        test(instruction_is(&buf1.buf[2], "READ TF@test_var string"));
+        test(instruction_is(&buf1.buf[3], "READ TF@test_var bool"));
 
         code_buf_free(&buf1);
     }
@@ -209,7 +220,7 @@ int main() {
         Operand symb;
 
         var.variable.frame = Frame_Global;
-        var.variable.name = "test_var";
+        var.variable.name = strview_from_c_str("test_var");
         symb.symbol.type = SymbolType_Constant;
         symb.symbol.constant.value.number = -87842;
         symb.symbol.constant.type = DataType_Int;
@@ -223,13 +234,13 @@ int main() {
         code_generation(Instruction_Strlen, &var, &symb, NULL);
         code_generation(Instruction_Type, &var, &symb, NULL);
 
-        test(strcmp(buf1.buf[0].code.data, "MOVE GF@test_var int@-87842") == 0);
-        test(strcmp(buf1.buf[1].code.data, "INT2FLOAT GF@test_var int@-87842") == 0);
-        test(strcmp(buf1.buf[2].code.data, "FLOAT2INT GF@test_var int@-87842") == 0);
-        test(strcmp(buf1.buf[3].code.data, "INT2CHAR GF@test_var int@-87842") == 0);
-        test(strcmp(buf1.buf[4].code.data, "STRI2INT GF@test_var int@-87842") == 0);
-        test(strcmp(buf1.buf[5].code.data, "STRLEN GF@test_var int@-87842") == 0);
-        test(strcmp(buf1.buf[6].code.data, "TYPE GF@test_var int@-87842") == 0);
+        test(instruction_is(&buf1.buf[0], "MOVE GF@test_var int@-87842"));
+        test(instruction_is(&buf1.buf[1], "INT2FLOAT GF@test_var int@-87842"));
+        test(instruction_is(&buf1.buf[2], "FLOAT2INT GF@test_var int@-87842"));
+        test(instruction_is(&buf1.buf[3], "INT2CHAR GF@test_var int@-87842"));
+        test(instruction_is(&buf1.buf[4], "STRI2INT GF@test_var int@-87842"));
+        test(instruction_is(&buf1.buf[5], "STRLEN GF@test_var int@-87842"));
+        test(instruction_is(&buf1.buf[6], "TYPE GF@test_var int@-87842"));
 
         code_buf_free(&buf1);
     }
@@ -240,14 +251,14 @@ int main() {
         Operand symb2;
 
         var.variable.frame = Frame_Global;
-        var.variable.name = "test_var";
+        var.variable.name = strview_from_c_str("test_var");
         symb1.symbol.type = SymbolType_Constant;
         symb1.symbol.constant.value.is_true = true;
         symb1.symbol.constant.type = DataType_Bool;
         symb1.symbol.constant.is_nil = false;
         symb2.symbol.type = SymbolType_Variable;
         symb2.symbol.variable.frame = Frame_Temporary;
-        symb2.symbol.variable.name = "test_sym";
+        symb2.symbol.variable.name = strview_from_c_str("test_sym");
 
         code_generation(Instruction_Add, &var, &symb1, &symb2);
         code_generation(Instruction_Sub, &var, &symb1, &symb2);
@@ -259,32 +270,32 @@ int main() {
         code_generation(Instruction_Eq, &var, &symb1, &symb2);
         code_generation(Instruction_And, &var, &symb1, &symb2);
         code_generation(Instruction_Or, &var, &symb1, &symb2);
-        code_generation(Instruction_Not, &var, &symb1, &symb2);
+        code_generation(Instruction_Not, &var, &symb1, NULL);
         code_generation(Instruction_Concat, &var, &symb1, &symb2);
         code_generation(Instruction_GetChar, &var, &symb1, &symb2);
         code_generation(Instruction_SetChar, &var, &symb1, &symb2);
 
-        test(strcmp(buf1.buf[0].code.data, "ADD GF@test_var bool@true TF@test_sym") == 0);
-        test(strcmp(buf1.buf[1].code.data, "SUB GF@test_var bool@true TF@test_sym") == 0);
-        test(strcmp(buf1.buf[2].code.data, "MUL GF@test_var bool@true TF@test_sym") == 0);
-        test(strcmp(buf1.buf[3].code.data, "DIV GF@test_var bool@true TF@test_sym") == 0);
-        test(strcmp(buf1.buf[4].code.data, "IDIV GF@test_var bool@true TF@test_sym") == 0);
-        test(strcmp(buf1.buf[5].code.data, "LT GF@test_var bool@true TF@test_sym") == 0);
-        test(strcmp(buf1.buf[6].code.data, "GT GF@test_var bool@true TF@test_sym") == 0);
-        test(strcmp(buf1.buf[7].code.data, "EQ GF@test_var bool@true TF@test_sym") == 0);
-        test(strcmp(buf1.buf[8].code.data, "AND GF@test_var bool@true TF@test_sym") == 0);
-        test(strcmp(buf1.buf[9].code.data, "OR GF@test_var bool@true TF@test_sym") == 0);
-        test(strcmp(buf1.buf[10].code.data, "NOT GF@test_var bool@true TF@test_sym") == 0);
-        test(strcmp(buf1.buf[11].code.data, "CONCAT GF@test_var bool@true TF@test_sym") == 0);
-        test(strcmp(buf1.buf[12].code.data, "GETCHAR GF@test_var bool@true TF@test_sym") == 0);
-        test(strcmp(buf1.buf[13].code.data, "SETCHAR GF@test_var bool@true TF@test_sym") == 0);
+        test(instruction_is(&buf1.buf[0], "ADD GF@test_var bool@true TF@test_sym"));
+        test(instruction_is(&buf1.buf[1], "SUB GF@test_var bool@true TF@test_sym"));
+        test(instruction_is(&buf1.buf[2], "MUL GF@test_var bool@true TF@test_sym"));
+        test(instruction_is(&buf1.buf[3], "DIV GF@test_var bool@true TF@test_sym"));
+        test(instruction_is(&buf1.buf[4], "IDIV GF@test_var bool@true TF@test_sym"));
+        test(instruction_is(&buf1.buf[5], "LT GF@test_var bool@true TF@test_sym"));
+        test(instruction_is(&buf1.buf[6], "GT GF@test_var bool@true TF@test_sym"));
+        test(instruction_is(&buf1.buf[7], "EQ GF@test_var bool@true TF@test_sym"));
+        test(instruction_is(&buf1.buf[8], "AND GF@test_var bool@true TF@test_sym"));
+        test(instruction_is(&buf1.buf[9], "OR GF@test_var bool@true TF@test_sym"));
+        test(instruction_is(&buf1.buf[10], "NOT GF@test_var bool@true"));
+        test(instruction_is(&buf1.buf[11], "CONCAT GF@test_var bool@true TF@test_sym"));
+        test(instruction_is(&buf1.buf[12], "GETCHAR GF@test_var bool@true TF@test_sym"));
+        test(instruction_is(&buf1.buf[13], "SETCHAR GF@test_var bool@true TF@test_sym"));
 
         code_buf_free(&buf1);
     }
 
     suite("Instructions: label") {
         Operand label;
-        label.label = "test_label";
+        label.label = strview_from_c_str("test_label");
 
         code_generation(Instruction_Call, &label, NULL, NULL);
         code_generation(Instruction_Label, &label, NULL, NULL);
@@ -292,11 +303,11 @@ int main() {
         code_generation(Instruction_JumpIfEqs, &label, NULL, NULL);
         code_generation(Instruction_JumpIfNeqs, &label, NULL, NULL);
 
-        test(strcmp(buf1.buf[0].code.data, "CALL test_label") == 0);
-        test(strcmp(buf1.buf[1].code.data, "LABEL test_label") == 0);
-        test(strcmp(buf1.buf[2].code.data, "JUMP test_label") == 0);
-        test(strcmp(buf1.buf[3].code.data, "JUMPIFEQS test_label") == 0);
-        test(strcmp(buf1.buf[4].code.data, "JUMPIFNEQS test_label") == 0);
+        test(instruction_is(&buf1.buf[0], "CALL test_label"));
+        test(instruction_is(&buf1.buf[1], "LABEL test_label"));
+        test(instruction_is(&buf1.buf[2], "JUMP test_label"));
+        test(instruction_is(&buf1.buf[3], "JUMPIFEQS test_label"));
+        test(instruction_is(&buf1.buf[4], "JUMPIFNEQS test_label"));
 
         code_buf_free(&buf1);
     }
@@ -306,10 +317,10 @@ int main() {
         Operand symb1;
         Operand symb2;
 
-        label.label = "test_label";
+        label.label = strview_from_c_str("test_label");
         symb1.symbol.type = SymbolType_Variable;
         symb1.symbol.variable.frame = Frame_Local;
-        symb1.symbol.variable.name = "test_sym";
+        symb1.symbol.variable.name = strview_from_c_str("test_sym");
         symb2.symbol.type = SymbolType_Constant;
         symb2.symbol.constant.is_nil = false;
         symb2.symbol.constant.type = DataType_String;
@@ -318,8 +329,8 @@ int main() {
         code_generation(Instruction_JumpIfEq, &label, &symb1, &symb2);
         code_generation(Instruction_JumpIfNeq, &label, &symb1, &symb2);
 
-        test(strcmp(buf1.buf[0].code.data, "JUMPIFEQ test_label LF@test_sym string@test") == 0);
-        test(strcmp(buf1.buf[1].code.data, "JUMPIFNEQ test_label LF@test_sym string@test") == 0);
+        test(instruction_is(&buf1.buf[0], "JUMPIFEQ test_label LF@test_sym string@test"));
+        test(instruction_is(&buf1.buf[1], "JUMPIFNEQ test_label LF@test_sym string@test"));
 
         string_free(&symb2.symbol.constant.value.string);
         code_buf_free(&buf1);
@@ -327,7 +338,7 @@ int main() {
 
     suite("Empty Label") {
         Operand label;
-        label.label = "";
+        label.label = strview_from_c_str("");
         code_generation(Instruction_Label, &label, NULL, NULL);
 
         test(got_error());
@@ -338,11 +349,11 @@ int main() {
 
     suite("Label") {
         Operand label;
-        label.label = "retezec s lomitkem \\ a\nnovym#radkem";
+        label.label = strview_from_c_str("retezec s lomitkem \\ a\nnovym#radkem");
         code_generation(Instruction_Label, &label, NULL, NULL);
 
         char* expected = "LABEL retezec\\032s\\032lomitkem\\032\\092\\032a\\010novym\\035radkem";
-        test(strcmp(buf1.buf[0].code.data, expected) == 0);
+        test(instruction_is(&buf1.buf[0], expected));
         code_buf_free(&buf1);
     }
 
@@ -358,7 +369,7 @@ int main() {
         symb.symbol.constant.value.number_double = -1e-10;
 
         code_generation(Instruction_DebugPrint, &symb, NULL, NULL);
-        test(strcmp(buf1.buf[0].code.data, "DPRINT float@-0x1.b7cdfd9d7bdbbp-34") == 0);
+        test(instruction_is(&buf1.buf[0], "DPRINT float@-0x1.b7cdfd9d7bdbbp-34"));
 
         code_buf_free(&buf1);
     }
@@ -372,7 +383,7 @@ int main() {
         code_generation(Instruction_DebugPrint, &str, NULL, NULL);
 
         char* expected = "DPRINT string@retezec\\032s\\032lomitkem\\032\\092\\032a\\010novym\\035radkem";
-        test(strcmp(buf1.buf[0].code.data, expected) == 0);
+        test(instruction_is(&buf1.buf[0], expected));
         string_free(&str.symbol.constant.value.string);
         code_buf_free(&buf1);
     }
@@ -386,8 +397,75 @@ int main() {
         code_generation(Instruction_DebugPrint, &nil, NULL, NULL);
 
         char* expected = "DPRINT nil@nil";
-        test(strcmp(buf1.buf[0].code.data, expected) == 0);
+        test(instruction_is(&buf1.buf[0], expected));
+        code_buf_free(&buf1);
+    }
+
+    suite("Raw instructions") {
+        Operand var;
+        Operand symb;
+        var.variable.frame = Frame_Global;
+        var.variable.name = strview_from_c_str("x%0");
+        symb.symbol.type = SymbolType_Constant;
+        symb.symbol.constant.is_nil = false;
+        symb.symbol.constant.type = DataType_Int;
+        symb.symbol.constant.value.number = 42;
+
+        code_generation(Instruction_Move, &var, &symb, NULL);
+        code_generation_raw("MOVE GF@x%%0 int@%d", 42);
+        code_generation_raw("JUMPIFEQ while%i_end TF@res bool@true", 3);
+        code_generation_raw("READ LF@ret string");
+
+        /// Parsed operands are interned like the structured ones
+        test(buf1.size == 4);
+        test(buf1.buf[1].inst == Instruction_Move && buf1.buf[1].operand_count == 2);
+        test(!memcmp(buf1.buf[0].operands, buf1.buf[1].operands, sizeof(CodeOperand) * 2));
+        test(buf1.buf[2].operands[0].kind == CodeOperand_Label);
+        test(buf1.buf[2].operands[1].kind == CodeOperand_Variable && buf1.buf[2].operands[1].frame == Frame_Temporary);
+        test(buf1.buf[2].operands[2].kind == CodeOperand_Constant);
+        test(buf1.buf[3].operands[1].kind == CodeOperand_Type);
+        test(instruction_is(&buf1.buf[1], "MOVE GF@x%0 int@42"));
+        test(instruction_is(&buf1.buf[2], "JUMPIFEQ while3_end TF@res bool@true"));
+        test(instruction_is(&buf1.buf[3], "READ LF@ret string"));
+
+        code_generation_raw("NOSUCH GF@x");
+        test(got_error());
+        test(buf1.size == 4);
+
+        set_error(Error_None);
         code_buf_free(&buf1);
+        code_generation_free();
+    }
+
+    suite("CodeBuf pool") {
+        code_buf_init(&buf2);
+        test(!buf2.buf && !buf2.capacity);
+
+        /// The capacity grows geometrically
+        code_buf_set(&buf2);
+        for (int i = 0; i < 100; i++) {
+            code_generation(Instruction_Return, NULL, NULL, NULL);
+        }
+        test(buf2.size == 100);
+        test(buf2.capacity == 128);
+        test(instruction_is(&buf2.buf[99], "RETURN"));
+
+        /// Released storage is reused by the next CodeBuf of the same capacity
+        code_buf_set(&buf1);
+        code_generation(Instruction_Break, NULL, NULL, NULL);
+        GeneratedInstruction* storage = buf1.buf;
+        code_buf_free(&buf1);
+        test(!buf1.buf && !buf1.capacity);
+
+        code_buf_set(&buf3);
+        code_buf_init(&buf3);
+        code_generation(Instruction_Clears, NULL, NULL, NULL);
+        test(buf3.buf == storage);
+        test(instruction_is(&buf3.buf[0], "CLEARS"));
+
+        code_buf_free(&buf2);
+        code_buf_free(&buf3);
+        code_generation_free();
     }
     return 0;
 }
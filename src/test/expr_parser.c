@@ -32,6 +32,28 @@
         set_error(Error_None);                        \
     } while (0)
 
+/// Generate the code of the expression into a new buffer, `expected` is searched for in the code
+#define TEST_GENERATED_CODE(str, expected)                   \
+    do {                                                     \
+        CodeBuf code;                                        \
+        code_buf_init(&code);                                \
+        code_buf_set(&code);                                 \
+        scanner_init_str(str);                               \
+        parser_next_token();                                 \
+        test(expr_parser_begin(&expr_data) == true);         \
+        String result = code_buf_print_to_string(&code);     \
+        const char* text = string_data(&result);             \
+        test(text != NULL && strstr(text, expected) != NULL); \
+        string_free(&result);                                \
+        code_buf_free(&code);                                \
+        code_buf_set(&buf);                                  \
+        scanner_free();                                      \
+    } while (0)
+
+/// The whole expression is computed at compile time, only its value is moved to the result
+#define TEST_FOLDED_EXPRESSION(str, value) \
+    TEST_GENERATED_CODE(str, "CREATEFRAME\nDEFVAR TF@res\nMOVE TF@res " value "\n")
+
 #define INSERT_VARIABLE(name, dt)                              \
     do {                                                       \
         VariableSymbol name;                                   \
@@ -51,7 +73,8 @@
         string_concat_c_str(&name.code_name, #name);                                                   \
         Param params[] = {__VA_ARGS__};                                                                \
         for (size_t i = 0; i < sizeof(params) / sizeof(params[0]); i++) {                              \
-            function_symbol_emplace_param(&name, (params[i]).param_dt, (params[i]).param_name, #name); \
+            function_symbol_emplace_param(&name, (params[i]).param_dt, strview_from_c_str((params[i]).param_name), \
+                                          strview_from_c_str(#name));                                           \
         }                                                                                              \
         symtable_insert_function(symstack_top(), #name, name);                                         \
     } while (0)
@@ -61,6 +84,7 @@
         FunctionSymbol name;                                   \
         function_symbol_init(&name);                           \
         name.return_value_type = dt;                           \
+        string_concat_c_str(&name.code_name, #name);           \
         symtable_insert_function(symstack_top(), #name, name); \
     } while (0)
 
@@ -162,6 +186,29 @@ int main() {
         TEST_VALID_EXPRESSION("\"fds\" + str(\"asdf\", \"dsf\") != \"fd\"", DataType_Bool);
     }
 
+    suite("Test constant folding") {
+        TEST_FOLDED_EXPRESSION("1 + 2 * 3", "int@7");
+        TEST_FOLDED_EXPRESSION("7 / 2", "int@3");
+        TEST_FOLDED_EXPRESSION("1.5 + 1", "float@0x1.4p+1");
+        TEST_FOLDED_EXPRESSION("-(2 - 5)", "int@3");
+        TEST_FOLDED_EXPRESSION("\"ab\" + \"\" + \"c d\"", "string@abc\\032d");
+        TEST_FOLDED_EXPRESSION("\"ab\" < \"abc\"", "bool@true");
+        TEST_FOLDED_EXPRESSION("1 <= 0.5", "bool@false");
+        TEST_FOLDED_EXPRESSION("!(true && false) == true", "bool@true");
+        TEST_FOLDED_EXPRESSION("nil == nil", "bool@true");
+        TEST_FOLDED_EXPRESSION("nil ?? 4", "int@4");
+        TEST_FOLDED_EXPRESSION("2 ?? 4", "int@2");
+    }
+
+    suite("Test constant expressions computed at runtime") {
+        TEST_GENERATED_CODE("1 / 0", "IDIV");
+        TEST_GENERATED_CODE("-7 / 2", "IDIV");
+        TEST_GENERATED_CODE("1.0 / 0.0", "DIV");
+        TEST_GENERATED_CODE("9223372036854775807 + 1", "ADD");
+        TEST_GENERATED_CODE("a + 1 * 2", "ADD TF@");
+        TEST_GENERATED_CODE("one(x: 2 * 3)", " int@6\nCALL");
+    }
+
     set_print_errors(false);
 
     suite("Test invalid arithmetic expressions") {
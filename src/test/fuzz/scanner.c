@@ -0,0 +1,176 @@
+/**
+ * @note Project: Implementace překladače imperativního jazyka IFJ23
+ * @file test/fuzz/scanner.c
+ * @author agent, agent, VUT FIT
+ * @date 16/10/2026
+ * @brief Differential fuzzing driver for the scanner.
+ *
+ * Generates pseudo random inputs from fragments of the language and prints the resulting token stream.
+ * The driver is linked once with the table driven DFA and once with the reference `step_*` functions
+ * (`-DSCANNER_REFERENCE_DFA`), `make fuzz-scanner` then compares both outputs.
+ *
+ * Usage: scanner_fuzz [count] [first_seed]
+ */
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "../../error.h"
+#include "../../scanner.h"
+
+#define MAX_FRAGMENTS 64
+
+/// Fragments that mostly form valid tokens
+static const char* FRAGMENTS[] = {
+    "let",     "var",        "func",        "if",        "else",       "while",     "return",   "Int",
+    "Double",  "String",     "Bool",        "nil",       "true",       "false",     "a",        "_x1",
+    "Int?",    "String?",    "abc?",        "e",         "0",          "42",        "3.14",     "1e10",
+    "2.5E-3",  "7e+2",       "\"abc\"",     "\"\"",      "\"a\\n\\t\\\\\\\"b\"", "\"\\u{41}\"", "\"\\u{4a}x\"",
+    "\"\"\"\nabc\n\"\"\"",   "\"\"\"\n  a\\tb\n  \"\"\"",  "\"\"\"\n\"x\"\ny\n\t\"\"\"", "/* c */", "/* /* n */ */",
+    "/**/",    "// line\n",  "/",           "*",         "+",          "-",         "->",       "=",
+    "==",      "!",          "!=",          "<",         "<=",         ">",         ">=",       "&&",
+    "||",      "??",         ":",           ",",         "(",          ")",         "{",        "}",
+    " ",       "  ",         "\t",          "\n",        "\n\n",       "\r",        "\v",       "\f",
+    /// Runs longer than a SIMD block for the whitespace and comment skipping
+    "                                        ",
+    "\n    \t\t\n\n        \r\n                       \n            ",
+    "// a rather long line comment that spans over more than a single block\n",
+    "/* a rather long block comment\n * over several lines\n * with / and * inside */",
+    "/* nested /* block comment with a lot of text inside of it, again longer than a block */ */",
+    /// Literals longer than a SWAR block of digits
+    "9223372036854775807", "000000000000000000042", "1234567890.0987654321", "0.000000000000000000000123",
+    "12345678901234567e-300", "4.9e-324", "123e25",
+    /// String literals with UTF-8 and runs longer than a SIMD block
+    "\"h\xc3\xa9llo \xe2\x82\xac \xf0\x9f\x98\x80\"", "\"\\u{e9}\xc3\xa9\\u{7f}\"",
+    "\"a string literal that is longer than a single block of 32 bytes\"",
+    "\"\"\"\n  a block string with \xc3\xa9 and a line longer than a block\n  \"\"\"",
+    "\"\"\"\n  first\n\n    \"\"second \\t\n \t\n  \"\"\"", "\"\"\"\n\"\"\"",
+};
+
+/// Fragments that are likely to end the scanning with an error
+static const char* RARE_FRAGMENTS[] = {
+    "\"",   "\"\"\"", "\\",   "\\n",     "\\u{",   "\\u{4",  "\\u{fff}", "\\x",  "/*", "*/", "1.",     "1e",
+    "1e+",  "?",      "&",    "|",       ".",      ";",      "@",        "#",    "\x01", "\x7f", "\x80", "\xc3\xa1",
+    "\"\n", "\"\\q\"", "\"\\u{zz}\"", "\"\\u{123}\"", "\"\"\"x", "99999999999", "1.99999999999", "1e99999999999",
+    "9223372036854775808", "1e309", "\"\xc3(\"", "\"\xed\xa0\x80\"", "\"\xf4\x90\x80\x80\"", "\"\xe2\x82\"",
+    "\"\xff\"", "\"\"\"\n    ok\n   bad\n    \"\"\"",
+};
+
+static uint64_t g_seed;
+
+/// xorshift64*, deterministic on every platform
+static uint64_t next_random() {
+    g_seed ^= g_seed >> 12;
+    g_seed ^= g_seed << 25;
+    g_seed ^= g_seed >> 27;
+    return g_seed * 0x2545F4914F6CDD1DULL;
+}
+
+static void generate(String* input) {
+    size_t fragment_count = sizeof(FRAGMENTS) / sizeof(*FRAGMENTS);
+    size_t rare_count = sizeof(RARE_FRAGMENTS) / sizeof(*RARE_FRAGMENTS);
+    uint64_t count = next_random() % MAX_FRAGMENTS + 1;
+
+    string_clear(input);
+
+    for (uint64_t i = 0; i < count; i++) {
+        uint64_t random = next_random();
+        const char* fragment = random % 32 ? FRAGMENTS[(random >> 5) % fragment_count]
+                                           : RARE_FRAGMENTS[(random >> 5) % rare_count];
+
+        while (*fragment) {
+            string_push(input, *fragment++);
+        }
+    }
+}
+
+static void print_token(Token token) {
+    printf("%d %zu", token.type, token.offset);
+
+    switch (token.type) {
+        case Token_Whitespace:
+            printf(" eol=%d", token.attribute.has_eol);
+            break;
+        case Token_Operator:
+            printf(" op=%d", token.attribute.op);
+            break;
+        case Token_DataType:
+            printf(" type=%d", token.attribute.data_type);
+            break;
+        case Token_Identifier:
+            printf(" `%s`", string_data(&token.attribute.data.value.string));
+            break;
+        case Token_Data: {
+            Data data = token.attribute.data;
+            printf(" nil=%d type=%d", data.is_nil, data.type);
+
+            if (data.is_nil) {
+                break;
+            }
+
+            switch (data.type) {
+                case DataType_Int:
+                    printf(" %" PRId64, data.value.number);
+                    break;
+                case DataType_Double:
+                    printf(" %a", data.value.number_double);
+                    break;
+                case DataType_String: {
+                    const char* str = string_data(&data.value.string);
+                    printf(" \"%.*s\"", (int)data.value.string.length, str ? str : "");
+                    break;
+                }
+                case DataType_Bool:
+                    printf(" %d", data.value.is_true);
+                    break;
+                default:
+                    break;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+
+    printf("\n");
+}
+
+int main(int argc, char** argv) {
+    unsigned long count = argc > 1 ? strtoul(argv[1], NULL, 10) : 10000;
+    unsigned long first = argc > 2 ? strtoul(argv[2], NULL, 10) : 1;
+    String input;
+    string_init(&input);
+
+    /// Error messages go into the compared output as well
+    setvbuf(stdout, NULL, _IONBF, 0);
+    dup2(fileno(stdout), fileno(stderr));
+
+    for (unsigned long seed = first; seed < first + count; seed++) {
+        set_error(Error_None);
+        g_seed = seed * 0x9E3779B97F4A7C15ULL + 1;
+        generate(&input);
+
+        printf("# seed %lu\n", seed);
+        scanner_init_str(string_data(&input) ? string_data(&input) : "");
+
+        Token token;
+
+        do {
+            token = scanner_advance();
+
+            if (got_error()) {
+                break;
+            }
+
+            print_token(token);
+        } while (token.type != Token_EOF);
+
+        printf("error %d\n", got_error());
+        scanner_free();
+    }
+
+    string_free(&input);
+    return 0;
+}
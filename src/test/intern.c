@@ -0,0 +1,83 @@
+/**
+ * @note Project: Implementace překladače imperativního jazyka IFJ23
+ * @file test/intern.c
+ * @author agent, agent, VUT FIT
+ * @date 16/10/2026
+ * @brief Tester for intern.h
+ */
+
+#include "../intern.h"
+#include <stdbool.h>
+#include <string.h>
+#include "test.h"
+
+int main() {
+    atexit(summary);
+
+    SymbolId foo, bar;
+
+    suite("Test intern_add") {
+        test(intern_find("foo") == SYMBOL_NONE);
+        test(intern_count() == 0);
+
+        foo = intern_add_c_str("foo");
+        bar = intern_add("barbaz", 3);
+        test(foo != SYMBOL_NONE);
+        test(bar != SYMBOL_NONE);
+        test(foo != bar);
+        test(intern_add_c_str("foo") == foo);
+        test(intern_add("bar", 3) == bar);
+        test(intern_count() == 2);
+    }
+
+    suite("Test intern_find") {
+        test(intern_find("foo") == foo);
+        test(intern_find("bar") == bar);
+        test(intern_find("barbaz") == SYMBOL_NONE);
+        test(intern_find("") == SYMBOL_NONE);
+        test(intern_count() == 2);
+    }
+
+    suite("Test intern_get") {
+        test(strcmp(intern_get(foo), "foo") == 0);
+        test(strcmp(intern_get(bar), "bar") == 0);
+
+        String view = intern_view(bar);
+        test(view.length == 3);
+        test(string_capacity(&view) == 0);
+        test(string_data(&view) == intern_get(bar));
+        test(intern_hash(foo) != intern_hash(bar));
+    }
+
+    suite("Test intern growth") {
+        char name[16];
+        const char* foo_name = intern_get(foo);
+        bool same = true;
+
+        for (int i = 0; i < 5000; i++) {
+            sprintf(name, "name%d", i);
+            same = same && intern_add_c_str(name) == (SymbolId)(i + 3);
+        }
+
+        test(same);
+        test(intern_count() == 5002);
+
+        for (int i = 0; i < 5000; i++) {
+            sprintf(name, "name%d", i);
+            same = same && intern_find(name) == (SymbolId)(i + 3) && strcmp(intern_get(i + 3), name) == 0;
+        }
+
+        test(same);
+        /// Names are never moved
+        test(intern_get(foo) == foo_name);
+        test(intern_find("foo") == foo);
+    }
+
+    suite("Test intern_free") {
+        intern_free();
+        test(intern_count() == 0);
+        test(intern_find("foo") == SYMBOL_NONE);
+        test(intern_add_c_str("bar") != SYMBOL_NONE);
+        intern_free();
+    }
+}
@@ -0,0 +1,179 @@
+/**
+ * @note Project: Implementace překladače imperativního jazyka IFJ23
+ * @file test/peephole.c
+ * @author agent, agent, VUT FIT
+ * @date 16/10/2026
+ * @brief Tester for peephole.h
+ */
+
+#include "../peephole.h"
+#include <string.h>
+#include "../error.h"
+#include "test.h"
+
+/// Generate the code into a new buffer, one instruction per line
+static CodeBuf generate(const char* code) {
+    CodeBuf buf;
+    code_buf_init(&buf);
+    code_buf_set(&buf);
+
+    while (*code) {
+        const char* end = strchr(code, '\n');
+        code_generation_raw("%.*s", (int)(end - code), code);
+        code = end + 1;
+    }
+
+    return buf;
+}
+
+/// Optimize the code and compare it with the expected code, the number of removed instructions is checked too
+static bool optimizes_to(const char* code, const char* expected, size_t removed) {
+    CodeBuf buf = generate(code);
+    size_t count = peephole_optimize(&buf);
+    String result = code_buf_print_to_string(&buf);
+
+    bool same = !strcmp(string_data(&result), expected) && count == removed;
+    if (!same) {
+        printf("\n%s(removed %zu)\n", string_data(&result), count);
+    }
+
+    string_free(&result);
+    code_buf_free(&buf);
+    return same;
+}
+
+int main() {
+    atexit(summary);
+
+    suite("Test move chains") {
+        test(optimizes_to("CREATEFRAME\n"
+                          "DEFVAR TF@tmp1\n"
+                          "MOVE TF@tmp1 int@5\n"
+                          "DEFVAR TF@res\n"
+                          "MOVE TF@res TF@tmp1\n"
+                          "MOVE GF@a%0 TF@res\n"
+                          "CREATEFRAME\n",
+                          "CREATEFRAME\n"
+                          "MOVE GF@a%0 int@5\n"
+                          "CREATEFRAME\n",
+                          4));
+
+        test(optimizes_to("CREATEFRAME\n"
+                          "DEFVAR TF@tmp1\n"
+                          "MOVE TF@tmp1 GF@a%0\n"
+                          "DEFVAR TF@tmp2\n"
+                          "MOVE TF@tmp2 int@1\n"
+                          "DEFVAR TF@tmp3\n"
+                          "SUB TF@tmp3 TF@tmp1 TF@tmp2\n"
+                          "DEFVAR TF@res\n"
+                          "MOVE TF@res TF@tmp3\n"
+                          "MOVE GF@a%0 TF@res\n"
+                          "CREATEFRAME\n",
+                          "CREATEFRAME\n"
+                          "SUB GF@a%0 GF@a%0 int@1\n"
+                          "CREATEFRAME\n",
+                          8));
+
+        /// The copied variable is changed before the temporary is read
+        const char* changed = "CREATEFRAME\n"
+                              "DEFVAR TF@tmp1\n"
+                              "MOVE TF@tmp1 GF@a%0\n"
+                              "MOVE GF@a%0 int@1\n"
+                              "WRITE TF@tmp1\n"
+                              "CREATEFRAME\n";
+        test(optimizes_to(changed, changed, 0));
+
+        /// The temporary is read again after a jump back
+        const char* loop = "LABEL loop\n"
+                           "WRITE TF@tmp1\n"
+                           "CREATEFRAME\n"
+                           "DEFVAR TF@tmp1\n"
+                           "MOVE TF@tmp1 int@1\n"
+                           "WRITE TF@tmp1\n"
+                           "JUMP loop\n";
+        test(optimizes_to(loop, loop, 0));
+
+        /// The temporary frame becomes the local frame of the call
+        const char* call = "CREATEFRAME\n"
+                           "DEFVAR TF@tmp1\n"
+                           "MOVE TF@tmp1 int@1\n"
+                           "PUSHFRAME\n"
+                           "CREATEFRAME\n"
+                           "DEFVAR TF@a%0\n"
+                           "MOVE TF@a%0 LF@tmp1\n"
+                           "CALL func%f\n";
+        test(optimizes_to(call, call, 0));
+    }
+
+    suite("Test compare and branch") {
+        /// a != 5
+        test(optimizes_to("CREATEFRAME\n"
+                          "DEFVAR TF@tmp1\n"
+                          "EQ TF@tmp1 GF@a%0 int@5\n"
+                          "NOT TF@tmp1 TF@tmp1\n"
+                          "DEFVAR TF@res\n"
+                          "MOVE TF@res TF@tmp1\n"
+                          "JUMPIFNEQ if1_after0 TF@res bool@true\n"
+                          "CREATEFRAME\n"
+                          "LABEL if1_after0\n"
+                          "CREATEFRAME\n",
+                          "CREATEFRAME\n"
+                          "JUMPIFEQ if1_after0 GF@a%0 int@5\n"
+                          "CREATEFRAME\n"
+                          "LABEL if1_after0\n"
+                          "CREATEFRAME\n",
+                          5));
+
+        /// a <= 10
+        test(optimizes_to("CREATEFRAME\n"
+                          "DEFVAR TF@tmp1\n"
+                          "LT TF@tmp1 GF@a%0 int@10\n"
+                          "DEFVAR TF@tmp2\n"
+                          "EQ TF@tmp2 GF@a%0 int@10\n"
+                          "OR TF@tmp1 TF@tmp1 TF@tmp2\n"
+                          "JUMPIFNEQ while1_end TF@tmp1 bool@true\n"
+                          "CREATEFRAME\n"
+                          "LABEL while1_end\n"
+                          "CREATEFRAME\n",
+                          "CREATEFRAME\n"
+                          "DEFVAR TF@tmp1\n"
+                          "GT TF@tmp1 GF@a%0 int@10\n"
+                          "JUMPIFEQ while1_end TF@tmp1 bool@true\n"
+                          "CREATEFRAME\n"
+                          "LABEL while1_end\n"
+                          "CREATEFRAME\n",
+                          3));
+
+        /// The result of the comparison is still needed
+        const char* used = "CREATEFRAME\n"
+                           "DEFVAR TF@tmp1\n"
+                           "EQ TF@tmp1 GF@a%0 int@5\n"
+                           "JUMPIFNEQ end TF@tmp1 bool@true\n"
+                           "WRITE TF@tmp1\n"
+                           "LABEL end\n"
+                           "CREATEFRAME\n";
+        test(optimizes_to(used, used, 0));
+    }
+
+    suite("Test jump to the next label") {
+        test(optimizes_to("JUMP if3_end\n"
+                          "LABEL if3_after0\n"
+                          "LABEL if3_end\n"
+                          "JUMP exit\n",
+                          "LABEL if3_after0\n"
+                          "LABEL if3_end\n"
+                          "JUMP exit\n",
+                          1));
+    }
+
+    suite("Test peephole_optimize of an empty buffer") {
+        CodeBuf buf;
+        code_buf_init(&buf);
+        test(peephole_optimize(&buf) == 0);
+        test(!got_error());
+    }
+
+    code_generation_free();
+    intern_free();
+    return 0;
+}
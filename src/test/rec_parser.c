@@ -7,9 +7,14 @@
  */
 
 #include "../parser.h"
+#include <string.h>
+#include <unistd.h>
 #include "../scanner.h"
 #include "test.h"
 
+/// Most lines of the code compared by `same_instructions`
+#define MAX_LINES 1024
+
 int prg_scanner_initialized() {
     scanner_reset_to_beginning();
     MASSERT(!got_error(), "");
@@ -47,6 +52,104 @@ int prg_file(const char* file_path) {
     return prg_scanner_initialized();
 }
 
+/**
+ * Compile the program and return the written IFJcode23, stdout is redirected to a temporary file meanwhile.
+ * `removed` is filled with the number of instructions removed by the peephole optimizer.
+ */
+String compile_to_string(const char* source_code, bool streaming, int optimization, size_t* removed) {
+    FILE* output = tmpfile();
+    int saved_stdout = dup(STDOUT_FILENO);
+    MASSERT(output != NULL && saved_stdout != -1, "");
+
+    fflush(stdout);
+    dup2(fileno(output), STDOUT_FILENO);
+
+    scanner_init_str(source_code);
+    parser_init();
+    parser_set_streaming(streaming);
+    parser_set_optimization(optimization);
+    parser_begin(true);
+    MASSERT(!got_error(), "");
+    *removed = g_parser.removed_instructions;
+    parser_free();
+    scanner_free();
+
+    dup2(saved_stdout, STDOUT_FILENO);
+    close(saved_stdout);
+
+    String code;
+    string_init(&code);
+    char chunk[4096];
+    size_t length;
+
+    rewind(output);
+    while ((length = fread(chunk, 1, sizeof(chunk), output)) > 0) {
+        string_append_n(&code, chunk, length);
+    }
+
+    fclose(output);
+    return code;
+}
+
+size_t count_lines(const String* code) {
+    size_t count = 0;
+    for (size_t i = 0; i < code->length; i++) {
+        count += string_data(code)[i] == '\n';
+    }
+    return count;
+}
+
+int compare_lines(const void* a, const void* b) {
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+/// Sorted lines of the code without the numbers of the temporaries, the jump over the functions is left out
+size_t sorted_lines(String* code, char** lines) {
+    char* text = string_data(code);
+    size_t length = 0;
+
+    // the temporaries are numbered by a counter shared by all compilations
+    for (char* ch = text; *ch; ch++) {
+        text[length++] = *ch;
+        if (length >= 3 && !strncmp(text + length - 3, "tmp", 3)) {
+            while (ch[1] >= '0' && ch[1] <= '9') {
+                ch++;
+            }
+        }
+    }
+    text[length] = '\0';
+
+    size_t count = 0;
+    for (char* line = strtok(text, "\n"); line && count < MAX_LINES; line = strtok(NULL, "\n")) {
+        if (strcmp(line, "JUMP main%") && strcmp(line, "LABEL main%")) {
+            lines[count++] = line;
+        }
+    }
+
+    qsort(lines, count, sizeof(*lines), compare_lines);
+    return count;
+}
+
+/// Check that the streamed code consists of the same instructions as the buffered one
+bool same_instructions(String* buffered, String* streamed) {
+    static char* buffered_lines[MAX_LINES];
+    static char* streamed_lines[MAX_LINES];
+    size_t count = sorted_lines(buffered, buffered_lines);
+
+    if (count != sorted_lines(streamed, streamed_lines)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (strcmp(buffered_lines[i], streamed_lines[i])) {
+            printf("\n%s\n%s\n", buffered_lines[i], streamed_lines[i]);
+            return false;
+        }
+    }
+
+    return count > 0;
+}
+
 int main() {
     atexit(summary);
 
@@ -326,5 +429,56 @@ int main() {
         test(prg_file("test/examples/builtin_functions.swift") == 0);
     }
 
+    suite("Test Parser streaming mode") {
+        const char* program = "func add(_ a: Int, _ b: Int) -> Int {\n"
+                              "    return a + b\n"
+                              "}\n"
+                              "func twice(of x: Double) -> Double {\n"
+                              "    let y = x * 2\n"
+                              "    return y\n"
+                              "}\n"
+                              "var i = 0\n"
+                              "while i < 3 {\n"
+                              "    i = add(i, 1)\n"
+                              "    if i == 2 { write(twice(of: 1.5)) } else { write(length(\"abc\")) }\n"
+                              "}\n";
+
+        size_t removed;
+        String buffered = compile_to_string(program, false, 1, &removed);
+        String streamed = compile_to_string(program, true, 1, &removed);
+
+        // the functions are written first, the program jumps over them
+        const char* start = ".IFJcode23\nJUMP main%\nLABEL func%add\n";
+        const char* main_label = strstr(string_data(&streamed), "LABEL main%\n");
+        test(!strncmp(string_data(&streamed), start, strlen(start)));
+        test(main_label != NULL);
+        test(strstr(string_data(&streamed), "LABEL func%twice\n") < main_label);
+        test(strstr(string_data(&buffered), "LABEL main%") == NULL);
+
+        test(same_instructions(&buffered, &streamed));
+
+        string_free(&buffered);
+        string_free(&streamed);
+    }
+
+    suite("Test Parser count of removed instructions") {
+        const char* program = "var a = 1\n"
+                              "while a <= 10 {\n"
+                              "    a = a + 1\n"
+                              "}\n"
+                              "write(a)\n";
+        size_t removed;
+
+        String code = compile_to_string(program, false, 0, &removed);
+        size_t generated = count_lines(&code);
+        test(removed == 0);
+        string_free(&code);
+
+        code = compile_to_string(program, false, 1, &removed);
+        test(removed > 0);
+        test(count_lines(&code) + removed == generated);
+        string_free(&code);
+    }
+
     return 0;
 }
@@ -7,9 +7,112 @@
  */
 
 #include "../scanner.h"
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
 #include <string.h>
 #include "test.h"
 
+/// String literals may borrow the input and are not null terminated, compare them by length
+static bool data_equals(Token token, const char* expected) {
+    String str = token.attribute.data.value.string;
+    return str.length == strlen(expected) && (!str.length || memcmp(string_data(&str), expected, str.length) == 0);
+}
+
+/// Write every remaining token of the scanner as text into `out`, up to the end or the error
+static bool token_at(Token token, size_t line, size_t column) {
+    size_t token_line, token_column;
+    scanner_position(token.offset, &token_line, &token_column);
+    return token_line == line && token_column == column;
+}
+
+static void scanner_to_text(String* out) {
+    char buffer[128];
+    Token token;
+
+    do {
+        token = scanner_advance();
+        Data data = token.attribute.data;
+
+        /// The string functions do nothing while an error is set
+        if (got_error()) {
+            set_error(Error_None);
+            string_concat_c_str(out, "error\n");
+            return;
+        }
+
+        snprintf(buffer, sizeof(buffer), "%d %zu %u ", token.type, token.offset, token.symbol);
+        string_concat_c_str(out, buffer);
+
+        if (token.type == Token_Data && !data.is_nil && data.type == DataType_String) {
+            for (size_t i = 0; i < data.value.string.length; i++) {
+                string_push(out, string_data(&data.value.string)[i]);
+            }
+        } else if (token.type == Token_Data && !data.is_nil) {
+            snprintf(buffer, sizeof(buffer), "%d %" PRId64 " %a", data.type, data.value.number, data.value.number_double);
+            string_concat_c_str(out, buffer);
+        } else if (token.type == Token_Operator) {
+            snprintf(buffer, sizeof(buffer), "%d", token.attribute.op);
+            string_concat_c_str(out, buffer);
+        } else if (token.type == Token_DataType) {
+            snprintf(buffer, sizeof(buffer), "%d", token.attribute.data_type);
+            string_concat_c_str(out, buffer);
+        } else if (token.type == Token_Whitespace) {
+            string_concat_c_str(out, token.attribute.has_eol ? "eol" : "");
+        }
+
+        string_push(out, '\n');
+    } while (token.type != Token_EOF);
+}
+
+/// Scan the whole source on `threads` threads into text
+static void scan_to_text(const char* src, unsigned threads, String* out) {
+    scanner_init_str(src);
+    scanner_set_threads(threads);
+    scanner_to_text(out);
+    scanner_free();
+}
+
+static bool text_equals(String* a, String* b) {
+    return a->length == b->length && memcmp(string_data(a), string_data(b), a->length) == 0;
+}
+
+/// Replace `removed` bytes at `offset` of the text
+static void text_edit(String* text, size_t offset, size_t removed, const char* inserted) {
+    String edited;
+    string_init(&edited);
+
+    for (size_t i = 0; i < offset; i++) {
+        string_push(&edited, string_data(text)[i]);
+    }
+
+    string_concat_c_str(&edited, inserted);
+
+    for (size_t i = offset + removed; i < text->length; i++) {
+        string_push(&edited, string_data(text)[i]);
+    }
+
+    string_free(text);
+    *text = edited;
+}
+
+/// The parallel scan has to give the same tokens as the serial one
+static bool scan_parallel_equals(const char* src, unsigned threads) {
+    String serial, parallel;
+    string_init(&serial);
+    string_init(&parallel);
+
+    set_print_errors(false);
+    scan_to_text(src, 1, &serial);
+    scan_to_text(src, threads, &parallel);
+    set_print_errors(true);
+
+    bool equals = text_equals(&serial, &parallel);
+    string_free(&serial);
+    string_free(&parallel);
+    return equals;
+}
+
 int main() {
     atexit(summary);
     FILE* file = fopen("test/scanner.swift", "r+");
@@ -221,32 +324,32 @@ int main() {
     suite("Test Scanner identifier") {
         token = scanner_advance_non_whitespace();
         test(token.type == Token_Identifier);
-        test(strcmp(token.attribute.data.value.string.data, "SomeID") == 0);
+        test(strcmp(string_data(&token.attribute.data.value.string), "SomeID") == 0);
 
         token = scanner_advance_non_whitespace();
         test(token.type == Token_Identifier);
-        test(strcmp(token.attribute.data.value.string.data, "Other2") == 0);
+        test(strcmp(string_data(&token.attribute.data.value.string), "Other2") == 0);
 
         token = scanner_advance_non_whitespace();
         test(token.type == Token_Identifier);
-        test(strcmp(token.attribute.data.value.string.data, "_Should_be") == 0);
+        test(strcmp(string_data(&token.attribute.data.value.string), "_Should_be") == 0);
     }
 
     suite("Test Scanner string") {
         token = scanner_advance_non_whitespace();
         test(token.type == Token_Data);
         test(token.attribute.data.type == DataType_String);
-        test(strcmp(token.attribute.data.value.string.data, "Hello \n") == 0);
+        test(data_equals(token, "Hello \n"));
 
         token = scanner_advance_non_whitespace();
         test(token.type == Token_Data);
         test(token.attribute.data.type == DataType_String);
-        test(strcmp(token.attribute.data.value.string.data, "    No Indent Strip") == 0);
+        test(data_equals(token, "    No Indent Strip"));
 
         token = scanner_advance_non_whitespace();
         test(token.type == Token_Data);
         test(token.attribute.data.type == DataType_String);
-        test(strcmp(token.attribute.data.value.string.data, "Ident stripped") == 0);
+        test(data_equals(token, "Ident stripped"));
 
         token = scanner_advance_non_whitespace();
         test(got_error());
@@ -272,7 +375,7 @@ int main() {
 
         token = scanner_advance_non_whitespace();
         test(token.type == Token_Identifier);
-        test(strcmp(token.attribute.data.value.string.data, "a") == 0);
+        test(strcmp(string_data(&token.attribute.data.value.string), "a") == 0);
 
         token = scanner_advance_non_whitespace();
         test(token.type == Token_DoubleColon);
@@ -287,7 +390,7 @@ int main() {
         token = scanner_advance_non_whitespace();
         test(token.type == Token_Data);
         test(token.attribute.data.type == DataType_String);
-        test(strcmp(token.attribute.data.value.string.data, "Hello World!") == 0);
+        test(data_equals(token, "Hello World!"));
 
         token = scanner_advance_non_whitespace();
         test(token.type == Token_EOF);
@@ -298,4 +401,438 @@ int main() {
 
         scanner_free();
     }
+
+    suite("Test Scanner block comment at the end") {
+        scanner_init_str("a/**/");
+        token = scanner_advance_non_whitespace();
+        test(token.type == Token_Identifier);
+        token = scanner_advance_non_whitespace();
+        test(token.type == Token_EOF);
+        test(got_error() == Error_None);
+        scanner_free();
+
+        scanner_init_str("var a = 1\n/* c */");
+        while ((token = scanner_advance()).type != Token_EOF && !got_error()) {
+        }
+        test(token.type == Token_EOF);
+        test(got_error() == Error_None);
+        scanner_free();
+
+        /// Only the inner comment is closed
+        set_print_errors(false);
+        scanner_init_str("a /* /* c */");
+        while ((token = scanner_advance()).type != Token_EOF && !got_error()) {
+        }
+        test(got_error() == Error_Lexical);
+        set_error(Error_None);
+        set_print_errors(true);
+        scanner_free();
+    }
+
+    suite("Test Scanner string span") {
+        scanner_init_str("\"plain\" \"tab\\tend\" \"\" \"last\"");
+
+        /// Literals without escapes borrow the input
+        token = scanner_advance_non_whitespace();
+        test(data_equals(token, "plain"));
+        test(string_capacity(&token.attribute.data.value.string) == 0);
+        test(string_data(&token.attribute.data.value.string)[5] == '"');
+
+        token = scanner_advance_non_whitespace();
+        test(data_equals(token, "tab\tend"));
+        test(string_data(&token.attribute.data.value.string)[7] == '\0');
+
+        token = scanner_advance_non_whitespace();
+        test(data_equals(token, ""));
+
+        token = scanner_advance_non_whitespace();
+        test(data_equals(token, "last"));
+
+        String clone = string_clone(&token.attribute.data.value.string);
+        test(clone.length == 4 && strcmp(string_data(&clone), "last") == 0);
+        string_free(&clone);
+
+        scanner_reset_to_beginning();
+        token = scanner_advance_non_whitespace();
+        test(data_equals(token, "plain"));
+
+        scanner_free();
+    }
+
+    suite("Test Scanner string UTF-8") {
+        scanner_init_str("\"h\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80\" \"\\u{41}\\u{e9}\xc3\xa9 and a run longer than a block\" "
+                         "\"\xc3(\"");
+
+        token = scanner_advance_non_whitespace();
+        test(data_equals(token, "h\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80"));
+
+        token = scanner_advance_non_whitespace();
+        test(data_equals(token, "A\xc3\xa9\xc3\xa9 and a run longer than a block"));
+
+        scanner_advance_non_whitespace();
+        test(got_error());
+        set_error(Error_None);
+        scanner_free();
+
+        const char* invalid[] = {"\"\x80\"", "\"\xc0\xaf\"", "\"\xed\xa0\x80\"", "\"\xf4\x90\x80\x80\"", "\"\xe2\x82\""};
+
+        for (size_t i = 0; i < sizeof(invalid) / sizeof(*invalid); i++) {
+            scanner_init_str(invalid[i]);
+            scanner_advance_non_whitespace();
+            test(got_error() == Error_Lexical);
+            set_error(Error_None);
+            scanner_free();
+        }
+    }
+
+    suite("Test Scanner block string") {
+        scanner_init_str("\"\"\"\n  first\n    second \"quoted\"\n\n  \"\"third\\n\\u{41}\n \t\n  \"\"\" "
+                         "\"\"\"\n\"\"\" \"\"\"\n\tTab\n    Spaces\n\t\"\"\" \"\"\"\n    ok\n   bad\n    \"\"\"");
+
+        token = scanner_advance_non_whitespace();
+        test(data_equals(token, "first\n  second \"quoted\"\n\n\"\"third\nA\n"));
+
+        token = scanner_advance_non_whitespace();
+        test(data_equals(token, ""));
+
+        token = scanner_advance_non_whitespace();
+        test(data_equals(token, "Tab\nSpaces"));
+
+        /// Every line with a content needs the whole indentation of the closing delimiter
+        scanner_advance_non_whitespace();
+        test(got_error() == Error_Lexical);
+        set_error(Error_None);
+        scanner_free();
+    }
+
+    suite("Test Scanner number") {
+        scanner_init_str("9223372036854775807 1.05 12345678901.25e-3 1e309");
+
+        token = scanner_advance_non_whitespace();
+        test(token.type == Token_Data && token.attribute.data.type == DataType_Int);
+        test(token.attribute.data.value.number == INT64_MAX);
+
+        token = scanner_advance_non_whitespace();
+        test(token.type == Token_Data && token.attribute.data.type == DataType_Double);
+        test(token.attribute.data.value.number_double == 1.05);
+
+        token = scanner_advance_non_whitespace();
+        test(token.attribute.data.value.number_double == 12345678901.25e-3);
+
+        token = scanner_advance_non_whitespace();
+        test(got_error());
+
+        scanner_free();
+        set_error(Error_None);
+    }
+
+    suite("Test Scanner many tokens") {
+        /// Enough tokens to fill several chunks of the token list
+        const int count = 3000;
+        String src;
+        string_init(&src);
+
+        for (int i = 0; i < count; i++) {
+            string_concat_c_str(&src, "x \"str\" ");
+        }
+
+        scanner_init_str(string_data(&src));
+        bool all = true;
+
+        for (int i = 0; i < count * 2; i++) {
+            token = scanner_advance_non_whitespace();
+            all = all && token.type == (i % 2 ? Token_Data : Token_Identifier);
+        }
+
+        test(all);
+        test(scanner_advance_non_whitespace().type == Token_EOF);
+
+        scanner_reset_to_beginning();
+        all = true;
+
+        for (int i = 0; i < count * 2; i++) {
+            token = scanner_advance_non_whitespace();
+            const char* expected = i % 2 ? "str" : "x";
+            all = all && data_equals(token, expected);
+        }
+
+        test(all);
+        test(scanner_advance_non_whitespace().type == Token_EOF);
+
+        scanner_free();
+        string_free(&src);
+    }
+
+    suite("Test Scanner replay") {
+        const char* src = "let a = 10 // comment\n  /* block\n */ var b: Double? = 1.5e2\nwhile a >= 2 {\n\ta = a - \"x\"\n}";
+        Token live[64];
+        int count = 0;
+
+        scanner_init_str(src);
+
+        do {
+            live[count] = scanner_advance();
+        } while (live[count++].type != Token_EOF && count < 64);
+
+        scanner_reset_to_beginning();
+        bool same = true;
+
+        for (int i = 0; i < count; i++) {
+            token = scanner_advance();
+            same = same && token.type == live[i].type && token.offset == live[i].offset &&
+                   token.symbol == live[i].symbol;
+
+            if (token.type == Token_Data && token.attribute.data.type == DataType_String) {
+                String str = live[i].attribute.data.value.string;
+                same = same && token.attribute.data.value.string.length == str.length &&
+                       memcmp(string_data(&token.attribute.data.value.string), string_data(&str), str.length) == 0;
+            } else if (token.type == Token_Data && token.attribute.data.type == DataType_Double) {
+                same = same && token.attribute.data.value.number_double == live[i].attribute.data.value.number_double;
+            } else if (token.type == Token_Operator) {
+                same = same && token.attribute.op == live[i].attribute.op;
+            } else if (token.type == Token_DataType) {
+                same = same && token.attribute.data_type == live[i].attribute.data_type;
+            } else if (token.type == Token_Whitespace) {
+                same = same && token.attribute.has_eol == live[i].attribute.has_eol;
+            }
+        }
+
+        test(same);
+        test(live[count - 1].type == Token_EOF);
+        test(token_at(live[count - 1], 6, 1));
+        /// Whitespace after `let` ends in the column 4, the merged comments start on the first line
+        test(live[1].type == Token_Whitespace && token_at(live[1], 1, 4));
+        scanner_free();
+    }
+
+    suite("Test Scanner position") {
+        size_t line, column;
+
+        scanner_position(0, &line, &column);
+        test(line == 0 && column == 0);
+
+        scanner_init_str("a\n\nbc\n  d");
+        scanner_position(0, &line, &column);
+        test(line == 1 && column == 0);
+        scanner_position(2, &line, &column);
+        test(line == 2 && column == 0);
+        scanner_position(5, &line, &column);
+        test(line == 3 && column == 2);
+        scanner_position(8, &line, &column);
+        test(line == 4 && column == 2);
+        /// Offsets past the input are clamped to its end
+        scanner_position(100, &line, &column);
+        test(line == 4 && column == 3);
+        scanner_position(1, &line, &column);
+        test(line == 1 && column == 1);
+        scanner_free();
+    }
+
+    suite("Test Scanner streaming") {
+        const int count = 3000;
+        String src;
+        string_init(&src);
+
+        for (int i = 0; i < count; i++) {
+            string_concat_c_str(&src, i % 100 == 99 ? "x \"line\"\n" : "x \"str\" ");
+        }
+
+        scanner_init_str(string_data(&src));
+        scanner_set_streaming(true);
+        test(!got_error());
+
+        size_t last_offset = 0;
+
+        for (int pass = 0; pass < 2; pass++) {
+            bool all = true;
+
+            for (int i = 0; i < count * 2; i++) {
+                token = scanner_advance_non_whitespace();
+                const char* expected = i % 2 ? (i % 200 == 199 ? "line" : "str") : "x";
+                all = all && data_equals(token, expected);
+            }
+
+            test(all);
+            test(!pass || token.offset == last_offset);
+            last_offset = token.offset;
+            test(scanner_advance_non_whitespace().type == Token_EOF);
+            scanner_reset_to_beginning();
+        }
+
+        size_t line, column;
+        scanner_position(last_offset, &line, &column);
+        test(line == count / 100);
+
+        scanner_advance();
+        scanner_set_streaming(false);
+        test(got_error());
+        set_error(Error_None);
+
+        scanner_free();
+        string_free(&src);
+    }
+
+    suite("Test Scanner parallel") {
+        const char* lines[] = {
+            "let a = 10 // comment\n",
+            "var b: Double? = 1.5e2 + 0.1e-3\n",
+            "while a >= 2 {\n\ta = a - \"x\\n\" ?? \"\"\n}\n",
+            "func f(_ x: Int) -> String? { return nil }\n",
+            "\n\n   \n// only a comment\n",
+            "  /* a block comment */ if let a { write(a, \"\\u{41}\") }\n",
+        };
+        const char* multiline[] = {
+            "/* block\n comment /* nested\n */ */ let c = 1\n",
+            "let s = \"\"\"\n  block\n    string\n  \"\"\"\n",
+        };
+        String src;
+        string_init(&src);
+        unsigned seed = 1;
+
+        for (int i = 0; i < 400; i++) {
+            seed = seed * 1103515245 + 12345;
+            string_concat_c_str(&src, lines[(seed >> 16) % (sizeof(lines) / sizeof(*lines))]);
+        }
+
+        test(scan_parallel_equals(string_data(&src), 4));
+        test(scan_parallel_equals(string_data(&src), 7));
+        test(scan_parallel_equals("", 4));
+        test(scan_parallel_equals("\n\n\n\n", 4));
+        test(scan_parallel_equals("a\nb\nc\nd\ne", 16));
+
+        /// Parts starting inside of the multi-line tokens fail and the rest is scanned serially
+        for (int i = 0; i < 400; i++) {
+            seed = seed * 1103515245 + 12345;
+            string_concat_c_str(&src, multiline[(seed >> 16) % (sizeof(multiline) / sizeof(*multiline))]);
+        }
+
+        test(scan_parallel_equals(string_data(&src), 4));
+
+        /// Lexical errors stop both of the scans at the same token
+        string_concat_c_str(&src, "let bad = 1e\n");
+        string_concat_c_str(&src, lines[0]);
+        test(scan_parallel_equals(string_data(&src), 4));
+
+        string_clear(&src);
+        string_concat_c_str(&src, "let bad = \"unterminated\n");
+
+        for (int i = 0; i < 200; i++) {
+            string_concat_c_str(&src, lines[i % (sizeof(lines) / sizeof(*lines))]);
+        }
+
+        test(scan_parallel_equals(string_data(&src), 4));
+
+        scanner_init_str(string_data(&src));
+        scanner_advance();
+        scanner_set_threads(4);
+        test(got_error());
+        set_error(Error_None);
+        scanner_free();
+
+        string_free(&src);
+    }
+
+    suite("Test Scanner edit") {
+        const char* src = "let a = 1\nlet b = \"str\"\n";
+        String text, expected, edited;
+        string_init(&expected);
+        string_init(&edited);
+
+        scanner_init_str(src);
+
+        do {
+            token = scanner_advance();
+        } while (token.type != Token_EOF);
+
+        /// `a` and the whitespace before it are scanned again, `=` and everything after it are kept
+        TokenEdit edit = scanner_edit(4, 1, "abc");
+        test(!got_error());
+        test(edit.first == 1 && edit.removed == 2 && edit.inserted == 2);
+        scanner_to_text(&edited);
+        scanner_free();
+        scan_to_text("let abc = 1\nlet b = \"str\"\n", 1, &expected);
+        test(text_equals(&edited, &expected));
+
+        /// Tokens not scanned yet are scanned as they are requested
+        scanner_init_str(src);
+        scanner_advance();
+        edit = scanner_edit(18, 0, "/* comment */");
+        test(edit.first == 1 && edit.removed == 0 && edit.inserted == 0);
+        string_clear(&edited);
+        string_clear(&expected);
+        scanner_to_text(&edited);
+        scanner_free();
+        scan_to_text("let a = 1\nlet b = /* comment */\"str\"\n", 1, &expected);
+        test(text_equals(&edited, &expected));
+
+        scanner_init_str(src);
+        scanner_set_streaming(true);
+        scanner_edit(0, 0, "x");
+        test(got_error());
+        set_error(Error_None);
+        scanner_free();
+
+        const char* lines[] = {
+            "let a = 10 // comment\n", "var b: Double? = 1.5e2\n", "while a >= 2 {\n\ta = a - \"x\\n\"\n}\n",
+            "/* block\n comment */ let c = \"\"\"\n  block\n  \"\"\"\n", "\n   \n",
+        };
+        const char* inserts[] = {"x", "1", " ", "\n", "/*", "*/", "//", "\"", "\"\"\"", "= 2", "let", ""};
+        String texts[4];
+        String results[4];
+        unsigned seed = 7;
+        bool all = true;
+
+        set_print_errors(false);
+
+        for (int round = 0; round < 200; round++) {
+            string_init(&text);
+
+            for (int i = 0; i < 8; i++) {
+                seed = seed * 1103515245 + 12345;
+                string_concat_c_str(&text, lines[(seed >> 16) % (sizeof(lines) / sizeof(*lines))]);
+            }
+
+            scanner_init_str(string_data(&text));
+
+            /// Some edits are made before all of the tokens are scanned
+            for (int i = 0; i < round % 3 * 10; i++) {
+                scanner_advance();
+            }
+
+            set_error(Error_None);
+
+            for (int i = 0; i < 4; i++) {
+                seed = seed * 1103515245 + 12345;
+                size_t offset = (seed >> 8) % (text.length + 1);
+                size_t removed = (seed >> 4) % 4;
+                removed = removed > text.length - offset ? text.length - offset : removed;
+                const char* inserted = inserts[(seed >> 16) % (sizeof(inserts) / sizeof(*inserts))];
+
+                scanner_edit(offset, removed, inserted);
+                text_edit(&text, offset, removed, inserted);
+                string_init(&texts[i]);
+                string_init(&results[i]);
+                string_concat_c_str(&texts[i], string_data(&text));
+                scanner_to_text(&results[i]);
+            }
+
+            scanner_free();
+
+            for (int i = 0; i < 4; i++) {
+                string_clear(&expected);
+                scan_to_text(string_data(&texts[i]), 1, &expected);
+                all = all && text_equals(&results[i], &expected);
+                string_free(&texts[i]);
+                string_free(&results[i]);
+            }
+
+            string_free(&text);
+        }
+
+        set_print_errors(true);
+        test(all);
+
+        string_free(&expected);
+        string_free(&edited);
+    }
 }
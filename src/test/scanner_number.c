@@ -0,0 +1,102 @@
+/*
+ * @note Project: Implementace překladače imperativního jazyka IFJ23
+ * @file test/scanner_number.c
+ * @author agent, agent, VUT FIT
+ * @date 16/10/2026
+ * @brief Tester for scanner_number.h
+ */
+
+#include "../scanner_number.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "test.h"
+
+static bool parse_int(const char* str, int64_t expected) {
+    int64_t value = -1;
+    return number_parse_int(str, strlen(str), &value) && value == expected;
+}
+
+/// The conversion has to give the same bits as the correctly rounded `strtod`, values out of range are refused
+static bool parse_double(const char* str) {
+    double value = -1.0;
+    double expected = strtod(str, NULL);
+
+    if (isinf(expected)) {
+        return !number_parse_double(str, strlen(str), &value);
+    }
+
+    return number_parse_double(str, strlen(str), &value) && memcmp(&value, &expected, sizeof(double)) == 0;
+}
+
+int main() {
+    atexit(summary);
+
+    suite("Test number_skip_digits") {
+        const char* str = "1234567890123456789x";
+        test(number_skip_digits(str, 0, strlen(str)) == 19);
+        test(number_skip_digits(str, 19, strlen(str)) == 19);
+        test(number_skip_digits(str, 3, 10) == 10);
+        test(number_skip_digits("12.5", 0, 4) == 2);
+    }
+
+    suite("Test number_parse_int") {
+        int64_t value;
+
+        test(parse_int("0", 0));
+        test(parse_int("42", 42));
+        test(parse_int("000000000000000000000000007", 7));
+        test(parse_int("12345678", 12345678));
+        test(parse_int("2147483648", 2147483648));
+        test(parse_int("9223372036854775807", INT64_MAX));
+        test(!number_parse_int("9223372036854775808", 19, &value));
+        test(!number_parse_int("18446744073709551616", 20, &value));
+        /// The length limits the literal, the input goes on after it
+        test(number_parse_int("12345;", 3, &value) && value == 123);
+    }
+
+    suite("Test number_parse_double") {
+        double value;
+
+        test(parse_double("0.0"));
+        test(parse_double("3.14"));
+        test(parse_double("1.05"));
+        test(parse_double("39.1"));
+        test(parse_double("0.000123"));
+        test(parse_double("7e8"));
+        test(parse_double("8.0e-5"));
+        test(parse_double("3.14E+2"));
+        test(parse_double("0.1e-0"));
+        test(parse_double("123e25"));
+        test(parse_double("9007199254740993.0"));
+        test(parse_double("1.7976931348623157e308"));
+        test(parse_double("4.9e-324"));
+        test(parse_double("2.4703282292062327e-324"));
+        test(parse_double("1e-400"));
+        test(parse_double("123456789012345678901234567890.5"));
+        test(parse_double("0.30000000000000000000000000000000001"));
+        test(!number_parse_double("1e309", 5, &value));
+        test(!number_parse_double("1e99999999999", 13, &value));
+        test(number_parse_double("2.5e3;", 5, &value) && value == 2.5e3);
+    }
+
+    suite("Test number_parse_double rounding") {
+        char str[64];
+        unsigned long long seed = 42;
+        bool all = true;
+
+        for (int i = 0; i < 100000; i++) {
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+            /// Short and long mantissas, exponents inside and outside of the exact powers of ten
+            unsigned long long whole = (seed >> 8) >> (seed & 63);
+            unsigned long long fraction = (seed >> 20) >> ((seed >> 6) & 63);
+            int exponent = i % 2 ? (int)((seed >> 40) % 700) - 350 : (int)((seed >> 40) % 60) - 30;
+
+            snprintf(str, sizeof(str), "%llu.%llue%d", whole, fraction, exponent);
+            all = all && parse_double(str);
+        }
+
+        test(all);
+    }
+}
@@ -0,0 +1,155 @@
+/*
+ * @note Project: Implementace překladače imperativního jazyka IFJ23
+ * @file test/scanner_skip.c
+ * @author agent, agent, VUT FIT
+ * @date 16/10/2026
+ * @brief Tester for scanner_skip.h
+ */
+
+#include "../scanner_skip.h"
+#include <stdbool.h>
+#include <string.h>
+#include "test.h"
+
+typedef struct {
+    size_t end;
+    size_t newlines;
+    size_t last_newline;
+} SkipResult;
+
+static SkipResult skip(const char* data, size_t position, size_t length, SkipKind kind) {
+    SkipResult result = {0};
+    result.end = scanner_skip(data, position, length, kind, &result.newlines, &result.last_newline);
+
+    if (!result.newlines) {
+        result.last_newline = 0;
+    }
+
+    return result;
+}
+
+static bool same_result(SkipResult a, SkipResult b) {
+    return a.end == b.end && a.newlines == b.newlines && a.last_newline == b.last_newline;
+}
+
+int main() {
+    atexit(summary);
+
+    SkipImpl best = scanner_skip_select(SkipImpl_AVX2);
+    SkipResult result;
+
+    suite("Test Skip whitespace") {
+        const char* str = "  \t\n \r\n  x  ";
+        result = skip(str, 0, strlen(str), Skip_Whitespace);
+        test(result.end == 9);
+        test(result.newlines == 2);
+        test(result.last_newline == 6);
+
+        result = skip(str, 9, strlen(str), Skip_Whitespace);
+        test(result.end == 9);
+        test(result.newlines == 0);
+
+        result = skip(str, 10, strlen(str), Skip_Whitespace);
+        test(result.end == strlen(str));
+    }
+
+    suite("Test Skip line comment") {
+        const char* str = "// some comment that is longer than a single block of 32 bytes\nlet";
+        result = skip(str, 2, strlen(str), Skip_LineComment);
+        test(result.end == (size_t)(strchr(str, '\n') - str));
+        test(result.newlines == 0);
+    }
+
+    suite("Test Skip block comment") {
+        const char* str = "/* first line\n   second line\n   third line of a comment */";
+        result = skip(str, 2, strlen(str), Skip_BlockComment);
+        test(result.end == (size_t)(strchr(str + 2, '*') - str));
+        test(result.newlines == 2);
+        test(result.last_newline == (size_t)(strrchr(str, '\n') - str));
+    }
+
+    suite("Test Skip string") {
+        const char* str = "plain text that is longer than a block of 32 bytes\\n";
+        test(scanner_skip_string(str, 0, strlen(str), true) == (size_t)(strchr(str, '\\') - str));
+
+        str = "a \"quote\" in a block string, again longer than a block\n";
+        test(scanner_skip_string(str, 0, strlen(str), true) == 2);
+        test(scanner_skip_string(str, 0, strlen(str), false) == strlen(str) - 1);
+
+        /// Valid sequences are skipped, the run stops at the first byte of an invalid or a cut one
+        str = "h\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80 and some more ASCII text \xc3(";
+        test(scanner_skip_string(str, 0, strlen(str), true) == strlen(str) - 2);
+        test(scanner_skip_string(str, 0, 2, true) == 1);
+        test(scanner_skip_string("\xed\xa0\x80", 0, 3, true) == 0);
+        test(scanner_skip_string("\xe0\x80\xaf", 0, 3, true) == 0);
+        test(scanner_skip_string("\xf4\x90\x80\x80", 0, 4, true) == 0);
+        test(scanner_skip_string("\t", 0, 1, false) == 0);
+    }
+
+    suite("Test Skip implementations agree") {
+        static const char alphabet[] = " \t\n\r\v\f\0a*/\"\x80";
+        char data[300];
+        unsigned seed = 42;
+        bool agree = true;
+
+        for (int round = 0; round < 2000 && agree; round++) {
+            size_t length = round % (sizeof(data) - 1);
+
+            for (size_t i = 0; i < length; i++) {
+                seed = seed * 1103515245 + 12345;
+                /// Mostly run bytes, so the runs get long enough for the vector kernels
+                data[i] = (seed >> 16) % 8 ? alphabet[(seed >> 8) % 7] : alphabet[(seed >> 8) % 12];
+            }
+
+            for (SkipKind kind = Skip_Whitespace; kind <= Skip_BlockComment; kind++) {
+                for (size_t position = 0; position <= length; position += 7) {
+                    scanner_skip_select(SkipImpl_Scalar);
+                    SkipResult expected = skip(data, position, length, kind);
+
+                    for (SkipImpl impl = SkipImpl_SSE2; impl <= best; impl++) {
+                        scanner_skip_select(impl);
+                        agree = agree && same_result(expected, skip(data, position, length, kind));
+                    }
+                }
+            }
+        }
+
+        test(agree);
+    }
+    suite("Test Skip string implementations agree") {
+        /// Mostly valid text, the rest are the bytes that stop the run or break a UTF-8 sequence
+        static const char* pieces[] = {"a", " ", "text", "\xc3\xa9", "\xe2\x82\xac", "\xf0\x9f\x98\x80",
+                                       "\"", "\\", "\n", "\x80", "\xc3", "\xed\xa0\x80", "\xf4\x90"};
+        char data[300];
+        unsigned seed = 7;
+        bool agree = true;
+
+        for (int round = 0; round < 2000 && agree; round++) {
+            size_t length = 0;
+            size_t wanted = round % (sizeof(data) - 4);
+
+            while (length < wanted) {
+                seed = seed * 1103515245 + 12345;
+                const char* piece = (seed >> 16) % 16 ? pieces[(seed >> 8) % 6] : pieces[(seed >> 8) % 13];
+                size_t size = strlen(piece);
+
+                memcpy(data + length, piece, size);
+                length += size;
+            }
+
+            for (size_t position = 0; position <= length; position += 5) {
+                for (int is_line_string = 0; is_line_string < 2; is_line_string++) {
+                    scanner_skip_select(SkipImpl_Scalar);
+                    size_t expected = scanner_skip_string(data, position, length, is_line_string);
+
+                    for (SkipImpl impl = SkipImpl_SSE2; impl <= best; impl++) {
+                        scanner_skip_select(impl);
+                        agree = agree && expected == scanner_skip_string(data, position, length, is_line_string);
+                    }
+                }
+            }
+        }
+
+        test(agree);
+    }
+}
@@ -10,6 +10,49 @@
 #include <string.h>
 #include "test.h"
 
+/// Reallocations done while a string was growing and the bytes they had to move
+typedef struct {
+    size_t reallocations;
+    size_t copied;
+} Growth;
+
+static void track_growth(const String* str, size_t* capacity, Growth* growth) {
+    if (string_capacity(str) != *capacity) {
+        growth->reallocations++;
+        growth->copied += str->length;
+        *capacity = string_capacity(str);
+    }
+}
+
+/// Build a long literal by single pushes, growing by exactly one byte would move about n^2 / 2 bytes
+static Growth grow_by_push(String* str, size_t count) {
+    Growth growth = {0, 0};
+    size_t capacity = string_capacity(str);
+
+    for (size_t i = 0; i < count; i++) {
+        string_push(str, 'a' + i % 26);
+        track_growth(str, &capacity, &growth);
+    }
+
+    return growth;
+}
+
+/// Build a generated instruction stream the same way as the code generator
+static Growth grow_by_instructions(String* str, size_t count) {
+    Growth growth = {0, 0};
+    size_t capacity = string_capacity(str);
+    char line[64];
+
+    for (size_t i = 0; i < count; i++) {
+        snprintf(line, sizeof(line), "MOVE LF@tmp%zu int@%zu", i, i * 7);
+        string_concat_c_str(str, line);
+        string_push(str, '\n');
+        track_growth(str, &capacity, &growth);
+    }
+
+    return growth;
+}
+
 int main() {
     atexit(summary);
 
@@ -18,8 +61,8 @@ int main() {
     suite("Test string_init") {
         string_init(&str);
         test(!str.length);
-        test(!str.capacity);
-        test(!str.data);
+        test(!string_capacity(&str));
+        test(!string_data(&str));
     }
 
     suite("Test string_len") {
@@ -34,102 +77,199 @@ int main() {
     suite("Test string_clear") {
         string_clear(&str);
         test(!str.length);
-        test(str.capacity);
-        test(str.data);
+        test(string_capacity(&str));
+        test(string_data(&str));
 
         String empty;
         string_init(&empty);
         string_clear(&empty);
         test(!empty.length);
-        test(!empty.capacity);
-        test(!empty.data);
+        test(!string_capacity(&empty));
+        test(!string_data(&empty));
     }
 
     suite("Test string_concat_c_str") {
-        test(!strcmp(str.data, ""));
+        test(!strcmp(string_data(&str), ""));
         string_concat_c_str(&str, "h");
-        test(!strcmp(str.data, "h"));
+        test(!strcmp(string_data(&str), "h"));
         string_concat_c_str(&str, "");
-        test(!strcmp(str.data, "h"));
+        test(!strcmp(string_data(&str), "h"));
         string_concat_c_str(&str, "23|");
-        test(!strcmp(str.data, "h23|"));
+        test(!strcmp(string_data(&str), "h23|"));
     }
 
     suite("Test string_reserve") {
-        test(str.capacity == 5 && str.length == 4);
+        test(string_capacity(&str) == STRING_SMALL_CAPACITY && str.length == 4);
         string_reserve(&str, 4);
         /// nothing happens if reserve less than the current reserved in string
-        test(str.capacity == 5);
+        test(string_capacity(&str) == STRING_SMALL_CAPACITY);
 
-        string_reserve(&str, 10);
-        test(str.capacity == 10);
+        string_reserve(&str, 30);
+        test(string_capacity(&str) == 30);
         // Should not affect the inner data
         test(str.length == 4);
+        test(!strcmp(string_data(&str), "h23|"));
     }
 
     suite("Test string_push") {
-        test(!strcmp(str.data, "h23|"));
+        test(!strcmp(string_data(&str), "h23|"));
 
         string_push(&str, '_');
-        test(!strcmp(str.data, "h23|_"));
+        test(!strcmp(string_data(&str), "h23|_"));
 
         string_push(&str, '_');
         string_push(&str, '%');
-        test(!strcmp(str.data, "h23|__%"));
+        test(!strcmp(string_data(&str), "h23|__%"));
     }
 
     suite("Test string_from_c_str") {
         String str2 = string_from_c_str("Hello world");
 
         test(str2.length == 11);
-        test(str2.capacity == 12);
-        test(!strcmp(str2.data, "Hello world"));
+        test(string_capacity(&str2) == STRING_SMALL_CAPACITY);
+        test(!strcmp(string_data(&str2), "Hello world"));
+        string_free(&str2);
+
+        str2 = string_from_c_str("Hello world, this does not fit");
+        test(str2.length == 30);
+        test(string_capacity(&str2) == 31);
+        test(!strcmp(string_data(&str2), "Hello world, this does not fit"));
         string_free(&str2);
     }
 
     suite("Test string_from_format") {
-        String str2 = string_from_format("%i Hello %s", 123, "World");
-        const char* expected_res = "123 Hello World";
+        String str2 = string_from_format("%i Hello %s", 123, "World of strings");
+        const char* expected_res = "123 Hello World of strings";
+
+        test(str2.length == strlen(expected_res));
+        test(string_capacity(&str2) == strlen(expected_res) + 1);
+        test(!strcmp(string_data(&str2), expected_res));
+        string_free(&str2);
+    }
+
+    suite("Test string_append_fmt") {
+        String str2;
+        string_init(&str2);
 
+        /// Short output is formatted inline
+        string_append_fmt(&str2, "DEFVAR TF@%s", "tmp1");
+        test(!strcmp(string_data(&str2), "DEFVAR TF@tmp1"));
+        test(string_capacity(&str2) == STRING_SMALL_CAPACITY);
+
+        /// Output that does not fit into the spare capacity is formatted again
+        string_append_fmt(&str2, " %s@%s %i", "LF", "a_rather_long_variable_name%0", -42);
+        const char* expected_res = "DEFVAR TF@tmp1 LF@a_rather_long_variable_name%0 -42";
+        test(str2.length == strlen(expected_res));
+        test(!strcmp(string_data(&str2), expected_res));
+        test(string_capacity(&str2) > str2.length);
+
+        string_append_fmt(&str2, "%s", "");
         test(str2.length == strlen(expected_res));
-        test(str2.capacity == strlen(expected_res) + 1);
-        test(!strcmp(str2.data, expected_res));
         string_free(&str2);
+
+        /// The borrowed data are copied before appending
+        const char* source = "MOVE GF@x";
+        String borrowed = string_borrow(source, 7);
+        string_append_fmt(&borrowed, "LF@%d", 7);
+        test(!strcmp(string_data(&borrowed), "MOVE GFLF@7"));
+        test(!strcmp(source, "MOVE GF@x"));
+        string_free(&borrowed);
     }
 
     suite("Test string_take") {
         String str2 = string_take(&str);
 
         test(!str.length);
-        test(!str.capacity);
-        test(!str.data);
+        test(!string_capacity(&str));
+        test(!string_data(&str));
         test(str2.length == 7);
-        test(str2.capacity == 10);
-        test(!strcmp(str2.data, "h23|__%"));
+        test(string_capacity(&str2) == 30);
+        test(!strcmp(string_data(&str2), "h23|__%"));
 
         // Take back the data
         str = string_take(&str2);
         test(!str2.length);
-        test(!str2.capacity);
-        test(!str2.data);
+        test(!string_capacity(&str2));
+        test(!string_data(&str2));
         test(str.length == 7);
-        test(str.capacity == 10);
-        test(!strcmp(str.data, "h23|__%"));
+        test(string_capacity(&str) == 30);
+        test(!strcmp(string_data(&str), "h23|__%"));
     }
 
     suite("Test string_clone") {
         String cloned = string_clone(&str);
 
-        // the str capacity is 10 but only need 8 in the new one
-        test(cloned.capacity != str.capacity);
+        // the str capacity is 30 but the short clone does not allocate
+        test(string_capacity(&cloned) == STRING_SMALL_CAPACITY);
         // the cloned data address must not be the same as the original data address
-        test(cloned.data != str.data);
+        test(string_data(&cloned) != string_data(&str));
         test(cloned.length == str.length);
-        test(cloned.capacity == cloned.length + 1);
+        test(!strcmp(string_data(&cloned), "h23|__%"));
+
+        string_free(&cloned);
+
+        String long_str = string_from_c_str("a string too long to be stored inline");
+        cloned = string_clone(&long_str);
+        test(string_capacity(&cloned) == cloned.length + 1);
+        test(!strcmp(string_data(&cloned), string_data(&long_str)));
 
+        string_free(&long_str);
         string_free(&cloned);
     }
 
+    suite("Test string small") {
+        String small;
+        string_init(&small);
+
+        for (int i = 0; i < STRING_SMALL_CAPACITY - 1; i++) {
+            string_push(&small, 'a' + i);
+        }
+
+        /// The data are stored inside of the struct itself
+        test(small.length == STRING_SMALL_CAPACITY - 1);
+        test(string_data(&small) >= (char*)&small && string_data(&small) < (char*)(&small + 1));
+        test(!strcmp(string_data(&small), "abcdefghijklmnopqrstuv"));
+
+        /// Moving the struct moves the data
+        String moved = string_take(&small);
+        test(!string_data(&small));
+        test(string_data(&moved) >= (char*)&moved && string_data(&moved) < (char*)(&moved + 1));
+        test(!strcmp(string_data(&moved), "abcdefghijklmnopqrstuv"));
+
+        /// One more character does not fit anymore
+        string_push(&moved, 'w');
+        test(string_data(&moved) < (char*)&moved || string_data(&moved) >= (char*)(&moved + 1));
+        test(string_capacity(&moved) > STRING_SMALL_CAPACITY);
+        test(!strcmp(string_data(&moved), "abcdefghijklmnopqrstuvw"));
+
+        string_clear(&moved);
+        string_concat_c_str(&moved, "xy");
+        test(!strcmp(string_data(&moved), "xy"));
+        string_free(&moved);
+        test(!string_data(&moved) && !string_capacity(&moved));
+    }
+
+    suite("Test string_borrow") {
+        const char* source = "borrowed data";
+        String borrowed = string_borrow(source, 8);
+
+        test(borrowed.length == 8);
+        test(!string_capacity(&borrowed));
+        test(string_data(&borrowed) == source);
+
+        /// Modifying copies the data, the source is never written
+        string_push(&borrowed, '!');
+        test(string_data(&borrowed) != source);
+        test(!strcmp(string_data(&borrowed), "borrowed!"));
+        test(!strcmp(source, "borrowed data"));
+        string_free(&borrowed);
+
+        /// Freeing a borrowing string does not free the data
+        borrowed = string_borrow(source, strlen(source));
+        string_free(&borrowed);
+        test(!borrowed.length && !string_data(&borrowed));
+    }
+
     suite("Test string_remove_ident") {
         char* input = "\tHello\n     World\n \tOnce\n\t Again";
         char* expected = "Hello\n World\nOnce\n Again";
@@ -139,18 +279,95 @@ int main() {
 
         string_remove_ident(&str, 5);
         test(got_error());
-        test(!strcmp(str.data, input));
+        test(!strcmp(string_data(&str), input));
         set_error(Error_None);
 
         string_remove_ident(&str, 4);
-        test(!strcmp(str.data, expected));
+        test(!strcmp(string_data(&str), expected));
+    }
+
+    suite("Test string_append_n") {
+        String appended;
+        string_init(&appended);
+
+        string_append_n(&appended, "abcdef", 3);
+        test(appended.length == 3 && !strcmp(string_data(&appended), "abc"));
+        string_append_n(&appended, NULL, 0);
+        test(appended.length == 3);
+        string_append_n(&appended, "defghijklmnopqrstuvwxyz", 23);
+        test(appended.length == 26 && !strcmp(string_data(&appended), "abcdefghijklmnopqrstuvwxyz"));
+        string_free(&appended);
+
+        /// Appending to a borrowed string copies it first
+        const char* source = "borrowed";
+        appended = string_borrow(source, 6);
+        string_append_n(&appended, "ing", 3);
+        test(!strcmp(string_data(&appended), "borrowing"));
+        test(!strcmp(source, "borrowed"));
+        string_free(&appended);
+    }
+
+    suite("Test string growth is amortised") {
+        const size_t count = 1 << 20;
+        String grown;
+        string_init(&grown);
+
+        Growth growth = grow_by_push(&grown, count);
+        test(grown.length == count);
+        test(string_data(&grown)[count - 1] == (char)('a' + (count - 1) % 26));
+        /// Geometric growth moves less than `factor / (factor - 1)` times the final length
+        test(growth.reallocations <= 32);
+        test(growth.copied <= 3 * count);
+        test(string_capacity(&grown) <= STRING_GROWTH_FACTOR * (count + 1));
+        string_free(&grown);
+
+        growth = grow_by_instructions(&grown, count / 8);
+        test(grown.length > count);
+        test(!strncmp(string_data(&grown), "MOVE LF@tmp0 int@0\nMOVE LF@tmp1 int@7\n", 38));
+        test(growth.reallocations <= 32);
+        test(growth.copied <= 3 * grown.length);
+        string_free(&grown);
+    }
+
+    suite("Test StrView") {
+        String owner = string_from_c_str("tmp%12 and more");
+        StrView view = string_view(&owner);
+        StrView prefix = {.data = string_data(&owner), .length = 3};
+
+        test(view.length == owner.length && view.data == string_data(&owner));
+        test(strview_equals(prefix, strview_from_c_str("tmp")));
+        test(strview_equals_c_str(prefix, "tmp"));
+        test(!strview_equals_c_str(prefix, "tm"));
+        test(!strview_equals_c_str(prefix, "tmp%"));
+        test(strview_equals(strview_from_c_str(NULL), strview_from_c_str("")));
+        test(!strview_from_c_str(NULL).data && !strview_from_c_str(NULL).length);
+
+        test(strview_compare(prefix, view) < 0);
+        test(strview_compare(view, prefix) > 0);
+        test(strview_compare(prefix, strview_from_c_str("tmp")) == 0);
+        test(strview_compare(prefix, strview_from_c_str("tmq")) < 0);
+        test(strview_hash(prefix) == strview_hash(strview_from_c_str("tmp")));
+        test(strview_hash(prefix) != strview_hash(view));
+
+        char printed[16];
+        snprintf(printed, sizeof(printed), "[" STRVIEW_FMT "]", STRVIEW_ARG(prefix));
+        test(!strcmp(printed, "[tmp]"));
+
+        String appended;
+        string_init(&appended);
+        string_append_view(&appended, prefix);
+        string_append_view(&appended, strview_from_c_str(NULL));
+        test(!strcmp(string_data(&appended), "tmp"));
+
+        string_free(&appended);
+        string_free(&owner);
     }
 
     suite("Test string_free") {
         string_free(&str);
         test(!str.length);
-        test(!str.capacity);
-        test(!str.data);
+        test(!string_capacity(&str));
+        test(!string_data(&str));
     }
 
     return 0;
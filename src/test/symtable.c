@@ -36,8 +36,8 @@ int main() {
         FunctionSymbol foo2;
         function_symbol_init(&foo2);
         foo2.return_value_type = DataType_Double;
-        function_symbol_emplace_param(&foo2, DataType_Double, NULL, "p1");
-        function_symbol_emplace_param(&foo2, DataType_Int, "abc", "p2");
+        function_symbol_emplace_param(&foo2, DataType_Double, strview_from_c_str(NULL), strview_from_c_str("p1"));
+        function_symbol_emplace_param(&foo2, DataType_Int, strview_from_c_str("abc"), strview_from_c_str("p2"));
         test(!symtable_insert_function(&symtable, "foo", foo2));
         test(symtable_insert_function(&symtable, "foo2", foo2));
     }
@@ -76,11 +76,11 @@ int main() {
         test(func2->return_value_type == DataType_Double);
         test(func2->param_count == 2);
         test(func2->params[0].type == DataType_Double);
-        test(func2->params[0].oname.data == NULL);
-        test(strcmp(func2->params[0].iname.data, "p1") == 0);
+        test(string_data(&func2->params[0].oname) == NULL);
+        test(strcmp(string_data(&func2->params[0].iname), "p1") == 0);
         test(func2->params[1].type == DataType_Int);
-        test(strcmp(func2->params[1].oname.data, "abc") == 0);
-        test(strcmp(func2->params[1].iname.data, "p2") == 0);
+        test(strcmp(string_data(&func2->params[1].oname), "abc") == 0);
+        test(strcmp(string_data(&func2->params[1].iname), "p2") == 0);
     }
 
     suite("Test symtable_get_variable") {
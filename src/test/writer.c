@@ -0,0 +1,98 @@
+/**
+ * @note Project: Implementace překladače imperativního jazyka IFJ23
+ * @file test/writer.c
+ * @author agent, agent, VUT FIT
+ * @date 16/10/2026
+ * @brief Tester for writer.h
+ */
+
+#include "../writer.h"
+#include <stdbool.h>
+#include <string.h>
+#include "../error.h"
+#include "test.h"
+
+/// Read the whole temporary file back
+static size_t read_back(FILE* file, char* data, size_t capacity) {
+    rewind(file);
+    size_t length = fread(data, 1, capacity, file);
+    rewind(file);
+    return length;
+}
+
+int main() {
+    atexit(summary);
+
+    FILE* file = tmpfile();
+    Writer writer;
+    writer_init(&writer, fileno(file));
+
+    suite("Test writer_init") {
+        test(!writer.chunk && !writer.length);
+        test(!writer.chunks[0]);
+    }
+
+    suite("Test writer_write") {
+        char data[64];
+
+        writer_write(&writer, "LABEL func%main", 15);
+        writer_putc(&writer, '\n');
+        test(writer.length == 16);
+        /// Nothing is written before the flush
+        test(read_back(file, data, sizeof(data)) == 0);
+
+        test(writer_flush(&writer));
+        test(!writer.chunk && !writer.length);
+        test(read_back(file, data, sizeof(data)) == 16);
+        test(!memcmp(data, "LABEL func%main\n", 16));
+    }
+
+    suite("Test writer over many chunks") {
+        /// More than all chunks together, so the chunks are written and reused before the flush
+        size_t total = WRITER_CHUNK_SIZE * WRITER_CHUNK_COUNT * 2 + 12345;
+        char* expected = malloc(total);
+        char* data = malloc(total + 1);
+
+        for (size_t i = 0; i < total; i++) {
+            expected[i] = 'a' + i % 26;
+        }
+
+        FILE* big = tmpfile();
+        writer_free(&writer);
+        writer_init(&writer, fileno(big));
+
+        writer_write(&writer, expected, 1000);
+        for (size_t i = 1000; i < total; i++) {
+            writer_putc(&writer, expected[i]);
+        }
+        test(!got_error());
+        test(writer_flush(&writer));
+
+        test(read_back(big, data, total + 1) == total);
+        test(!memcmp(data, expected, total));
+
+        fclose(big);
+
+        free(expected);
+        free(data);
+    }
+
+    suite("Test writer error") {
+        Writer closed;
+        writer_init(&closed, -1);
+        set_print_errors(false);
+        writer_write(&closed, "EXIT int@0", 10);
+        test(!writer_flush(&closed));
+        test(got_error());
+        set_error(Error_None);
+        writer_free(&closed);
+    }
+
+    suite("Test writer_free") {
+        writer_free(&writer);
+        test(!writer.chunks[0] && !writer.chunk && !writer.length);
+    }
+
+    fclose(file);
+    return 0;
+}
@@ -41,7 +41,7 @@ const char* token_to_string(const Token* tok) {
         case Token_Operator:
             return operator_to_string(tok->attribute.op);
         case Token_Identifier:
-            return tok->attribute.data.value.string.data;
+            return string_data(&tok->attribute.data.value.string);
         default:
             return tokentype_to_string(tok->type);
     }
@@ -54,7 +54,7 @@ String unsigned_to_string(unsigned num) {
     string_init(&str);
     string_reserve(&str, num_digits + 1);
     str.length = num_digits;
-    str.data[num_digits] = '\0';
-    sprintf(str.data, "%i", num);
+    string_data(&str)[num_digits] = '\0';
+    sprintf(string_data(&str), "%i", num);
     return str;
 }
@@ -0,0 +1,127 @@
+/**
+ * @note Project: Implementace překladače imperativního jazyka IFJ23
+ * @file writer.c
+ * @author agent, agent, VUT FIT
+ * @date 16/10/2026
+ * @brief Implementation for the writer.h
+ */
+
+#include "writer.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/uio.h>
+#include "error.h"
+
+void writer_init(Writer* writer, int fd) {
+    memset(writer, 0, sizeof(Writer));
+    writer->fd = fd;
+}
+
+/// Write all chunks up to the one being filled, a short write continues where it stopped
+static bool writer_write_chunks(Writer* writer) {
+    struct iovec iov[WRITER_CHUNK_COUNT];
+    int count = 0;
+
+    for (size_t i = 0; i <= writer->chunk && i < WRITER_CHUNK_COUNT; i++) {
+        size_t length = i == writer->chunk ? writer->length : WRITER_CHUNK_SIZE;
+
+        if (length) {
+            iov[count++] = (struct iovec){.iov_base = writer->chunks[i], .iov_len = length};
+        }
+    }
+
+    struct iovec* next = iov;
+
+    while (count) {
+        ssize_t written = writev(writer->fd, next, count);
+
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            set_error(Error_Internal);
+            eprint("writer: Cannot write the output\n");
+            return false;
+        }
+
+        while (count && (size_t)written >= next->iov_len) {
+            written -= next->iov_len;
+            next++;
+            count--;
+        }
+
+        if (count) {
+            next->iov_base = (char*)next->iov_base + written;
+            next->iov_len -= written;
+        }
+    }
+
+    writer->chunk = 0;
+    writer->length = 0;
+    return true;
+}
+
+/// Make room in the chunk being filled, all chunks are written out when they are full
+static bool writer_reserve(Writer* writer) {
+    if (writer->length == WRITER_CHUNK_SIZE) {
+        if (writer->chunk + 1 == WRITER_CHUNK_COUNT) {
+            if (!writer_write_chunks(writer)) {
+                return false;
+            }
+        } else {
+            writer->chunk++;
+            writer->length = 0;
+        }
+    }
+
+    if (!writer->chunks[writer->chunk]) {
+        writer->chunks[writer->chunk] = malloc(WRITER_CHUNK_SIZE);
+
+        if (!writer->chunks[writer->chunk]) {
+            set_error(Error_Internal);
+            eprint("writer: Out Of Memory\n");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void writer_write(Writer* writer, const char* data, size_t length) {
+    while (length) {
+        if (!writer_reserve(writer)) {
+            return;
+        }
+
+        size_t part = WRITER_CHUNK_SIZE - writer->length;
+        part = part < length ? part : length;
+
+        memcpy(writer->chunks[writer->chunk] + writer->length, data, part);
+        writer->length += part;
+        data += part;
+        length -= part;
+    }
+}
+
+void writer_putc(Writer* writer, char ch) {
+    if (writer->length < WRITER_CHUNK_SIZE && writer->chunks[writer->chunk]) {
+        writer->chunks[writer->chunk][writer->length++] = ch;
+        return;
+    }
+
+    writer_write(writer, &ch, 1);
+}
+
+bool writer_flush(Writer* writer) {
+    return writer_write_chunks(writer);
+}
+
+void writer_free(Writer* writer) {
+    for (size_t i = 0; i < WRITER_CHUNK_COUNT; i++) {
+        free(writer->chunks[i]);
+    }
+
+    writer_init(writer, writer->fd);
+}
@@ -0,0 +1,76 @@
+/**
+ * @note Project: Implementace překladače imperativního jazyka IFJ23
+ * @file writer.h
+ * @author agent, agent, VUT FIT
+ * @date 16/10/2026
+ * @brief Buffered writer of the output file.
+ *
+ * The output is collected in a few big chunks that are written by a single `writev` when all of them are full,
+ * so the code is written by a handful of system calls no matter how many instructions it has.
+ */
+
+#ifndef WRITER_H
+#define WRITER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/// Size of one chunk of the writer
+#define WRITER_CHUNK_SIZE ((size_t)64 * 1024)
+
+/// Number of chunks written at once
+#define WRITER_CHUNK_COUNT 16
+
+/**
+ * @struct Writer
+ * @brief Output file descriptor with its chunks, the chunks are allocated on the first write and then reused.
+ */
+typedef struct {
+    int fd;                            ///< File descriptor of the output
+    char* chunks[WRITER_CHUNK_COUNT];  ///< Memory of the chunks
+    size_t chunk;                      ///< Index of the chunk being filled
+    size_t length;                     ///< Number of used bytes of the chunk being filled
+} Writer;
+
+/**
+ * @brief Initialize the writer, no memory is allocated yet.
+ * @param[out] writer Writer to initialize.
+ * @param[in] fd File descriptor to write to, e.g. `STDOUT_FILENO`.
+ */
+void writer_init(Writer* writer, int fd);
+
+/**
+ * @brief Append `length` bytes to the output.
+ *
+ * Full chunks are written out, sets `Error_Internal` if out of memory or if the output cannot be written.
+ *
+ * @param[in,out] writer Writer to append to.
+ * @param[in] data Bytes to append.
+ * @param[in] length Number of bytes to append.
+ */
+void writer_write(Writer* writer, const char* data, size_t length);
+
+/**
+ * @brief Append one byte to the output.
+ * @param[in,out] writer Writer to append to.
+ * @param[in] ch The byte to append.
+ */
+void writer_putc(Writer* writer, char ch);
+
+/**
+ * @brief Write all appended bytes to the output.
+ *
+ * Sets `Error_Internal` if the output cannot be written.
+ *
+ * @param[in,out] writer Writer to flush.
+ * @return `true` on success.
+ */
+bool writer_flush(Writer* writer);
+
+/**
+ * @brief Free the chunks of the writer, the bytes not flushed yet are dropped.
+ * @param[in,out] writer Writer to free.
+ */
+void writer_free(Writer* writer);
+
+#endif